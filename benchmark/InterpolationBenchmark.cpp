@@ -0,0 +1,123 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <math.h>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include "global/Constants.h"
+#include "util/geo/Point.h"
+#include "osmelevation/elevation/GeoElevation.h"
+#include "osmelevation/elevation/Interpolation.h"
+
+using global::INVALID_ELEV;
+using osmelevation::elevation::GeoElevation;
+using osmelevation::elevation::Interpolation;
+using Coordinate = util::geo::Point<double>;
+
+/*
+ * Compare the interpolation kernels in terms of throughput (nodes/s)
+ * and their deviation from the inverse distance weighting kernel.
+ * Random coordinates are sampled inside the NASADEM file with the given
+ * bottom-left corner, which should be available in the given directory.
+ */
+
+// _____________________________________________________________________________
+template <Interpolation kernel>
+double runKernel(GeoElevation& geoElevation,
+                 const std::vector<Coordinate>& coords,
+                 std::vector<int16_t>& elevations) {
+  elevations.clear();
+  elevations.reserve(coords.size());
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& coord : coords) {
+    elevations.emplace_back(
+        geoElevation.getKernelElevation<kernel>(coord));
+  }
+  const auto end = std::chrono::steady_clock::now();
+  const std::chrono::duration<double> seconds = end - start;
+  return coords.size() / seconds.count();
+}
+
+// _____________________________________________________________________________
+void printResult(const std::string& name, const double nodesPerSecond,
+                 const std::vector<int16_t>& elevations,
+                 const std::vector<int16_t>& reference) {
+  // Deviation from the reference, only where both have an elevation.
+  uint64_t count = 0;
+  double absSum = 0.0;
+  double squareSum = 0.0;
+  int16_t maxDeviation = 0;
+  for (size_t i = 0; i < elevations.size(); ++i) {
+    if (elevations[i] == INVALID_ELEV || reference[i] == INVALID_ELEV) {
+      continue;
+    }
+    const int16_t deviation = std::abs(elevations[i] - reference[i]);
+    ++count;
+    absSum += deviation;
+    squareSum += deviation * deviation;
+    if (deviation > maxDeviation) { maxDeviation = deviation; }
+  }
+  const double mean = (count > 0) ? absSum / count : 0.0;
+  const double rms = (count > 0) ? sqrt(squareSum / count) : 0.0;
+
+  std::cout << std::left << std::setw(10) << name << std::right;
+  std::cout << std::setw(14) << std::fixed << std::setprecision(0);
+  std::cout << nodesPerSecond << std::setprecision(3);
+  std::cout << std::setw(12) << mean << std::setw(12) << rms;
+  std::cout << std::setw(10) << maxDeviation << std::endl;
+}
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc < 4) {
+    std::cerr << "Usage: ./InterpolationBenchmark <NASADEM files directory> ";
+    std::cerr << "<lon> <lat> [number of nodes]" << std::endl;
+    std::cerr << "<lon> and <lat> are the bottom-left corner of the ";
+    std::cerr << "NASADEM file to sample from." << std::endl;
+    return 1;
+  }
+  const std::string nasademDir = argv[1];
+  const int16_t lon = atoi(argv[2]);
+  const int16_t lat = atoi(argv[3]);
+  const uint64_t nodeCount = (argc > 4) ? std::stoull(argv[4]) : 10000000;
+
+  // Use a fixed seed so runs are comparable.
+  std::mt19937_64 generator(42);
+  std::uniform_real_distribution<double> offset(0.0, 1.0);
+  std::vector<Coordinate> coords;
+  coords.reserve(nodeCount);
+  for (uint64_t i = 0; i < nodeCount; ++i) {
+    coords.emplace_back(lon + offset(generator), lat + offset(generator));
+  }
+
+  // Load the NASADEM file before any measurement.
+  GeoElevation geoElevation(nasademDir);
+  geoElevation.getInterpolatedElevation(coords.front());
+
+  std::vector<int16_t> reference;
+  std::vector<int16_t> elevations;
+  const double idw = runKernel<Interpolation::IDW>(geoElevation, coords,
+                                                   reference);
+
+  std::cout << "Sampled " << nodeCount << " nodes, deviation in meters ";
+  std::cout << "compared to idw." << std::endl;
+  std::cout << std::left << std::setw(10) << "kernel" << std::right;
+  std::cout << std::setw(14) << "nodes/s" << std::setw(12) << "mean";
+  std::cout << std::setw(12) << "rms" << std::setw(10) << "max";
+  std::cout << std::endl;
+
+  const double nearest = runKernel<Interpolation::NEAREST>(geoElevation,
+                                                           coords, elevations);
+  printResult("nearest", nearest, elevations, reference);
+  const double bilinear = runKernel<Interpolation::BILINEAR>(geoElevation,
+                                                             coords,
+                                                             elevations);
+  printResult("bilinear", bilinear, elevations, reference);
+  printResult("idw", idw, reference, reference);
+}
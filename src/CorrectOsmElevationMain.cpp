@@ -5,14 +5,19 @@
 #include <iostream>
 #include <filesystem>
 #include <ctime>
+#include <cstdint>
+#include <limits>
 #include "correctosmelevation/osm/CorrectElevation.h"
 #include "util/console/Console.h"
+#include "util/metrics/Metrics.h"
 
 using correctosmelevation::osm::CorrectElevation;
 using util::console::CommandLineArgsCorrect;
 using util::console::parseCommandLineArgumentsCorrect;
+using util::metrics::Metrics;
 
 bool validArguments(CommandLineArgsCorrect args);
+uint64_t availableMemory();
 
 // _____________________________________________________________________________
 int main(int argc, char** argv) {
@@ -26,23 +31,38 @@ int main(int argc, char** argv) {
       return 0;
     }
 
-    const uint64_t availableMemoryInGB = (sysconf(_SC_PHYS_PAGES) *
-                                          sysconf(_SC_PAGESIZE) /
-                                         1073741824) - 5;
+    // Without a limit, leave 5GB of the physical memory for osmium.
+    const uint64_t memoryLimit = (args.memoryLimit > 0) ? args.memoryLimit
+                                                        : availableMemory();
 
-    const auto routeWaysPerRange = availableMemoryInGB * 500000;
+    // The ranges are only limited by the memory they need.
+    const auto routeWaysPerRange = std::numeric_limits<uint64_t>::max();
 
-    const auto routeRelationsPerRange = availableMemoryInGB * 50000;
+    const auto routeRelationsPerRange = std::numeric_limits<uint64_t>::max();
 
     CorrectElevation correctElevation(args.inputFile, args.outputFile,
                                       args.elevationTag, routeWaysPerRange,
-                                      routeRelationsPerRange);
+                                      routeRelationsPerRange, args.threads,
+                                      memoryLimit);
     correctElevation.initialize();
 
+    if (args.resume) {
+      if (correctElevation.resume()) {
+        std::cout << "Resuming from the checkpoint." << "\n" << std::endl;
+      } else {
+        std::cout << "No checkpoint for the input file, starting from the ";
+        std::cout << "beginning." << "\n" << std::endl;
+      }
+    }
+
     correctElevation.correctRoutes();
 
     correctElevation.writeOutputOSM();
 
+    if (!args.metricsOut.empty()) {
+      Metrics::get().writeJson(args.metricsOut, "correctosmelevation");
+    }
+
     end = time(&end);
     double timeDiff = difftime(end, start);
     std::cout << "Program completed, took ";
@@ -78,6 +98,16 @@ uint16_t ava(const uint64_t& nodeCount) {
   return (nasademMem > 1) ? nasademMem / 27262976 : 1;
 }
 
+// _____________________________________________________________________________
+uint64_t availableMemory() {
+  const uint64_t physicalMemory = sysconf(_SC_PHYS_PAGES) *
+                                  sysconf(_SC_PAGESIZE);
+  const uint64_t parsingMemory = 5368709120;
+  // At least 1GB on small machines.
+  return (physicalMemory > parsingMemory + 1073741824)
+         ? physicalMemory - parsingMemory : 1073741824;
+}
+
 // _____________________________________________________________________________
 bool validArguments(CommandLineArgsCorrect args) {
   bool valid = true;
@@ -5,8 +5,9 @@
 #include <iostream>
 #include <filesystem>
 #include <ctime>
-#include "osmelevation/osm/GeoPartition.h"
+#include <vector>
 #include "osmelevation/osm/GeoBoundaries.h"
+#include "osmelevation/osm/PartitionScheduler.h"
 #include "parser/NodeWayRelationParser.h"
 #include "util/console/Console.h"
 #include "util/osm/OsmStats.h"
@@ -14,10 +15,14 @@
 #include "util/index/ElevationIndex.h"
 #include "util/index/ElevationIndexDense.h"
 #include "util/index/ElevationIndexSparse.h"
+#include "util/metrics/Metrics.h"
 #include "writer/OsmAddElevationWriter.h"
+#include "writer/OsmChangeElevationWriter.h"
+#include "sidecar/ElevationSidecarWriter.h"
+#include "sidecar/OutputFormat.h"
 
 using osmelevation::osm::GeoBoundaries;
-using osmelevation::osm::GeoPartition;
+using osmelevation::osm::PartitionScheduler;
 using parser::NodeWayRelationParser;
 using util::console::parseCommandLineArgumentsAdd;
 using util::console::CommandLineArgsAdd;
@@ -26,11 +31,18 @@ using util::osm::GetOsmStats;
 using util::index::ElevationIndex;
 using util::index::ElevationIndexDense;
 using util::index::ElevationIndexSparse;
+using util::metrics::Metrics;
+using util::metrics::Phase;
+using util::metrics::fileBytes;
 using writer::OsmAddElevationWriter;
+using writer::OsmChangeElevationWriter;
+using sidecar::ElevationSidecarWriter;
+using sidecar::OutputFormat;
 
 void run(const CommandLineArgsAdd& args);
 OsmStats getOsmStats(const std::string& osmFile);
 bool validArguments(CommandLineArgsAdd args);
+bool isChangeFile(const std::string& osmFile);
 uint16_t nasademFilesInMemory(const uint64_t& nodeCount);
 uint16_t getBoundarySize(const uint16_t maxInMemory);
 
@@ -44,6 +56,9 @@ int main(int argc, char** argv) {
       return 0;
     }
     run(args);
+    if (!args.metricsOut.empty()) {
+      Metrics::get().writeJson(args.metricsOut, "osmelevation");
+    }
 
     end = time(&end);
     double timeDiff = difftime(end, start);
@@ -74,25 +89,69 @@ void run(const CommandLineArgsAdd& args) {
                                              osmStats.max);
   }
 
-  // Get the boundaries for all geo partitions.
+  // Get the boundaries for all geo partitions, only covering
+  // the areas that contain nodes.
   GeoBoundaries geoBoundaries(getBoundarySize(maxInMemory), osmStats);
-  const auto boundaries = geoBoundaries.buildBoundaries();
-
-  // Work off all geographic partitions and
-  // collect the elevation for each node.
+  const auto boundaries = geoBoundaries.planBoundaries();
+  std::cout << "Planned " << boundaries.size();
+  std::cout << " geographic partitions." << std::endl;
+
+  // Work off all geographic partitions and collect the elevation for
+  // each node. Several partitions can be worked off at the same time, as
+  // long as the NASADEM files they need fit into memory together.
+  std::vector<uint32_t> footprints;
+  footprints.reserve(boundaries.size());
   for (const auto& boundary : boundaries) {
-    GeoPartition geoPartition(*elevationIndex, osmStats,
-                              args.inputFile, args.nasademDir, boundary);
-    geoPartition.elevationsInPartition();
+    footprints.push_back(geoBoundaries.nasademFilesNeeded(boundary));
+  }
+  {
+    Phase phase("elevation");
+    PartitionScheduler scheduler(*elevationIndex, osmStats, args.inputFile,
+                                 args.nasademDir, args.interpolation,
+                                 maxInMemory, args.threads);
+    scheduler.run(boundaries, footprints);
+    phase.add("nodes", osmStats.nodeCount);
+    phase.add("partitions", boundaries.size());
   }
 
   // Sort the index if sparse was used.
-  elevationIndex->process();
+  {
+    Phase phase("sortIndex");
+    elevationIndex->process();
+    phase.add("indexBytes", elevationIndex->byteSize());
+  }
+
+  Phase phase("write");
+  phase.add("nodes", osmStats.nodeCount);
+
+  // Only the changed nodes are needed, ways and relations are skipped.
+  if (args.format == OutputFormat::OSC) {
+    OsmChangeElevationWriter writer(args.inputFile, args.outputFile,
+                                    elevationIndex.get(), args.elevationTag,
+                                    false);
+    phase.add("changedNodes", writer.write());
+    phase.add("bytesRead", fileBytes(args.inputFile));
+    phase.add("bytesWritten", fileBytes(args.outputFile));
+    return;
+  }
+
+  // Only the elevations are needed, no need to rewrite the osm file.
+  if (args.format != OutputFormat::OSM) {
+    ElevationSidecarWriter writer(args.outputFile, elevationIndex.get(),
+                                  args.format);
+    writer.write();
+    phase.add("bytesWritten", fileBytes(args.outputFile));
+    return;
+  }
 
-  // Write the result to the specified output osm file.
+  // Write the result to the specified output osm file. For an update, this
+  // is the OsmChange input file with the elevation tags added to the
+  // created and modified nodes.
   OsmAddElevationWriter writer(args.inputFile, args.outputFile,
                                elevationIndex.get(), args.elevationTag, false);
   writer.write();
+  phase.add("bytesRead", fileBytes(args.inputFile));
+  phase.add("bytesWritten", fileBytes(args.outputFile));
 }
 
 // _____________________________________________________________________________
@@ -108,9 +167,29 @@ bool validArguments(CommandLineArgsAdd args) {
     valid = false;
     std::cerr << "Invalid output file: File does already exist." << std::endl;
   }
+  // An update reads and writes OsmChange files, all other objects than the
+  // created and modified nodes are passed through.
+  if (args.update) {
+    if (!isChangeFile(args.inputFile) || !isChangeFile(args.outputFile)) {
+      valid = false;
+      std::cerr << "Invalid update: Input and output file must be OsmChange ";
+      std::cerr << "files (.osc, .osc.gz or .osc.bz2)." << std::endl;
+    }
+    if (args.format != OutputFormat::OSM) {
+      valid = false;
+      std::cerr << "Invalid update: The output format can't be chosen.";
+      std::cerr << std::endl;
+    }
+  }
   return valid;
 }
 
+// _____________________________________________________________________________
+bool isChangeFile(const std::string& osmFile) {
+  return osmFile.ends_with(".osc") || osmFile.ends_with(".osc.gz") ||
+         osmFile.ends_with(".osc.bz2");
+}
+
 // _____________________________________________________________________________
 uint16_t nasademFilesInMemory(const uint64_t& nodeCount) {
   const uint64_t availableMem = sysconf(_SC_PHYS_PAGES) *
@@ -138,6 +217,7 @@ uint16_t nasademFilesInMemory(const uint64_t& nodeCount) {
 
 // _____________________________________________________________________________
 OsmStats getOsmStats(const std::string& osmFile) {
+  Phase phase("statistics");
   GetOsmStats handler;
   NodeWayRelationParser statsParser(osmFile, &handler);
 
@@ -154,6 +234,10 @@ OsmStats getOsmStats(const std::string& osmFile) {
   std::cout << " seconds." << "\n" << std::endl;
 
   OsmStats osmStats = handler.getOsmStats();
+  phase.add("nodes", osmStats.nodeCount);
+  phase.add("ways", osmStats.wayCount);
+  phase.add("relations", osmStats.relationCount);
+  phase.add("bytesRead", fileBytes(osmFile));
 
   return osmStats;
 }
@@ -13,10 +13,11 @@ using correctosmelevation::correct::RiverNode;
 
 // _____________________________________________________________________________
 CorrectRiver::CorrectRiver(const std::vector<std::vector<uint64_t>>& nodeIds,
+                           const SlotPaths& slots,
                            const std::vector<size_t>& nodeCounts,
                            NodeIndex& nodeIndex,
                            AverageElevationIndexSparse& elevationIndex) :
-                           CorrectRoute(nodeIds, nodeCounts, nodeIndex,
+                           CorrectRoute(nodeIds, slots, nodeCounts, nodeIndex,
                                         elevationIndex) {
   _elevations.resize(_nodeCounts.size());
   for (size_t subroute = 0; subroute < _nodeCounts.size(); ++subroute) {
@@ -36,6 +36,7 @@ struct RiverNode {
 class CorrectRiver : public CorrectRoute {
  public:
   CorrectRiver(const std::vector<std::vector<uint64_t>>& nodeIds,
+               const SlotPaths& slots,
                const std::vector<size_t>& nodeCounts, NodeIndex& nodeIndex,
                AverageElevationIndexSparse& elevationIndex);
 
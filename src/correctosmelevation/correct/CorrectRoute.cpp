@@ -5,7 +5,6 @@
 #include "global/Constants.h"
 #include "util/geo/Point.h"
 #include "util/geo/Geo.h"
-#include "util/osm/Node.h"
 #include "util/index/NodeIndex.h"
 #include "util/index/AverageElevationIndexSparse.h"
 #include "correctosmelevation/correct/CorrectRoute.h"
@@ -13,17 +12,19 @@
 using correctosmelevation::correct::CorrectRoute;
 using global::INVALID_ELEV;
 using util::index::NodeIndex;
+using util::index::SlotPaths;
 using util::index::AverageElevationIndexSparse;
 using util::geo::haversine;
-using util::osm::Node;
 using Coordinate = util::geo::Point<double>;
 
 // _____________________________________________________________________________
 CorrectRoute::CorrectRoute(const std::vector<std::vector<uint64_t>>& nodeIds,
+                           const SlotPaths& slots,
                            const std::vector<size_t>& nodeCounts,
                            NodeIndex& nodeIndex,
                            AverageElevationIndexSparse& elevationIndex) :
                            _nodeIds(nodeIds),
+                           _slots(slots),
                            _nodeCounts(nodeCounts),
                            _nodeIndex(nodeIndex),
                            _elevationIndex(elevationIndex) {
@@ -33,9 +34,10 @@ CorrectRoute::CorrectRoute(const std::vector<std::vector<uint64_t>>& nodeIds,
 // _____________________________________________________________________________
 void CorrectRoute::buildCoords() {
   for (size_t subroute = 0; subroute < _nodeIds.size(); ++subroute) {
-    for (size_t nodeId = 0; nodeId < _nodeCounts[subroute]; ++nodeId) {
-      const Node& node = _nodeIndex.getNode(_nodeIds[subroute][nodeId]);
-      _nodeCoords[subroute].emplace_back(node.lon, node.lat);
+    for (size_t i = 0; i < _nodeCounts[subroute]; ++i) {
+      const auto slot = _slots[subroute][i];
+      _nodeCoords[subroute].emplace_back(_nodeIndex.lon(slot),
+                                         _nodeIndex.lat(slot));
     }
   }
 }
@@ -43,10 +45,10 @@ void CorrectRoute::buildCoords() {
 // _____________________________________________________________________________
 void CorrectRoute::buildElevations() {
   for (size_t subroute = 0; subroute < _nodeIds.size(); ++subroute) {
-    for (size_t nodeId = 0; nodeId < _nodeCounts[subroute]; ++nodeId) {
-      const Node& node = _nodeIndex.getNode(_nodeIds[subroute][nodeId]);
-      _elevations[subroute].emplace_back(node.elevation);
-      if (node.elevation == INVALID_ELEV) {
+    for (size_t i = 0; i < _nodeCounts[subroute]; ++i) {
+      const auto elevation = _nodeIndex.elevation(_slots[subroute][i]);
+      _elevations[subroute].emplace_back(elevation);
+      if (elevation == INVALID_ELEV) {
         _allDataAvailable[subroute] = false;
       }
     }
@@ -70,11 +72,13 @@ void CorrectRoute::buildDistances() {
 // _____________________________________________________________________________
 void CorrectRoute::buildCoordsAndElevations() {
   for (size_t subroute = 0; subroute < _nodeIds.size(); ++subroute) {
-    for (size_t nodeId = 0; nodeId < _nodeCounts[subroute]; ++nodeId) {
-      const Node& node = _nodeIndex.getNode(_nodeIds[subroute][nodeId]);
-      _nodeCoords[subroute].emplace_back(node.lon, node.lat);
-      _elevations[subroute].emplace_back(node.elevation);
-      if (node.elevation == INVALID_ELEV) {
+    for (size_t i = 0; i < _nodeCounts[subroute]; ++i) {
+      const auto slot = _slots[subroute][i];
+      const auto elevation = _nodeIndex.elevation(slot);
+      _nodeCoords[subroute].emplace_back(_nodeIndex.lon(slot),
+                                         _nodeIndex.lat(slot));
+      _elevations[subroute].emplace_back(elevation);
+      if (elevation == INVALID_ELEV) {
         _allDataAvailable[subroute] = false;
       }
     }
@@ -14,6 +14,7 @@ namespace correctosmelevation {
 namespace correct {
 
 using util::index::NodeIndex;
+using util::index::SlotPaths;
 using util::index::AverageElevationIndexSparse;
 using Coordinate = util::geo::Point<double>;
 
@@ -23,6 +24,7 @@ using Coordinate = util::geo::Point<double>;
 class CorrectRoute {
  public:
   CorrectRoute(const std::vector<std::vector<uint64_t>>& nodeIds,
+               const SlotPaths& slots,
                const std::vector<size_t>& nodeCounts,
                NodeIndex& nodeIndex,
                AverageElevationIndexSparse& elevationIndex);
@@ -45,11 +47,15 @@ class CorrectRoute {
   // the route paths.
   const std::vector<std::vector<uint64_t>>& _nodeIds;
 
+  // The slots of the nodes in the node index, resolved once for all
+  // routes of a range. Used to read the nodes without any search.
+  const SlotPaths& _slots;
+
   // The number of nodes each route path consists of.
   const std::vector<size_t>& _nodeCounts;
 
   // The node index where the coordinate and elevation
-  // of each node can be retrieved with the node's id.
+  // of each node can be retrieved with the node's slot.
   NodeIndex& _nodeIndex;
 
   // Index where the results of the corrections can be stored.
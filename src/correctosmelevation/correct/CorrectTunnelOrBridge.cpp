@@ -22,9 +22,10 @@ using Coordinate = util::geo::Point<double>;
 // _____________________________________________________________________________
 CorrectTunnelOrBridge::CorrectTunnelOrBridge(
     const std::vector<std::vector<uint64_t>>& nodeIds,
+    const SlotPaths& slots,
     const std::vector<size_t>& nodeCounts, NodeIndex& nodeIndex,
     AverageElevationIndexSparse& elevationIndex) :
-    CorrectRoute(nodeIds, nodeCounts, nodeIndex, elevationIndex) {
+    CorrectRoute(nodeIds, slots, nodeCounts, nodeIndex, elevationIndex) {
   // All sizes are known.
   _elevations.resize(nodeCounts.size());
   _nodeCoords.resize(nodeCounts.size());
@@ -103,8 +104,8 @@ void CorrectTunnelOrBridge::estimateUnknownSection() const {
       const auto elev = getElevationOnPlane(_nodeCoords[subroute][i]);
       _elevationIndex.setElevationTunnelOrBridge(
           _nodeIds[subroute][i], elev);
-      _nodeIndex.updateElevation(_nodeIds[subroute][i],
-                                 static_cast<int16_t>(std::lround(elev)));
+      _nodeIndex.setElevation(_slots[subroute][i],
+                              static_cast<int16_t>(std::lround(elev)));
     }
   }
 
@@ -112,14 +113,14 @@ void CorrectTunnelOrBridge::estimateUnknownSection() const {
   for (size_t i = 1; i < _startNodeBefore + 1; ++i) {
     const auto elev = getElevationOnPlane(_nodeCoords[0][i]);
     _elevationIndex.setElevation(_nodeIds[0][i], elev);
-    _nodeIndex.updateElevation(_nodeIds[0][i],
-                               static_cast<int16_t>(std::lround(elev)));
+    _nodeIndex.setElevation(_slots[0][i],
+                            static_cast<int16_t>(std::lround(elev)));
   }
   for (size_t i = 1; i < _endNodeAfter + 1; ++i) {
     const auto elev = getElevationOnPlane(_nodeCoords[2][i]);
     _elevationIndex.setElevation(_nodeIds[2][i], elev);
-    _nodeIndex.updateElevation(_nodeIds[2][i],
-                               static_cast<int16_t>(std::lround(elev)));
+    _nodeIndex.setElevation(_slots[2][i],
+                            static_cast<int16_t>(std::lround(elev)));
   }
 }
 
@@ -32,6 +32,7 @@ class CorrectTunnelOrBridge : public CorrectRoute {
   // the tunnel/bridge, the one representing the complete tunnel/bridge
   // section, and the one directly after.
   CorrectTunnelOrBridge(const std::vector<std::vector<uint64_t>>& nodeIds,
+                        const SlotPaths& slots,
                         const std::vector<size_t>& nodeCounts,
                         NodeIndex& nodeIndex,
                         AverageElevationIndexSparse& elevationIndex);
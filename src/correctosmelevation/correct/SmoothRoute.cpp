@@ -15,10 +15,11 @@ using correctosmelevation::correct::CorrectRoute;
 
 // _____________________________________________________________________________
 SmoothRoute::SmoothRoute(const std::vector<std::vector<uint64_t>>& nodeIds,
+                         const SlotPaths& slots,
                          const std::vector<size_t>& nodeCounts,
                          NodeIndex& nodeIndex,
                          AverageElevationIndexSparse& elevationIndex) :
-                         CorrectRoute(nodeIds, nodeCounts, nodeIndex,
+                         CorrectRoute(nodeIds, slots, nodeCounts, nodeIndex,
                                       elevationIndex) {
   // All sizes are known.
   _distances.resize(nodeCounts.size());
@@ -32,7 +33,8 @@ SmoothRoute::SmoothRoute(const std::vector<std::vector<uint64_t>>& nodeIds,
 }
 
 // _____________________________________________________________________________
-void SmoothRoute::smoothMovingAverage(const double windowSize) const {
+void SmoothRoute::smoothMovingAverage(const double windowSize,
+                                      const uint16_t weight) const {
   // All data needs to be available.
   for (auto allDataAvailable : _allDataAvailable) {
     if (!allDataAvailable) {
@@ -50,7 +52,7 @@ void SmoothRoute::smoothMovingAverage(const double windowSize) const {
                &nodeCountInt, &result[0], &halfWindowSize, &halfWindowSize);
     for (size_t i = 0; i < _nodeCounts[subroute]; ++i) {
       _elevationIndex.setElevation(_nodeIds[subroute][i],
-                                   static_cast<float>(result[i]));
+                                   static_cast<float>(result[i]), weight);
     }
   }
 }
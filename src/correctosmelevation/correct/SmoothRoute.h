@@ -24,13 +24,16 @@ using correctosmelevation::correct::CorrectRoute;
 class SmoothRoute : public CorrectRoute {
  public:
   SmoothRoute(const std::vector<std::vector<uint64_t>>& nodeIds,
+              const SlotPaths& slots,
               const std::vector<size_t>& nodeCounts,
               NodeIndex& nodeIndex,
               AverageElevationIndexSparse& elevationIndex);
 
-  // Apply a linear moving average to each node.
+  // Apply a linear moving average to each node. The elevations count as
+  // often as the weight says, for a route found several times.
   // See https://github.com/andreas50/utsOperators for details.
-  void smoothMovingAverage(const double windowSize) const;
+  void smoothMovingAverage(const double windowSize,
+                           const uint16_t weight = 1) const;
 };
 
 }  // namespace correct
@@ -0,0 +1,163 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "util/index/IdBitmap.h"
+#include "util/index/AverageElevationIndexSparse.h"
+#include "util/metrics/Metrics.h"
+#include "correctosmelevation/osm/Checkpoint.h"
+
+using correctosmelevation::osm::Checkpoint;
+using correctosmelevation::osm::CorrectionStage;
+using util::index::IdBitmap;
+using util::index::AverageElevationIndexSparse;
+using util::metrics::wallSeconds;
+
+namespace {
+
+// Magic bytes and format version at the start and end of the file.
+const char CHECKPOINT_MAGIC[8] = { 'O', 'S', 'M', 'E', 'C', 'K', 'P', 1 };
+
+// Size of the buffer of the output stream.
+constexpr size_t BUFFER_SIZE = 1 << 22;
+
+// ____________________________________________________________________________
+bool syncFile(const std::string& file, const int flags) {
+  const int fd = open(file.c_str(), flags);
+  if (fd < 0) {
+    return false;
+  }
+  const bool synced = fsync(fd) == 0;
+  close(fd);
+  return synced;
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+Checkpoint::Checkpoint(const std::string& file, const std::string& inFile,
+                       const std::string& elevationTag,
+                       const double interval) :
+                       _file(file), _inFile(inFile),
+                       _elevationTag(elevationTag), _interval(interval),
+                       _lastWrite(wallSeconds()) {}
+
+// ____________________________________________________________________________
+bool Checkpoint::due() const {
+  return wallSeconds() - _lastWrite >= _interval;
+}
+
+// ____________________________________________________________________________
+bool Checkpoint::write(const CorrectionStage stage, const uint64_t next,
+                       const IdBitmap& correctedWayIds,
+                       const AverageElevationIndexSparse& elevationIndex) {
+  const std::string tmpFile = _file + ".tmp";
+  {
+    std::vector<char> buffer(BUFFER_SIZE);
+    std::ofstream out;
+    out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    out.open(tmpFile, std::ios::binary | std::ios::trunc);
+    const std::string key = inputKey();
+    const uint64_t keySize = key.size();
+    const uint8_t stageByte = static_cast<uint8_t>(stage);
+    out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+    out.write(key.data(), keySize);
+    out.write(reinterpret_cast<const char*>(&stageByte), sizeof(stageByte));
+    out.write(reinterpret_cast<const char*>(&next), sizeof(next));
+    correctedWayIds.write(out);
+    elevationIndex.write(out);
+    out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.close();
+    if (!out) {
+      std::remove(tmpFile.c_str());
+      return false;
+    }
+  }
+  // The data has to be on disk before the rename makes it the checkpoint,
+  // and the rename before the next checkpoint overwrites the file.
+  std::string directory = std::filesystem::path(_file).parent_path();
+  if (directory.empty()) {
+    directory = ".";
+  }
+  if (!syncFile(tmpFile, O_RDONLY) ||
+      std::rename(tmpFile.c_str(), _file.c_str()) != 0) {
+    std::remove(tmpFile.c_str());
+    return false;
+  }
+  syncFile(directory, O_RDONLY | O_DIRECTORY);
+  _lastWrite = wallSeconds();
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Checkpoint::read(CorrectionStage* stage, uint64_t* next,
+                      IdBitmap* correctedWayIds,
+                      AverageElevationIndexSparse* elevationIndex) const {
+  std::ifstream in(_file, std::ios::binary);
+  char magic[sizeof(CHECKPOINT_MAGIC)];
+  in.read(magic, sizeof(magic));
+  if (!in || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic))) {
+    return false;
+  }
+  const std::string expectedKey = inputKey();
+  uint64_t keySize = 0;
+  in.read(reinterpret_cast<char*>(&keySize), sizeof(keySize));
+  if (!in || keySize != expectedKey.size()) {
+    return false;
+  }
+  std::string key(keySize, '\0');
+  in.read(key.data(), keySize);
+  if (!in || key != expectedKey) {
+    return false;
+  }
+
+  // From here on, the file was written for this input file. It is read
+  // aside and only taken once it is complete.
+  uint8_t stageByte = 0;
+  uint64_t readNext = 0;
+  IdBitmap readWayIds;
+  AverageElevationIndexSparse readIndex(0, 0);
+  in.read(reinterpret_cast<char*>(&stageByte), sizeof(stageByte));
+  in.read(reinterpret_cast<char*>(&readNext), sizeof(readNext));
+  if (!in || stageByte > static_cast<uint8_t>(CorrectionStage::WAYS) ||
+      !readWayIds.read(in) || !readIndex.read(in)) {
+    throw std::runtime_error("Incomplete checkpoint file " + _file);
+  }
+  in.read(magic, sizeof(magic));
+  if (!in || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic))) {
+    throw std::runtime_error("Incomplete checkpoint file " + _file);
+  }
+  *stage = static_cast<CorrectionStage>(stageByte);
+  *next = readNext;
+  *correctedWayIds = std::move(readWayIds);
+  elevationIndex->swap(readIndex);
+  return true;
+}
+
+// ____________________________________________________________________________
+void Checkpoint::remove() const {
+  std::remove(_file.c_str());
+}
+
+// ____________________________________________________________________________
+std::string Checkpoint::inputKey() const {
+  struct stat fileStat;
+  if (stat(_inFile.c_str(), &fileStat) != 0) {
+    return _elevationTag;
+  }
+  return std::to_string(fileStat.st_size) + " " +
+         std::to_string(fileStat.st_mtim.tv_sec) + "." +
+         std::to_string(fileStat.st_mtim.tv_nsec) + " " + _elevationTag;
+}
@@ -0,0 +1,76 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_CORRECTOSMELEVATION_OSM_CHECKPOINT_H_
+#define SRC_CORRECTOSMELEVATION_OSM_CHECKPOINT_H_
+
+#include <cstdint>
+#include <string>
+#include "util/index/IdBitmap.h"
+#include "util/index/AverageElevationIndexSparse.h"
+
+namespace correctosmelevation {
+namespace osm {
+
+using util::index::IdBitmap;
+using util::index::AverageElevationIndexSparse;
+
+// The route relations are corrected before the route ways.
+enum class CorrectionStage : uint8_t {
+  RELATIONS = 0,
+  WAYS = 1
+};
+
+/*
+ * Checkpoint of a correction run at a range boundary, such that a killed
+ * run can be resumed without repeating the finished ranges. It holds the
+ * processed average elevation index, the ids of the ways corrected in
+ * route relations and where the next range starts.
+ * The checkpoint is written sequentially to a temporary file, synced and
+ * renamed over the previous one, so there is always a complete checkpoint.
+ * It is only read back for the same input file and elevation tag.
+ */
+class Checkpoint {
+ public:
+  // A checkpoint in the given file for the input file, written at most
+  // every interval seconds.
+  Checkpoint(const std::string& file, const std::string& inFile,
+             const std::string& elevationTag, const double interval);
+
+  // Whether the interval passed since the last checkpoint was written.
+  bool due() const;
+
+  // Write the state after the ranges before next of the stage. Return
+  // false if the checkpoint could not be written.
+  bool write(const CorrectionStage stage, const uint64_t next,
+             const IdBitmap& correctedWayIds,
+             const AverageElevationIndexSparse& elevationIndex);
+
+  // Read the last checkpoint. Return false if there is none for the
+  // input file, then nothing is changed. Throw if the checkpoint of the
+  // input file is incomplete, also without changing anything.
+  bool read(CorrectionStage* stage, uint64_t* next,
+            IdBitmap* correctedWayIds,
+            AverageElevationIndexSparse* elevationIndex) const;
+
+  // Remove the checkpoint after the run is complete.
+  void remove() const;
+
+ private:
+  // Identify the input file by its size, modification time and the
+  // elevation tag.
+  std::string inputKey() const;
+
+  const std::string _file;
+  const std::string _inFile;
+  const std::string _elevationTag;
+  const double _interval;
+
+  // The wall time the last checkpoint was written, or the start.
+  double _lastWrite;
+};
+
+}  // namespace osm
+}  // namespace correctosmelevation
+
+#endif  // SRC_CORRECTOSMELEVATION_OSM_CHECKPOINT_H_
@@ -4,52 +4,112 @@
 #include <string>
 #include <iostream>
 #include <vector>
-#include <set>
 #include <cstdint>
 #include <memory>
 #include <ctime>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include "util/index/IdBitmap.h"
 #include "writer/OsmAddElevationWriter.h"
 #include "util/index/NodeIndex.h"
+#include "util/index/NodeIds.h"
+#include "util/index/NodeStore.h"
 #include "util/index/AverageElevationIndexSparse.h"
 #include "util/osm/OsmStats.h"
-#include "util/osm/GetOsmStats.h"
+#include "util/metrics/Metrics.h"
+#include "util/thread/ParallelFor.h"
 #include "parser/NodeWayRelationParser.h"
 #include "correctosmelevation/correct/SmoothRoute.h"
 #include "correctosmelevation/correct/CorrectRiver.h"
 #include "correctosmelevation/correct/CorrectTunnelOrBridge.h"
+#include "correctosmelevation/osm/Checkpoint.h"
 #include "correctosmelevation/osm/RoutesFromRelations.h"
 #include "correctosmelevation/osm/RoutesFromWays.h"
+#include "correctosmelevation/osm/RangePlanner.h"
+#include "correctosmelevation/osm/RelationRoutes.h"
+#include "correctosmelevation/osm/RoutePathCache.h"
+#include "correctosmelevation/osm/RouteStatsHandler.h"
 #include "correctosmelevation/osm/CorrectElevation.h"
 
+using util::index::IdBitmap;
 using writer::OsmAddElevationWriter;
 using correctosmelevation::osm::CorrectElevation;
+using correctosmelevation::osm::Checkpoint;
+using correctosmelevation::osm::CorrectionStage;
 using correctosmelevation::osm::RoutesFromRelations;
 using correctosmelevation::osm::RoutesFromWays;
+using correctosmelevation::osm::RangePlanner;
+using correctosmelevation::osm::RoutePathCache;
+using correctosmelevation::osm::RouteStatsHandler;
+using correctosmelevation::osm::routesByteSize;
+using correctosmelevation::osm::routesNodeCount;
 using correctosmelevation::correct::SmoothRoute;
 using correctosmelevation::correct::CorrectRiver;
 using correctosmelevation::correct::CorrectTunnelOrBridge;
 using util::index::NodeIndex;
+using util::index::NodeIds;
+using util::index::NodeStore;
+using util::index::sortUnique;
 using parser::NodeWayRelationParser;
 using util::osm::OsmStats;
-using util::osm::GetOsmStats;
 using util::index::AverageElevationIndexSparse;
+using util::metrics::Metrics;
+using util::metrics::Phase;
+using util::metrics::fileBytes;
+using util::metrics::wallSeconds;
+using util::thread::parallelFor;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
+namespace {
+
+// First estimate of the bytes of a node along the routes of a range: its
+// id in the route, in the required ids and in the node index, its slot
+// and its coordinates and elevation in the correctors.
+constexpr double BYTES_PER_NODE = 64;
+
+// First estimate of the bytes of a member way of a route relation that
+// come on top of its nodes, mainly for the way kept by osmium until the
+// relation is complete.
+constexpr double BYTES_PER_WAY = 256;
+
+// Write a checkpoint at most every 30 minutes, writing the whole average
+// elevation index takes a while for the planet.
+constexpr double CHECKPOINT_INTERVAL = 1800;
+
+}  // namespace
+
 // _____________________________________________________________________________
 CorrectElevation::CorrectElevation(const std::string inFile,
                                    const std::string outFile,
                                    const std::string elevationTag,
                                    const uint64_t waysPerRange,
-                                   const uint64_t relationsPerRange) :
+                                   const uint64_t relationsPerRange,
+                                   const uint16_t threads,
+                                   const uint64_t memoryLimit) :
                                    _inFile(inFile),
                                    _outFile(outFile),
                                    _elevationTag(elevationTag),
                                    _waysPerRange(waysPerRange),
-                                   _relationsPerRange(relationsPerRange) {}
+                                   _relationsPerRange(relationsPerRange),
+                                   _threads(std::max(threads,
+                                            static_cast<uint16_t>(1))),
+                                   _memoryLimit(memoryLimit) {
+  _checkpoint = std::make_unique<Checkpoint>(_outFile + ".checkpoint",
+                                             _inFile, _elevationTag,
+                                             CHECKPOINT_INTERVAL);
+  _resumeStage = CorrectionStage::RELATIONS;
+  _resumeStart = 0;
+}
 
 // _____________________________________________________________________________
 void CorrectElevation::initialize() {
-  GetOsmStats handler;
+  Phase phase("statistics");
+  // Store the nodes while reading them anyway, such that the ranges don't
+  // have to decode them again.
+  _nodeStore = std::make_unique<NodeStore>(_outFile + ".nodes");
+  RouteStatsHandler handler(_nodeStore.get(), _elevationTag);
   NodeWayRelationParser statsParser(_inFile, &handler);
 
   time_t start, end;
@@ -65,10 +125,35 @@ void CorrectElevation::initialize() {
   std::cout << " seconds." << "\n" << std::endl;
 
   _osmStats = handler.getOsmStats();
+  _routeStats = handler.getRouteStats();
+  _nodeStore->finish();
   _elevationIndex =
     std::make_unique<AverageElevationIndexSparse>(_osmStats.nodeCount / 2,
                                                   _osmStats.max);
   _elevationIndex->process();
+
+  phase.add("nodes", _osmStats.nodeCount);
+  phase.add("ways", _osmStats.wayCount);
+  phase.add("relations", _osmStats.relationCount);
+  phase.add("routeRelations", _routeStats.relationMembers.size());
+  phase.add("highwayWays", _routeStats.highwayWays);
+  phase.add("nodeStoreNodes", _nodeStore->valid() ? _nodeStore->size() : 0);
+  phase.add("nodeStoreBytes", _nodeStore->byteSize());
+  phase.add("nodeStoreDense", _nodeStore->dense());
+  phase.add("bytesRead", fileBytes(_inFile));
+}
+
+// _____________________________________________________________________________
+bool CorrectElevation::resume() {
+  return _checkpoint->read(&_resumeStage, &_resumeStart, &_resumeWayIds,
+                           _elevationIndex.get());
+}
+
+// _____________________________________________________________________________
+void CorrectElevation::setCheckpointInterval(const double seconds) {
+  _checkpoint = std::make_unique<Checkpoint>(_outFile + ".checkpoint",
+                                             _inFile, _elevationTag,
+                                             seconds);
 }
 
 // _____________________________________________________________________________
@@ -90,71 +175,159 @@ void CorrectElevation::correctRoutes() const {
 }
 
 // _____________________________________________________________________________
-std::set<uint64_t> CorrectElevation::correctRouteRelationsInRanges(
+IdBitmap CorrectElevation::correctRouteRelationsInRanges(
     const uint64_t absoluteMax, const uint64_t maxPerLoop) const {
-  std::set<uint64_t> correctedWayIds;
-  uint64_t currentStart = 0;
-  uint64_t currentEnd = maxPerLoop;
+  Phase phase("correctRelations");
+  IdBitmap correctedWayIds = _resumeWayIds;
 
-  while (currentStart < absoluteMax) {
-    std::vector<RoutePaths> routePaths;
-    std::vector<RoutePaths> rivers;
-    std::vector<RoutePaths> tunnelsAndBridges;
-    auto routesFromRelations =
-        RoutesFromRelations(_inFile, _osmStats, _elevationTag,
-                            currentStart, currentEnd);
-    routesFromRelations.getRoutesAndIds(correctedWayIds, routePaths, rivers,
-                                        tunnelsAndBridges);
-
-    // If no more route paths or rivers were found, we are done.
-    if (routePaths.empty() && rivers.empty()) {
-      break;
+  // All routes and nodes of a pass are in memory at the same time. The
+  // passes are sized by the member ways of the relations.
+  const auto& members = _routeStats.relationMembers;
+  RangePlanner planner(rangeBudget(),
+                       nodesPerWay() * BYTES_PER_NODE + BYTES_PER_WAY);
+  const uint64_t relationCount = std::min<uint64_t>(absoluteMax,
+                                                    members.size());
+  // After a checkpoint of the ways, all relations are done.
+  uint64_t passStart = relationCount;
+  if (_resumeStage == CorrectionStage::RELATIONS) {
+    passStart = std::min(_resumeStart, relationCount);
+  }
+  while (passStart < relationCount) {
+    const uint64_t passEnd = planner.rangeEnd(members, passStart,
+                                              relationCount - passStart);
+    const uint64_t bytes = correctRelationPass(passStart, passEnd,
+                                               maxPerLoop, correctedWayIds,
+                                               phase);
+    uint64_t units = 0;
+    for (uint64_t i = passStart; i < passEnd; ++i) {
+      units += members[i];
     }
-    // Make a set containing all node ids that are needed.
-    const std::set<uint64_t> nodeIds =
-        routesFromRelations.requiredNodes(routePaths, rivers);
+    planner.measured(units, bytes);
+    planner.setBudget(rangeBudget());
+    phase.add("passes", 1);
+    phase.add("passBytes", bytes);
+    passStart = passEnd;
+    writeCheckpoint(CorrectionStage::RELATIONS, passStart, correctedWayIds,
+                    phase);
+  }
+  phase.add("indexBytes", _elevationIndex->byteSize());
+  phase.add("correctedWays", correctedWayIds.size());
+  phase.add("correctedWaysBytes", correctedWayIds.byteSize());
+  return correctedWayIds;
+}
 
-    // Build a node index with needed ids.
-    NodeIndex nodeIndex = routesFromRelations.buildNodeIndex(nodeIds);
+// _____________________________________________________________________________
+uint64_t CorrectElevation::correctRelationPass(const uint64_t passStart,
+                                               const uint64_t passEnd,
+                                               const uint64_t maxPerLoop,
+                                               IdBitmap& correctedWayIds,
+                                               Phase& phase) const {
+  // Assign the route relations to ranges and collect the routes of all
+  // ranges, reading the relations and the ways only once.
+  auto routesFromRelations =
+      RoutesFromRelations(_inFile, _osmStats, _elevationTag,
+                          passStart, passEnd, _nodeStore.get());
+  auto ranges =
+      routesFromRelations.getRoutesInRanges(correctedWayIds, maxPerLoop,
+                                            _threads);
+
+  // Relations often share their paths, keep each path of a range once.
+  for (auto& routes : ranges) {
+    RoutePathCache routePathCache;
+    for (auto& routePath : routes.routePaths) {
+      routePathCache.add(std::move(routePath));
+    }
+    routes.routePaths = routePathCache.getRoutePaths();
+    routes.routePathWeights = routePathCache.getWeights();
+    phase.add("duplicateRoutePaths", routePathCache.duplicates());
+  }
+  uint64_t bytes = 0;
+  for (const auto& routes : ranges) {
+    bytes += routes.byteSize();
+  }
+
+  // Read the nodes of all ranges in a single pass, too.
+  NodeIds allNodeIds;
+  for (const auto& routes : ranges) {
+    const auto nodeIds =
+        routesFromRelations.requiredNodes(routes.routePaths, routes.rivers);
+    allNodeIds.insert(allNodeIds.end(), nodeIds.begin(), nodeIds.end());
+  }
+  sortUnique(allNodeIds);
+  const NodeIndex allNodes = routesFromRelations.buildNodeIndex(allNodeIds);
+  bytes += allNodeIds.capacity() * sizeof(uint64_t) + allNodes.byteSize();
+  NodeIds().swap(allNodeIds);
+  phase.add("nodeIndexBytes", allNodes.byteSize());
+
+  for (auto& routes : ranges) {
+    // Ranges without route paths or rivers have nothing to correct.
+    if (routes.empty()) {
+      continue;
+    }
+    // Get the sorted ids of all nodes that are needed.
+    const NodeIds nodeIds =
+        routesFromRelations.requiredNodes(routes.routePaths, routes.rivers);
+    phase.add("ranges", 1);
+    phase.add("routes", routes.routePaths.size() + routes.rivers.size() +
+                        routes.tunnelsAndBridges.size());
+    phase.add("nodes", nodeIds.size());
+
+    // Each range works on its own copy of the nodes, since correcting
+    // tunnels/bridges updates the elevations in the node index.
+    NodeIndex nodeIndex = allNodes.subset(nodeIds);
 
     // Correct the different types of routes.
-    correctRivers(nodeIndex, rivers);
-    correctTunnelsAndBridges(nodeIndex, tunnelsAndBridges);
-    smoothRoutePaths(nodeIndex, routePaths);
+    correctRivers(nodeIndex, routes.rivers);
+    correctTunnelsAndBridges(nodeIndex, routes.tunnelsAndBridges);
+    smoothRoutePaths(nodeIndex, routes.routePaths, routes.routePathWeights);
 
     nodeIndex.clear();
+    routes.clear();
     _elevationIndex->process();
-
-    currentStart += maxPerLoop;
-    currentEnd += maxPerLoop;
   }
-  return correctedWayIds;
+  return bytes;
 }
 
 // _____________________________________________________________________________
 void CorrectElevation::correctRouteWaysInRanges(
-    const std::set<uint64_t>& correctedWayIds,
+    const IdBitmap& correctedWayIds,
     const uint64_t absoluteMax, const uint64_t maxPerLoop) const {
-  uint64_t currentStart = 0;
-  uint64_t currentEnd = maxPerLoop;
+  Phase phase("correctWays");
   const std::vector<RoutePaths> routePaths;
 
+  // The size of the next range follows from the bytes per node measured
+  // in the ranges before.
+  RangePlanner planner(rangeBudget(), BYTES_PER_NODE);
+  uint64_t currentStart = 0;
+  if (_resumeStage == CorrectionStage::WAYS) {
+    currentStart = _resumeStart;
+  }
   while (currentStart < absoluteMax) {
+    // An unlimited range size must not wrap around past absoluteMax.
+    const uint64_t currentEnd = currentStart +
+        std::min(planner.rangeSize(nodesPerWay(), maxPerLoop),
+                 absoluteMax - currentStart);
     auto routesFromWays =
         RoutesFromWays(_inFile, _osmStats, _elevationTag,
-                       currentStart, currentEnd);
+                       currentStart, currentEnd, _nodeStore.get());
     const auto routes = routesFromWays.getRoutesAndExcludeIds(correctedWayIds);
 
     // If there are no more routes to collect, we are done.
     if (routes.empty()) {
       break;
     }
-    // Make a set containing all node ids that are needed.
-    const std::set<uint64_t> nodeIds =
+    // Get the sorted ids of all nodes that are needed.
+    const NodeIds nodeIds =
         routesFromWays.requiredNodes(routes, routePaths);
+    phase.add("ranges", 1);
+    phase.add("routes", routes.size());
+    phase.add("nodes", nodeIds.size());
 
     // Build a node index with needed ids.
     NodeIndex nodeIndex = routesFromWays.buildNodeIndex(nodeIds);
+    const uint64_t bytes = routesByteSize(routes) +
+                           nodeIds.capacity() * sizeof(uint64_t) +
+                           nodeIndex.byteSize();
 
     // Only smoothing for route ways.
     smoothRoutePaths(nodeIndex, routes);
@@ -162,38 +335,115 @@ void CorrectElevation::correctRouteWaysInRanges(
     nodeIndex.clear();
     _elevationIndex->process();
 
-    currentStart += maxPerLoop;
-    currentEnd += maxPerLoop;
+    planner.measured(routesNodeCount(routes), bytes);
+    planner.setBudget(rangeBudget());
+    currentStart = currentEnd;
+    writeCheckpoint(CorrectionStage::WAYS, currentStart, correctedWayIds,
+                    phase);
+  }
+  phase.add("indexBytes", _elevationIndex->byteSize());
+}
+
+// _____________________________________________________________________________
+void CorrectElevation::writeCheckpoint(const CorrectionStage stage,
+                                       const uint64_t next,
+                                       const IdBitmap& correctedWayIds,
+                                       Phase& phase) const {
+  if (!_checkpoint->due()) {
+    return;
+  }
+  const double start = wallSeconds();
+  if (!_checkpoint->write(stage, next, correctedWayIds, *_elevationIndex)) {
+    // The run goes on, it just can't be resumed from here.
+    std::cerr << "Could not write the checkpoint next to " << _outFile;
+    std::cerr << std::endl;
+    return;
+  }
+  Metrics::get().addSeconds("checkpointSeconds", wallSeconds() - start);
+  phase.add("checkpoints", 1);
+}
+
+// _____________________________________________________________________________
+uint64_t CorrectElevation::rangeBudget() const {
+  if (_memoryLimit == 0) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  // The elevation index stays in memory during all ranges.
+  const uint64_t used = _elevationIndex->byteSize();
+  const uint64_t minBudget = _memoryLimit / 8;
+  return (_memoryLimit > used + minBudget) ? _memoryLimit - used : minBudget;
+}
+
+// _____________________________________________________________________________
+double CorrectElevation::nodesPerWay() const {
+  if (_routeStats.highwayWays == 0) {
+    return 1;
+  }
+  return static_cast<double>(_routeStats.highwayNodes) /
+         _routeStats.highwayWays;
+}
+
+// _____________________________________________________________________________
+void CorrectElevation::forEachRoute(
+    const uint64_t count,
+    const std::function<void(uint64_t, AverageElevationIndexSparse&)>& work)
+    const {
+  if (_threads == 1) {
+    for (uint64_t i = 0; i < count; ++i) {
+      work(i, *_elevationIndex);
+    }
+    return;
+  }
+  std::vector<std::unique_ptr<AverageElevationIndexSparse>> buffers;
+  for (uint16_t thread = 0; thread < _threads; ++thread) {
+    buffers.emplace_back(
+        std::make_unique<AverageElevationIndexSparse>(0, _osmStats.max));
+  }
+  parallelFor(count, _threads, [&](uint64_t i, uint16_t thread) {
+    work(i, *buffers[thread]);
+  });
+  for (const auto& buffer : buffers) {
+    _elevationIndex->append(*buffer);
   }
 }
 
 // _____________________________________________________________________________
 void CorrectElevation::correctRivers(NodeIndex& nodeIndex,
                                      std::vector<RoutePaths>& rivers) const {
-  for (const auto& river : rivers) {
+  // The rivers only read the node index.
+  const auto slots = nodeIndex.resolve(rivers);
+  forEachRoute(rivers.size(), [&](uint64_t i,
+                                  AverageElevationIndexSparse& index) {
+    const auto& river = rivers[i];
     std::vector<uint64_t> nodeCounts;
     for (const auto& subroute : river) {
       nodeCounts.emplace_back(subroute.size());
     }
-    CorrectRiver correctRiver(river, nodeCounts, nodeIndex, *_elevationIndex);
+    CorrectRiver correctRiver(river, slots[i], nodeCounts, nodeIndex, index);
     correctRiver.buildElevations();
     correctRiver.buildRiverNodes();
     correctRiver.correctDownstreamElevation();
     correctRiver.updateElevationIndex();
-  }
+  });
 }
 
 // _____________________________________________________________________________
 void CorrectElevation::correctTunnelsAndBridges(
     NodeIndex& nodeIndex,
     std::vector<RoutePaths>& tunnelsAndBridges) const {
-  for (const auto& tunnelOrBridge : tunnelsAndBridges) {
+  // Tunnels/bridges update the elevations in the node index, which are read
+  // by the following tunnels/bridges and the smoothing. So they are
+  // corrected one after the other, before any smoothing starts.
+  const auto slots = nodeIndex.resolve(tunnelsAndBridges);
+  for (size_t i = 0; i < tunnelsAndBridges.size(); ++i) {
+    const auto& tunnelOrBridge = tunnelsAndBridges[i];
     std::vector<uint64_t> nodeCounts;
     for (const auto& subroute : tunnelOrBridge) {
       nodeCounts.emplace_back(subroute.size());
     }
-    CorrectTunnelOrBridge correctTunnelOrBridge(tunnelOrBridge, nodeCounts,
-                                                nodeIndex, *_elevationIndex);
+    CorrectTunnelOrBridge correctTunnelOrBridge(tunnelOrBridge, slots[i],
+                                                nodeCounts, nodeIndex,
+                                                *_elevationIndex);
     correctTunnelOrBridge.buildCoordsAndElevations();
     correctTunnelOrBridge.createElevationPlane();
     correctTunnelOrBridge.estimateUnknownSection();
@@ -202,22 +452,31 @@ void CorrectElevation::correctTunnelsAndBridges(
 
 // _____________________________________________________________________________
 void CorrectElevation::smoothRoutePaths(NodeIndex& nodeIndex,
-    const std::vector<RoutePaths>& routePaths) const {
+    const std::vector<RoutePaths>& routePaths,
+    const std::vector<uint16_t>& weights) const {
   // Smooth all route paths in form of all found route ways.
-  for (const auto& routePath : routePaths) {
-    if (routePath.size() == 0) { continue; }
+  const auto slots = nodeIndex.resolve(routePaths);
+  forEachRoute(routePaths.size(), [&](uint64_t i,
+                                      AverageElevationIndexSparse& index) {
+    const auto& routePath = routePaths[i];
+    if (routePath.size() == 0) { return; }
     const auto nodeCounts = std::vector<size_t> { routePath[0].size() };
-    SmoothRoute smooth(routePath, nodeCounts, nodeIndex, *_elevationIndex);
+    SmoothRoute smooth(routePath, slots[i], nodeCounts, nodeIndex, index);
     smooth.buildCoordsAndElevations();
     smooth.buildDistances();
-    smooth.smoothMovingAverage(60);
-  }
+    smooth.smoothMovingAverage(60, weights.empty() ? 1 : weights[i]);
+  });
 }
 
 // ____________________________________________________________________________
 void CorrectElevation::writeOutputOSM() const {
+  Phase phase("write");
   OsmAddElevationWriter writer(_inFile, _outFile,
                                _elevationIndex.get(),
                                _elevationTag, true);
   writer.write();
+  _checkpoint->remove();
+  phase.add("nodes", _osmStats.nodeCount);
+  phase.add("bytesRead", fileBytes(_inFile));
+  phase.add("bytesWritten", fileBytes(_outFile));
 }
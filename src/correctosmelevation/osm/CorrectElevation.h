@@ -4,35 +4,64 @@
 #ifndef SRC_CORRECTOSMELEVATION_OSM_CORRECTELEVATION_H_
 #define SRC_CORRECTOSMELEVATION_OSM_CORRECTELEVATION_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
-#include <set>
 #include <vector>
+#include "util/index/IdBitmap.h"
 #include "util/index/NodeIndex.h"
+#include "util/index/NodeStore.h"
 #include "util/index/AverageElevationIndexSparse.h"
 #include "util/osm/OsmStats.h"
+#include "util/metrics/Metrics.h"
+#include "correctosmelevation/osm/Checkpoint.h"
+#include "correctosmelevation/osm/RouteStatsHandler.h"
 
 namespace correctosmelevation {
 namespace osm {
 
+using util::index::IdBitmap;
 using util::osm::OsmStats;
 using util::index::NodeIndex;
+using util::index::NodeStore;
 using util::index::AverageElevationIndexSparse;
+using util::metrics::Phase;
+using correctosmelevation::osm::RouteStats;
+using correctosmelevation::osm::Checkpoint;
+using correctosmelevation::osm::CorrectionStage;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
 /*
  * Work off all route relations and route ways in ranges.
+ * Within a range, the routes are corrected on several threads. Each
+ * thread writes into its own buffer, which are merged into the average
+ * elevation index at the end of the range.
+ * With a memory limit, the ranges are sized such that their routes and
+ * nodes fit into the memory left by the average elevation index.
+ * At range boundaries, a checkpoint is written every now and then, from
+ * which a killed run can be resumed.
  */
 class CorrectElevation {
  public:
   CorrectElevation(const std::string inFile, const std::string outFile,
                    const std::string elevationTag, const uint64_t waysPerRange,
-                   const uint64_t relationsPerRange);
+                   const uint64_t relationsPerRange,
+                   const uint16_t threads = 1,
+                   const uint64_t memoryLimit = 0);
 
-  // Collect data about the input file and
+  // Collect data about the input file, store its nodes and
   // initialize the average elevation index.
   void initialize();
 
+  // Continue from the checkpoint of an earlier run after initialize,
+  // skipping all ranges it finished. Return false if there is no
+  // checkpoint for the input file.
+  bool resume();
+
+  // Write checkpoints at most every given seconds, 0 for every range.
+  void setCheckpointInterval(const double seconds);
+
   // Access to the average elevation index for tests.
   int16_t getElevation(const uint64_t id) const;
 
@@ -40,21 +69,51 @@ class CorrectElevation {
   // all remaining route ways in ranges.
   void correctRoutes() const;
 
-  // Collect all route relations in ranges. Return a set of all
-  // way ids that were used in the route relations.
-  std::set<uint64_t> correctRouteRelationsInRanges(
+  // Collect all route relations in ranges. The relations, ways and nodes
+  // are read once for all ranges that fit into memory together. Return a
+  // set of all way ids that were used in the route relations.
+  IdBitmap correctRouteRelationsInRanges(
       const uint64_t absoluteMax, const uint64_t maxPerLoop) const;
 
   // Collect all way relations in ranges. Exclude ways that
   // were already corrected in route relations.
-  void correctRouteWaysInRanges(const std::set<uint64_t>& correctedWayIds,
+  void correctRouteWaysInRanges(const IdBitmap& correctedWayIds,
                                 const uint64_t absoluteMax,
                                 const uint64_t maxPerLoop) const;
 
-  // Write the updated elevation data to the output OSM file.
+  // Write the updated elevation data to the output OSM file and remove
+  // the checkpoint.
   void writeOutputOSM() const;
 
  private:
+  // Collect and correct the route relations [passStart, passEnd) in
+  // ranges of maxPerLoop relations, with a single pass over the relations,
+  // ways and nodes. Return the bytes of the collected routes and nodes.
+  uint64_t correctRelationPass(const uint64_t passStart,
+                               const uint64_t passEnd,
+                               const uint64_t maxPerLoop,
+                               IdBitmap& correctedWayIds,
+                               Phase& phase) const;
+
+  // Write a checkpoint before the range next of the stage, if it is due.
+  // A run shorter than the interval writes none.
+  void writeCheckpoint(const CorrectionStage stage, const uint64_t next,
+                       const IdBitmap& correctedWayIds, Phase& phase) const;
+
+  // The bytes the routes and nodes of a range may take, unlimited
+  // without a memory limit.
+  uint64_t rangeBudget() const;
+
+  // The average number of nodes of a highway.
+  double nodesPerWay() const;
+
+  // Call work for each of count routes on the threads, with the index to
+  // store the results of the thread in.
+  void forEachRoute(
+      const uint64_t count,
+      const std::function<void(uint64_t, AverageElevationIndexSparse&)>& work)
+      const;
+
   // Procedure to correct all found rivers.
   void correctRivers(NodeIndex& nodeIndex,
                      std::vector<RoutePaths>& rivers) const;
@@ -64,9 +123,11 @@ class CorrectElevation {
       NodeIndex& nodeIndex,
       std::vector<RoutePaths>& tunnelsAndBridges) const;
 
-  // Procedure to smooth all found route paths.
+  // Procedure to smooth all found route paths. Each path counts as often
+  // as its weight says, once if there are no weights.
   void smoothRoutePaths(NodeIndex& nodeIndex,
-                        const std::vector<RoutePaths>& routePaths) const;
+                        const std::vector<RoutePaths>& routePaths,
+                        const std::vector<uint16_t>& weights = {}) const;
 
   // The average elevation index to store the corrected elevations.
   std::unique_ptr<AverageElevationIndexSparse> _elevationIndex;
@@ -74,12 +135,29 @@ class CorrectElevation {
   // Statistics about the input OSM file.
   OsmStats _osmStats;
 
+  // The sizes of the routes in the input OSM file.
+  RouteStats _routeStats;
+
+  // The location and elevation of all nodes of the input OSM file.
+  std::unique_ptr<NodeStore> _nodeStore;
+
+  // The checkpoint next to the output file.
+  std::unique_ptr<Checkpoint> _checkpoint;
+
+  // Where to continue after resume, from the start by default.
+  CorrectionStage _resumeStage;
+  uint64_t _resumeStart;
+  IdBitmap _resumeWayIds;
+
   // Input arguments.
   const std::string _inFile;
   const std::string _outFile;
   const std::string _elevationTag;
   const uint64_t _waysPerRange;
   const uint64_t _relationsPerRange;
+  const uint16_t _threads;
+  // In bytes, 0 for no limit.
+  const uint64_t _memoryLimit;
 };
 
 }  // namespace osm
@@ -4,16 +4,17 @@
 #include <cstdint>
 #include <vector>
 #include <utility>
-#include <osmium/relations/members_database.hpp>
 #include <osmium/osm/way.hpp>
+#include "correctosmelevation/osm/RelationWays.h"
 #include "correctosmelevation/osm/FindTunnelsAndBridges.h"
 
 using correctosmelevation::osm::FindTunnelsAndBridges;
+using correctosmelevation::osm::MemberWay;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
 // ____________________________________________________________________________
 FindTunnelsAndBridges::FindTunnelsAndBridges(
-    const MembersDatabase<osmium::Way>& wayDatabase,
+    const RelationWays& wayDatabase,
     const std::vector<std::pair<uint64_t, uint64_t>>& pathWays) :
     _wayDatabase(wayDatabase), _pathWays(pathWays) {}
 
@@ -23,10 +24,7 @@ std::vector<RoutePaths> FindTunnelsAndBridges::getTunnelsAndBridges() {
   // in front of a tunnel or bridge.
   size_t current = 1;
   while (current < _pathWays.size()) {
-    const auto& tags = _wayDatabase.get(_pathWays[current].second)->tags();
-    const bool tunnelOrBridge = tags.has_key("tunnel") ||
-                                tags.has_key("bridge");
-    if (tunnelOrBridge) {
+    if (tunnelOrBridge(current)) {
       current = newTunnelOrBridge(current);
     }
     ++current;
@@ -53,12 +51,7 @@ size_t FindTunnelsAndBridges::newTunnelOrBridge(const size_t start) {
   // The position of the current way from the start of this tunnel/bridge.
   size_t posInTunnelOrBridge = 0;
   while (currentWayPos < _pathWays.size()) {
-    const auto& tags =
-        _wayDatabase.get(_pathWays[currentWayPos].second)->tags();
-
-    const bool tunnelOrBridge = tags.has_key("tunnel") ||
-                                tags.has_key("bridge");
-    if (!tunnelOrBridge) { break; }
+    if (!tunnelOrBridge(currentWayPos)) { break; }
     addTunnelOrBridgeWay(posInTunnelOrBridge, currentWayPos);
     ++posInTunnelOrBridge;
     ++currentWayPos;
@@ -78,29 +71,34 @@ size_t FindTunnelsAndBridges::newTunnelOrBridge(const size_t start) {
   return currentWayPos;
 }
 
+// ____________________________________________________________________________
+bool FindTunnelsAndBridges::tunnelOrBridge(const size_t way) const {
+  return _wayDatabase.way(_pathWays[way].second)->has(MemberWay::TUNNEL |
+                                                      MemberWay::BRIDGE);
+}
+
 // ____________________________________________________________________________
 bool FindTunnelsAndBridges::embankmentOrIncline(const size_t way) const {
-  const auto& tags = _wayDatabase.get(_pathWays[way].second)->tags();
-  const bool embankment = tags.has_key("embankment");
-  const bool incline = tags.has_key("incline");
-  return embankment || incline;
+  return _wayDatabase.way(_pathWays[way].second)->has(MemberWay::EMBANKMENT |
+                                                      MemberWay::INCLINE);
 }
 
 // ____________________________________________________________________________
 void FindTunnelsAndBridges::addTunnelOrBridgeWay(
     const size_t posInTunnelOrBridge, const size_t wayPos) {
-  const auto& nodes = _wayDatabase.get(_pathWays[wayPos].second)->nodes();
+  const MemberWay* way = _wayDatabase.way(_pathWays[wayPos].second);
+  const auto& nodes = _wayDatabase.get(*way).nodes();
 
   // Add the start-node if first way.
   if (posInTunnelOrBridge == 0) {
-    if (_pathWays[wayPos].first == nodes.front()) {
-      _tunnelsAndBridges.back()[1].emplace_back(nodes.back().ref());
+    if (_pathWays[wayPos].first == way->firstNode) {
+      _tunnelsAndBridges.back()[1].emplace_back(way->lastNode);
     } else {
-      _tunnelsAndBridges.back()[1].emplace_back(nodes.front().ref());
+      _tunnelsAndBridges.back()[1].emplace_back(way->firstNode);
     }
   }
   // Check if the way is needed forward or backward.
-  if (_pathWays[wayPos].first == nodes.front()) {
+  if (_pathWays[wayPos].first == way->firstNode) {
     for (auto rit = nodes.crbegin() + 1; rit != nodes.crend(); ++rit) {
       _tunnelsAndBridges.back()[1].emplace_back(rit->ref());
     }
@@ -113,10 +111,11 @@ void FindTunnelsAndBridges::addTunnelOrBridgeWay(
 
 // ____________________________________________________________________________
 void FindTunnelsAndBridges::addWay(const bool before, const size_t wayPos) {
-  const auto& nodes = _wayDatabase.get(_pathWays[wayPos].second)->nodes();
+  const MemberWay* way = _wayDatabase.way(_pathWays[wayPos].second);
+  const auto& nodes = _wayDatabase.get(*way).nodes();
 
   // The way in front of and after should point towards the tunnel/bridge.
-  if (_pathWays[wayPos].first == nodes.front()) {
+  if (_pathWays[wayPos].first == way->firstNode) {
     if (before) {
       for (auto rit = nodes.cbegin(); rit != nodes.cend(); ++rit) {
         _tunnelsAndBridges.back()[0].emplace_back(rit->ref());
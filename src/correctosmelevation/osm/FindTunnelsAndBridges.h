@@ -7,23 +7,22 @@
 #include <cstdint>
 #include <vector>
 #include <utility>
-#include <osmium/relations/members_database.hpp>
 #include <osmium/osm/way.hpp>
+#include "correctosmelevation/osm/RelationWays.h"
 
 namespace correctosmelevation {
 namespace osm {
 
-using osmium::relations::MembersDatabase;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
 /*
- * Given a path represented by ways, look at the tags
- * of the ways and find valid tunnels and bridges.
+ * Given a path represented by ways, look at the flags taken
+ * from the tags of the ways and find valid tunnels and bridges.
  */
 class FindTunnelsAndBridges {
  public:
   FindTunnelsAndBridges(
-      const MembersDatabase<osmium::Way>& wayDatabase,
+      const RelationWays& wayDatabase,
       const std::vector<std::pair<uint64_t, uint64_t>>& pathWays);
 
   // Iterate over each way and find and return
@@ -39,6 +38,9 @@ class FindTunnelsAndBridges {
   //  route path after]
   size_t newTunnelOrBridge(const size_t start);
 
+  // Check if a way has a key 'tunnel' or 'bridge'.
+  bool tunnelOrBridge(const size_t way) const;
+
   // Check if a way has a key 'embankment' or 'incline'.
   bool embankmentOrIncline(const size_t way) const;
 
@@ -49,9 +51,9 @@ class FindTunnelsAndBridges {
   // Convert a way before or after a tunnel/bridge to a route path.
   void addWay(const bool before, const size_t wayPos);
 
-  // Database that maps way ids to their data, i.e. the associated
-  // nodes and tags. Given by osmium.
-  const MembersDatabase<osmium::Way>& _wayDatabase;
+  // Maps the ids of the member ways to their data, i.e. the associated
+  // nodes and tags. Copied from osmium.
+  const RelationWays& _wayDatabase;
 
   // The path in a route given by ways.
   const std::vector<std::pair<uint64_t, uint64_t>>& _pathWays;
@@ -1,6 +1,8 @@
 // Copyright 2022, Urs Spiegelhalter
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <osmium/osm/node.hpp>
 #include "global/Constants.h"
@@ -11,21 +13,33 @@
 using global::INVALID_ELEV;
 using correctosmelevation::osm::OsmNodesHandler;
 using util::index::NodeIndex;
+using util::index::NodeIds;
 using parser::OsmHandler;
 
 // ____________________________________________________________________________
 OsmNodesHandler::OsmNodesHandler(NodeIndex& nodeIndex,
                                 const std::string& elevationTag,
-                                const std::set<uint64_t>& nodeIds) :
+                                const NodeIds& nodeIds) :
                                 _nodeIndex(nodeIndex),
                                 _elevationTag(elevationTag),
-                                _nodeIds(nodeIds) {}
+                                _nodeIds(nodeIds),
+                                _next(_nodeIds.begin()),
+                                _lastId(0) {}
 
 // ____________________________________________________________________________
 void OsmNodesHandler::node(const osmium::Node& node) {
   ++_count;  // For progess bar.
-  const osmium::TagList& tags = node.tags();
-  if (_nodeIds.contains(node.id())) {
+  const uint64_t id = node.id();
+  if (id < _lastId) {
+    // Not sorted by id, search the position again.
+    _next = std::lower_bound(_nodeIds.begin(), _nodeIds.end(), id);
+  }
+  _lastId = id;
+  while (_next != _nodeIds.end() && *_next < id) {
+    ++_next;
+  }
+  if (_next != _nodeIds.end() && *_next == id) {
+    const osmium::TagList& tags = node.tags();
     const char* elevation = tags[_elevationTag.c_str()];
     const int16_t elevationInt = (elevation) ? atoi(elevation) : INVALID_ELEV;
     _nodeIndex.setNode(node.id(), node.location().lon(),
@@ -4,26 +4,30 @@
 #ifndef SRC_CORRECTOSMELEVATION_OSM_OSMNODESHANDLER_H_
 #define SRC_CORRECTOSMELEVATION_OSM_OSMNODESHANDLER_H_
 
-#include <set>
 #include <string>
+#include <cstdint>
 #include "parser/OsmHandler.h"
 #include "util/index/NodeIndex.h"
+#include "util/index/NodeIds.h"
 
 namespace correctosmelevation {
 namespace osm {
 
 using util::index::NodeIndex;
+using util::index::NodeIds;
 using parser::OsmHandler;
 
 /*
- * Osm handler to build a node index given a set of
- * needed ids.
+ * Osm handler to build a node index given the sorted
+ * needed ids. As the nodes of an OSM file are sorted by id, too,
+ * the needed ids are merged with the nodes by a single advancing
+ * position.
  */
 class OsmNodesHandler : public OsmHandler {
  public:
   explicit OsmNodesHandler(NodeIndex& nodeIndex,
                            const std::string& elevationTag,
-                           const std::set<uint64_t>& nodeIds);
+                           const NodeIds& nodeIds);
 
   // Gets called for each node.
   void node(const osmium::Node&) override;
@@ -41,8 +45,14 @@ class OsmNodesHandler : public OsmHandler {
   // The elevation tag to look out for.
   const std::string& _elevationTag;
 
-  // Contains the node ids that are needed.
-  const std::set<uint64_t>& _nodeIds;
+  // Contains the node ids that are needed, sorted.
+  const NodeIds& _nodeIds;
+
+  // Position of the next needed id not less than the last node id.
+  NodeIds::const_iterator _next;
+
+  // The id of the last node, to notice unsorted files.
+  uint64_t _lastId;
 };
 
 }  // namespace osm
@@ -5,29 +5,52 @@
 #include <unordered_map>
 #include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <exception>
 #include <utility>
 #include <osmium/io/any_input.hpp>
 #include <osmium/relations/relations_manager.hpp>
+#include "util/index/IdBitmap.h"
 #include "util/osm/Way.h"
+#include "correctosmelevation/osm/RelationRoutes.h"
+#include "correctosmelevation/osm/RelationWays.h"
 #include "correctosmelevation/osm/ProcessRouteRelation.h"
 #include "correctosmelevation/osm/OsmRelationsManager.h"
 
+using util::index::IdBitmap;
 using util::osm::Way;
 using correctosmelevation::osm::ProcessRouteRelation;
 using correctosmelevation::osm::OsmRelationsManager;
+using correctosmelevation::osm::RelationRoutes;
+using correctosmelevation::osm::RelationWays;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
 // ____________________________________________________________________________
 OsmRelationsManager::OsmRelationsManager(
-    std::set<u_int64_t>& correctedWayIds,
-    std::vector<RoutePaths>& routePaths,
-    std::vector<RoutePaths>& rivers,
-    std::vector<RoutePaths>& tunnelsAndBridges,
-    const uint64_t rangeStart, const uint64_t rangeEnd) :
-    _correctedWayIds(correctedWayIds), _routePaths(routePaths),
-    _rivers(rivers), _tunnelsAndBridges(tunnelsAndBridges),
-    _rangeStart(rangeStart), _rangeEnd(rangeEnd) {
+    IdBitmap& correctedWayIds,
+    std::vector<RelationRoutes>& ranges,
+    const uint64_t rangeStart, const uint64_t rangeEnd,
+    const uint64_t rangeSize, const uint16_t threads) :
+    _correctedWayIds(correctedWayIds), _ranges(ranges),
+    _rangeStart(rangeStart), _rangeEnd(rangeEnd),
+    _rangeSize(std::max<uint64_t>(rangeSize, 1)) {
   _count = 0;
+  if (threads > 1) {
+    // A few relations per worker keep them busy while the ways are read.
+    _maxQueued = 4 * threads;
+    _results.resize(threads);
+    _workers.reserve(threads);
+    for (uint16_t worker = 0; worker < threads; ++worker) {
+      _workers.emplace_back(&OsmRelationsManager::work, this, worker);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+OsmRelationsManager::~OsmRelationsManager() {
+  stopWorkers();
 }
 
 // ____________________________________________________________________________
@@ -40,36 +63,156 @@ bool OsmRelationsManager::new_relation(const osmium::Relation& relation)
   if (needed) {
     if (!(_count >= _rangeStart && _count < _rangeEnd)) {
       needed = false;
+    } else {
+      const size_t range = (_count - _rangeStart) / _rangeSize;
+      if (_ranges.size() <= range) {
+        _ranges.resize(range + 1);
+      }
+      _relationRanges[relation.id()] = range;
     }
     ++_count;
   }
   return needed;
 }
 
+// ____________________________________________________________________________
+bool OsmRelationsManager::isRouteMember(const osmium::RelationMember& member) {
+  bool memberIsWay = member.type() == osmium::item_type::way;
+  bool link = !std::strcmp(member.role(), "link");
+  bool platform = !std::strcmp(member.role(), "platform");
+  return memberIsWay && !link && !platform;
+}
+
 // ____________________________________________________________________________
 bool OsmRelationsManager::new_member(const osmium::Relation& relation,
                                      const osmium::RelationMember& member,
                                      std::size_t n) noexcept {
   (void)relation;
   (void)n;
-  bool memberIsWay = member.type() == osmium::item_type::way;
-  bool link = !std::strcmp(member.role(), "link");
-  bool platform = !std::strcmp(member.role(), "platform");
-  return memberIsWay && !link && !platform;
+  return isRouteMember(member);
 }
 
 // ____________________________________________________________________________
 void OsmRelationsManager::complete_relation(const osmium::Relation& relation) {
+  const auto range = _relationRanges.find(relation.id());
+  if (range == _relationRanges.end()) {
+    return;
+  }
+  // Osmium removes the member ways once the relation is complete.
+  Task task{ _completed++, range->second,
+             std::make_unique<RelationWays>(this->member_ways_database(),
+                                            relation) };
+  _relationRanges.erase(range);
+  if (_workers.empty()) {
+    Result result = process(task);
+    merge(result);
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _taskTaken.wait(lock, [this] { return _tasks.size() < _maxQueued; });
+    _tasks.push_back(std::move(task));
+  }
+  _taskAdded.notify_one();
+}
+
+// ____________________________________________________________________________
+void OsmRelationsManager::finish() {
+  stopWorkers();
+  if (_error) {
+    std::rethrow_exception(_error);
+  }
+  // The order the relations were completed in, as with a single thread.
+  std::vector<Result> results;
+  for (auto& workerResults : _results) {
+    results.insert(results.end(),
+                   std::make_move_iterator(workerResults.begin()),
+                   std::make_move_iterator(workerResults.end()));
+    std::vector<Result>().swap(workerResults);
+  }
+  std::sort(results.begin(), results.end(),
+            [](const Result& a, const Result& b) {
+              return a.sequence < b.sequence;
+            });
+  for (auto& result : results) {
+    merge(result);
+  }
+}
+
+// ____________________________________________________________________________
+OsmRelationsManager::Result OsmRelationsManager::process(const Task& task) {
+  Result result{ task.sequence, task.range, RelationRoutes(), {} };
+  const osmium::Relation& relation = task.relationWays->relation();
   if (relation.tags().has_tag("type", "route")) {
-    route(relation);
+    route(*task.relationWays, result.routes, result.usedWayIds);
   } else if (relation.tags().has_tag("waterway", "river")) {
-    waterway(relation);
+    waterway(*task.relationWays, result.routes);
+  }
+  return result;
+}
+
+// ____________________________________________________________________________
+void OsmRelationsManager::merge(Result& result) {
+  RelationRoutes& routes = _ranges[result.range];
+  routes.routePaths.insert(
+      routes.routePaths.end(),
+      std::make_move_iterator(result.routes.routePaths.begin()),
+      std::make_move_iterator(result.routes.routePaths.end()));
+  routes.rivers.insert(routes.rivers.end(),
+                       std::make_move_iterator(result.routes.rivers.begin()),
+                       std::make_move_iterator(result.routes.rivers.end()));
+  routes.tunnelsAndBridges.insert(
+      routes.tunnelsAndBridges.end(),
+      std::make_move_iterator(result.routes.tunnelsAndBridges.begin()),
+      std::make_move_iterator(result.routes.tunnelsAndBridges.end()));
+  _correctedWayIds.insert(result.usedWayIds.begin(),
+                          result.usedWayIds.end());
+  result.routes.clear();
+}
+
+// ____________________________________________________________________________
+void OsmRelationsManager::work(const uint16_t worker) {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _taskAdded.wait(lock, [this] { return _closed || !_tasks.empty(); });
+      if (_tasks.empty()) {
+        return;
+      }
+      task = std::move(_tasks.front());
+      _tasks.pop_front();
+    }
+    _taskTaken.notify_one();
+    try {
+      _results[worker].push_back(process(task));
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_error) {
+        _error = std::current_exception();
+      }
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void OsmRelationsManager::stopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closed = true;
+  }
+  _taskAdded.notify_all();
+  for (auto& worker : _workers) {
+    worker.join();
   }
+  _workers.clear();
 }
 
 // ____________________________________________________________________________
-void OsmRelationsManager::route(const osmium::Relation& relation) {
-  ProcessRouteRelation routeRelation(this->member_ways_database(), relation);
+void OsmRelationsManager::route(const RelationWays& relationWays,
+                                RelationRoutes& routes,
+                                std::vector<uint64_t>& usedWayIds) {
+  ProcessRouteRelation routeRelation(relationWays);
   routeRelation.categorizeWays();
   routeRelation.buildRouteGraph();
 
@@ -77,24 +220,27 @@ void OsmRelationsManager::route(const osmium::Relation& relation) {
   const uint64_t endNode = routeRelation.getRouteEndNodeId();
 
   const auto routePaths = routeRelation.getRoutePaths(startNode, endNode);
-  _routePaths.insert(_routePaths.end(),
-                     std::make_move_iterator(routePaths.begin()),
-                     std::make_move_iterator(routePaths.end()));
+  routes.routePaths.insert(routes.routePaths.end(),
+                           std::make_move_iterator(routePaths.begin()),
+                           std::make_move_iterator(routePaths.end()));
 
   // Update the used way ids.
   const auto correctedWayIds = routeRelation.getUsedWaysIds();
-  _correctedWayIds.insert(correctedWayIds.begin(), correctedWayIds.end());
+  usedWayIds.insert(usedWayIds.end(), correctedWayIds.begin(),
+                    correctedWayIds.end());
 
   // Get tunnels and bridges found in the route paths.
   const auto tunnelsAndBridges = routeRelation.getTunnelsAndBridges();
-  _tunnelsAndBridges.insert(_tunnelsAndBridges.end(),
-                            std::make_move_iterator(tunnelsAndBridges.begin()),
-                            std::make_move_iterator(tunnelsAndBridges.end()));
+  routes.tunnelsAndBridges.insert(
+      routes.tunnelsAndBridges.end(),
+      std::make_move_iterator(tunnelsAndBridges.begin()),
+      std::make_move_iterator(tunnelsAndBridges.end()));
 }
 
 // ____________________________________________________________________________
-void OsmRelationsManager::waterway(const osmium::Relation& relation) {
-  ProcessRouteRelation routeRelation(this->member_ways_database(), relation);
+void OsmRelationsManager::waterway(const RelationWays& relationWays,
+                                   RelationRoutes& routes) {
+  ProcessRouteRelation routeRelation(relationWays);
   routeRelation.categorizeWays();
   routeRelation.buildRouteGraph();
   RoutePaths river;
@@ -118,5 +264,5 @@ void OsmRelationsManager::waterway(const osmium::Relation& relation) {
                std::make_move_iterator(sideStreams.begin()),
                std::make_move_iterator(sideStreams.end()));
 
-  _rivers.emplace_back(river);
+  routes.rivers.emplace_back(std::move(river));
 }
@@ -5,58 +5,116 @@
 #define SRC_CORRECTOSMELEVATION_OSM_OSMRELATIONSMANAGER_H_
 
 #include <vector>
-#include <set>
+#include <deque>
 #include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <exception>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <unordered_map>
 #include <osmium/relations/relations_manager.hpp>
+#include "util/index/IdBitmap.h"
+#include "correctosmelevation/osm/RelationRoutes.h"
+#include "correctosmelevation/osm/RelationWays.h"
 
 namespace correctosmelevation {
 namespace osm {
 
+using util::index::IdBitmap;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
 /*
  * Collect and process all route relations in a specified routes range.
  * Categorize into route paths, tunnels/bridges, and rivers.
+ * The routes range is split into smaller ranges of rangeSize relations
+ * each, such that all ranges are collected with a single pass over the
+ * relations and a single pass over the ways.
+ * With more than one thread, the completed relations are copied together
+ * with their member ways and processed by a pool of workers, so reading
+ * the ways does not wait for them. Each worker keeps its own results,
+ * which are merged in the order the relations were completed by finish(),
+ * so the results are the same for any number of threads.
  */
 class OsmRelationsManager : public osmium::relations::RelationsManager<OsmRelationsManager, true, true, true> {  // NOLINT
  public:
-  OsmRelationsManager(std::set<u_int64_t>& correctedWayIds,
-                      std::vector<RoutePaths>& routePaths,
-                      std::vector<RoutePaths>& rivers,
-                      std::vector<RoutePaths>& tunnelsAndBridges,
-                      const uint64_t rangeStart, const uint64_t rangeEnd);
+  OsmRelationsManager(IdBitmap& correctedWayIds,
+                      std::vector<RelationRoutes>& ranges,
+                      const uint64_t rangeStart, const uint64_t rangeEnd,
+                      const uint64_t rangeSize, const uint16_t threads = 1);
+
+  // Stop the workers, if finish() was not called.
+  ~OsmRelationsManager();
 
   // Specify which relations to take.
   // This includes relations with tag "type=route" and "waterway=river".
-  // Also, the relations must be the specified routes range.
+  // Also, the relations must be the specified routes range. Assign the
+  // relation to the smaller range it belongs to.
   bool new_relation(const osmium::Relation& relation) noexcept;
 
+  // Whether the member is one of the ways making up the route.
+  static bool isRouteMember(const osmium::RelationMember& member);
+
   // Specify which members of a relation to take.
   bool new_member(const osmium::Relation& relation,
                   const osmium::RelationMember& member,
                   std::size_t n) noexcept;
 
-  // All data of a relation is available. Invoke processing.
+  // All data of a relation is available. Invoke processing, or hand it to
+  // the workers.
   void complete_relation(const osmium::Relation& relation);
 
-  // Process a route relations.
-  void route(const osmium::Relation& relation);
+  // Wait for the workers to process all completed relations and merge
+  // their results into the ranges. Rethrow the first exception of a
+  // worker. Has to be called after the ways were read.
+  void finish();
+
+  // Process a route relation. Add the used way ids to usedWayIds.
+  static void route(const RelationWays& relationWays, RelationRoutes& routes,
+                    std::vector<uint64_t>& usedWayIds);
 
   // Process a river.
-  void waterway(const osmium::Relation& relation);
+  static void waterway(const RelationWays& relationWays,
+                       RelationRoutes& routes);
 
  private:
-  // The ids of used ways in the route relations.
-  std::set<uint64_t>& _correctedWayIds;
+  // A completed relation to process.
+  struct Task {
+    // The number of relations completed before.
+    uint64_t sequence;
+    size_t range;
+    std::unique_ptr<RelationWays> relationWays;
+  };
+
+  // The routes of a processed relation.
+  struct Result {
+    uint64_t sequence;
+    size_t range;
+    RelationRoutes routes;
+    std::vector<uint64_t> usedWayIds;
+  };
+
+  // Process the relation of the task.
+  static Result process(const Task& task);
+
+  // Add the result to its range and the used way ids.
+  void merge(Result& result);
+
+  // Process tasks until the queue is closed and empty.
+  void work(const uint16_t worker);
+
+  // Close the queue and wait for the workers.
+  void stopWorkers();
 
-  // All route paths that were found.
-  std::vector<RoutePaths>& _routePaths;
+  // The ids of used ways in the route relations.
+  IdBitmap& _correctedWayIds;
 
-  // All rivers that were found.
-  std::vector<RoutePaths>& _rivers;
+  // All route paths, rivers and tunnels/bridges that were found,
+  // for each smaller range.
+  std::vector<RelationRoutes>& _ranges;
 
-  // All tunnels/bridges that were found.
-  std::vector<RoutePaths>& _tunnelsAndBridges;
+  // The smaller range of each taken relation.
+  std::unordered_map<uint64_t, size_t> _relationRanges;
 
   // The start of the routes range.
   const uint64_t _rangeStart;
@@ -64,8 +122,32 @@ class OsmRelationsManager : public osmium::relations::RelationsManager<OsmRelati
   // The end of the routes range.
   const uint64_t _rangeEnd;
 
+  // The number of relations in each smaller range.
+  const uint64_t _rangeSize;
+
   // Counter to keep track of the routes range.
   uint64_t _count;
+
+  // The number of relations completed so far.
+  uint64_t _completed = 0;
+
+  // The worker threads, none with a single thread.
+  std::vector<std::thread> _workers;
+
+  // The results of each worker.
+  std::vector<std::vector<Result>> _results;
+
+  // The completed relations not yet taken by a worker, at most
+  // _maxQueued, such that the copies don't pile up.
+  std::deque<Task> _tasks;
+  size_t _maxQueued = 0;
+  bool _closed = false;
+  std::mutex _mutex;
+  std::condition_variable _taskAdded;
+  std::condition_variable _taskTaken;
+
+  // The first exception thrown by a worker.
+  std::exception_ptr _error = nullptr;
 };
 
 }  // namespace osm
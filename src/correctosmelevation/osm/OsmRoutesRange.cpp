@@ -1,18 +1,24 @@
 // Copyright 2022, Urs Spiegelhalter
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
-#include <set>
 #include <vector>
 #include <string>
 #include <cstdint>
+#include "util/index/IdBitmap.h"
 #include "util/index/NodeIndex.h"
+#include "util/index/NodeIds.h"
+#include "util/index/NodeStore.h"
 #include "util/osm/OsmStats.h"
 #include "parser/NodeParser.h"
 #include "correctosmelevation/osm/OsmNodesHandler.h"
 #include "correctosmelevation/osm/OsmRoutesRange.h"
 
+using util::index::IdBitmap;
 using correctosmelevation::osm::OsmRoutesRange;
 using util::index::NodeIndex;
+using util::index::NodeIds;
+using util::index::NodeStore;
+using util::index::sortUnique;
 using util::osm::OsmStats;
 using correctosmelevation::osm::OsmNodesHandler;
 using parser::NodeParser;
@@ -23,15 +29,17 @@ OsmRoutesRange::OsmRoutesRange(const std::string& osmFile,
                                const OsmStats& osmStats,
                                const std::string& elevationTag,
                                const uint64_t rangeStart,
-                               const uint64_t rangeEnd) :
+                               const uint64_t rangeEnd,
+                               const NodeStore* nodeStore) :
                                _osmFile(osmFile), _osmStats(osmStats),
                                _elevationTags(elevationTag),
                                _rangeStart(rangeStart),
-                               _rangeEnd(rangeEnd) {}
+                               _rangeEnd(rangeEnd),
+                               _nodeStore(nodeStore) {}
 
 // _____________________________________________________________________________
 void OsmRoutesRange::getRoutesAndIds(
-    std::set<uint64_t>& correctedWayIds,
+    IdBitmap& correctedWayIds,
     std::vector<RoutePaths>& routePaths,
     std::vector<RoutePaths>& rivers,
     std::vector<RoutePaths>& tunnelsAndBridges) const {
@@ -43,37 +51,36 @@ void OsmRoutesRange::getRoutesAndIds(
 
 // _____________________________________________________________________________
 std::vector<RoutePaths> OsmRoutesRange::getRoutesAndExcludeIds(
-    const std::set<uint64_t>& correctedWayIds) const {
+    const IdBitmap& correctedWayIds) const {
     (void)correctedWayIds;
     return std::vector<RoutePaths>();
 }
 
 // _____________________________________________________________________________
-std::set<uint64_t> OsmRoutesRange::requiredNodes(
+NodeIds OsmRoutesRange::requiredNodes(
     const std::vector<RoutePaths>& routePaths,
     const std::vector<RoutePaths>& rivers) const {
-  // Make set containing all node ids that are needed.
-  std::set<uint64_t> uniqueIds;
+  // Collect all node ids that are needed, then sort them.
+  NodeIds uniqueIds;
   for (const auto& routePath : routePaths) {
     for (const auto& subPath : routePath) {
-      for (const auto& nodeId : subPath) {
-        uniqueIds.emplace(nodeId);
-      }
+      uniqueIds.insert(uniqueIds.end(), subPath.begin(), subPath.end());
     }
   }
   for (const auto& river : rivers) {
     for (const auto& substream : river) {
-      for (const auto& nodeId : substream) {
-        uniqueIds.emplace(nodeId);
-      }
+      uniqueIds.insert(uniqueIds.end(), substream.begin(), substream.end());
     }
   }
+  sortUnique(uniqueIds);
   return uniqueIds;
 }
 
 // _____________________________________________________________________________
-NodeIndex OsmRoutesRange::buildNodeIndex(
-    const std::set<uint64_t>& nodeIds) const {
+NodeIndex OsmRoutesRange::buildNodeIndex(const NodeIds& nodeIds) const {
+  if (_nodeStore && _nodeStore->valid()) {
+    return _nodeStore->nodeIndex(nodeIds);
+  }
   // Build a node index given needed node ids.
   NodeIndex nodeIndex(nodeIds.size());
   OsmNodesHandler osmNodesHandler(nodeIndex, _elevationTags, nodeIds);
@@ -4,17 +4,22 @@
 #ifndef SRC_CORRECTOSMELEVATION_OSM_OSMROUTESRANGE_H_
 #define SRC_CORRECTOSMELEVATION_OSM_OSMROUTESRANGE_H_
 
-#include <set>
 #include <vector>
 #include <string>
 #include <cstdint>
+#include "util/index/IdBitmap.h"
 #include "util/osm/OsmStats.h"
 #include "util/index/NodeIndex.h"
+#include "util/index/NodeIds.h"
+#include "util/index/NodeStore.h"
 
 namespace correctosmelevation {
 namespace osm {
 
+using util::index::IdBitmap;
 using util::index::NodeIndex;
+using util::index::NodeIds;
+using util::index::NodeStore;
 using util::osm::OsmStats;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
@@ -27,12 +32,13 @@ class OsmRoutesRange {
  public:
   OsmRoutesRange(const std::string& osmFile, const OsmStats& osmStats,
                  const std::string& elevationTag,
-                 const uint64_t rangeStart, const uint64_t rangeEnd);
+                 const uint64_t rangeStart, const uint64_t rangeEnd,
+                 const NodeStore* nodeStore = nullptr);
 
   // Get all route relations in the range. Also, get the way ids
   // in the routes by adding them to the correctedWayIds set.
   virtual void getRoutesAndIds(
-      std::set<uint64_t>& correctedWayIds,
+      IdBitmap& correctedWayIds,
       std::vector<RoutePaths>& routePaths,
       std::vector<RoutePaths>& rivers,
       std::vector<RoutePaths>& tunnelsAndBridges) const;
@@ -40,17 +46,18 @@ class OsmRoutesRange {
   // Get all route ways in the range. Exclude all ways provided in the
   // correctedWayIds set.
   virtual std::vector<RoutePaths> getRoutesAndExcludeIds(
-      const std::set<uint64_t>& correctedWayIds) const;
+      const IdBitmap& correctedWayIds) const;
 
-  // Given route paths and rivers, create a set containing all node ids
+  // Given route paths and rivers, get the sorted unique ids of all nodes
   // that are present in the route paths and rivers.
-  virtual std::set<uint64_t> requiredNodes(
+  virtual NodeIds requiredNodes(
       const std::vector<RoutePaths>& routePaths,
       const std::vector<RoutePaths>& rivers) const;
 
   // Build a node index containing all nodes that are present
-  // in the nodeIds set.
-  virtual NodeIndex buildNodeIndex(const std::set<uint64_t>& nodeIds) const;
+  // in the sorted nodeIds. Read them from the node store if it is valid,
+  // otherwise from the OSM file.
+  virtual NodeIndex buildNodeIndex(const NodeIds& nodeIds) const;
 
  protected:
   // The OSM file where the ways and relations get parsed from.
@@ -68,6 +75,9 @@ class OsmRoutesRange {
 
   // The end of the range.
   const uint64_t _rangeEnd;
+
+  // The nodes of the OSM file, if already stored.
+  const NodeStore* _nodeStore;
 };
 
 }  // namespace osm
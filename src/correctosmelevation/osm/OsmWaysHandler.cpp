@@ -4,9 +4,11 @@
 #include <vector>
 #include <cstdint>
 #include <osmium/osm/way.hpp>
+#include "util/index/IdBitmap.h"
 #include "correctosmelevation/correct/SmoothRoute.h"
 #include "correctosmelevation/osm/OsmWaysHandler.h"
 
+using util::index::IdBitmap;
 using correctosmelevation::osm::OsmWaysHandler;
 using correctosmelevation::correct::SmoothRoute;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
@@ -14,7 +16,7 @@ using RoutePaths = std::vector<std::vector<uint64_t>>;
 // ____________________________________________________________________________
 OsmWaysHandler::OsmWaysHandler(
     std::vector<RoutePaths>& routePaths,
-    const std::set<uint64_t>& correctedWaysIds,
+    const IdBitmap& correctedWaysIds,
     const uint64_t& rangeStart, const uint64_t& rangeEnd) :
     _routePaths(routePaths), _correctedWaysIds(correctedWaysIds),
     _rangeStart(rangeStart), _rangeEnd(rangeEnd) {}
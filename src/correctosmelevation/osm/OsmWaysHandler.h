@@ -5,13 +5,14 @@
 #define SRC_CORRECTOSMELEVATION_OSM_OSMWAYSHANDLER_H_
 
 #include <vector>
-#include <set>
 #include <cstdint>
+#include "util/index/IdBitmap.h"
 #include "parser/OsmHandler.h"
 
 namespace correctosmelevation {
 namespace osm {
 
+using util::index::IdBitmap;
 using parser::OsmHandler;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
@@ -21,7 +22,7 @@ using RoutePaths = std::vector<std::vector<uint64_t>>;
 class OsmWaysHandler : public OsmHandler {
  public:
   OsmWaysHandler(std::vector<RoutePaths>& routePaths,
-                 const std::set<uint64_t>& correctedWaysIds,
+                 const IdBitmap& correctedWaysIds,
                  const uint64_t& rangeStart,
                  const uint64_t& rangeEnd);
 
@@ -39,8 +40,8 @@ class OsmWaysHandler : public OsmHandler {
   std::vector<RoutePaths>& _routePaths;
 
   // Do not collect route paths from ways that were already
-  // corrected in route relations.
-  std::set<uint64_t> _correctedWaysIds;
+  // corrected in route relations. Shared by all ranges.
+  const IdBitmap& _correctedWaysIds;
 
   // The bounds of the routes range.
   const uint64_t _rangeStart;
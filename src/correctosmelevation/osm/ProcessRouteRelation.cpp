@@ -1,6 +1,7 @@
 // Copyright 2022, Urs Spiegelhalter
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 #include <set>
@@ -8,29 +9,43 @@
 #include <utility>
 #include <osmium/osm/relation.hpp>
 #include <osmium/osm/way.hpp>
-#include <osmium/relations/members_database.hpp>
 #include "util/osm/Way.h"
 #include "util/graph/Graph.h"
+#include "util/metrics/Metrics.h"
+#include "correctosmelevation/osm/RelationWays.h"
 #include "correctosmelevation/osm/FindTunnelsAndBridges.h"
 #include "correctosmelevation/osm/ProcessRouteRelation.h"
 
 using util::osm::Way;
 using util::graph::Graph;
 using correctosmelevation::osm::FindTunnelsAndBridges;
+using correctosmelevation::osm::MemberWay;
 using correctosmelevation::osm::ProcessRouteRelation;
+using util::metrics::Metrics;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
+namespace {
+
+// The work budget of the traversals of a route graph, per member and at
+// least, such that a pathological relation takes linear time at most. An
+// ordinary route relation stays far below it.
+constexpr uint64_t GRAPH_WORK_PER_MEMBER = 4096;
+constexpr uint64_t MIN_GRAPH_WORK = uint64_t(1) << 26;
+
+}  // namespace
+
 // ____________________________________________________________________________
 ProcessRouteRelation::ProcessRouteRelation(
-    const MembersDatabase<osmium::Way>& wayDatabase,
-    const osmium::Relation& relation) :
-    _wayDatabase(wayDatabase), _relation(relation) {
+    const RelationWays& relationWays) :
+    _wayDatabase(relationWays), _relation(relationWays.relation()) {
   _forward.reserve(_relation.members().size());
   _backward.reserve(_relation.members().size());
   _twoWay.reserve(_relation.members().size() * 2);
-  _routeGraph = Graph(relation.members().size());
+  _routeGraph = Graph(_relation.members().size());
+  _routeGraph.setWorkBudget(std::max(
+      MIN_GRAPH_WORK, GRAPH_WORK_PER_MEMBER * _relation.members().size()));
 
-  _river = (relation.tags().has_tag("waterway", "river")) ? true : false;
+  _river = (_relation.tags().has_tag("waterway", "river")) ? true : false;
 }
 
 // ____________________________________________________________________________
@@ -67,9 +82,9 @@ uint64_t ProcessRouteRelation::getRouteStartNodeId() const {
     // in. The objects for those members are not available.
     if (member.ref() != 0) {
       if (!std::strcmp(member.role(), "backward")) {
-        startNodeId = _wayDatabase.get(member.ref())->nodes().back().ref();
+        startNodeId = _wayDatabase.way(member.ref())->lastNode;
       } else {
-        startNodeId = _wayDatabase.get(member.ref())->nodes().front().ref();
+        startNodeId = _wayDatabase.way(member.ref())->firstNode;
       }
       break;
     }
@@ -87,9 +102,9 @@ uint64_t ProcessRouteRelation::getRouteEndNodeId() const {
     if (member.ref() != 0) {
       if (!std::strcmp(member.role(), "forward") ||
           !std::strcmp(member.role(), "")) {
-        endNodeId = _wayDatabase.get(member.ref())->nodes().front().ref();
+        endNodeId = _wayDatabase.way(member.ref())->firstNode;
       } else {
-        endNodeId = _wayDatabase.get(member.ref())->nodes().back().ref();
+        endNodeId = _wayDatabase.way(member.ref())->lastNode;
       }
     }
   }
@@ -103,26 +118,21 @@ void ProcessRouteRelation::categorizeWays() {
     // member.ref() will be 0 for all members you are not interested
     // in. The objects for those members are not available.
     if (member.ref() != 0) {
-      const osmium::Way* way = _wayDatabase.get(member.ref());
-      const auto& nodes = way->nodes();
-      const bool oneway = way->tags().has_tag("oneway", "yes");
-      const bool twoway = way->tags().has_tag("oneway", "no");
+      const MemberWay* way = _wayDatabase.way(member.ref());
+      const bool oneway = way->has(MemberWay::ONEWAY_YES);
+      const bool twoway = way->has(MemberWay::ONEWAY_NO);
       const bool forward = !std::strcmp(member.role(), "forward");
       const bool backward = !std::strcmp(member.role(), "backward");
 
        // Collect the ways' start- and endpoints and categorize them correctly.
       if (forward || (oneway && !backward) || _river) {
-        _forward.emplace_back(nodes.front().ref(),
-                              nodes.back().ref(), way->id());
+        _forward.emplace_back(way->firstNode, way->lastNode, way->id);
       } else if (backward) {
-        _backward.emplace_back(nodes.back().ref(),
-                               nodes.front().ref(), way->id());
+        _backward.emplace_back(way->lastNode, way->firstNode, way->id);
       } else if (twoway) {
-        _twoWay.emplace_back(nodes.front().ref(),
-                             nodes.back().ref(), way->id());
+        _twoWay.emplace_back(way->firstNode, way->lastNode, way->id);
       } else {
-        _twoWay.emplace_back(nodes.front().ref(),
-                             nodes.back().ref(), way->id());
+        _twoWay.emplace_back(way->firstNode, way->lastNode, way->id);
       }
     }
   }
@@ -153,20 +163,20 @@ std::vector<uint64_t> ProcessRouteRelation::graphPathToRoutePath(
   }
 
   // Add the start-node.
-  const auto& firstWayNodes =
-      _wayDatabase.get(path.front().second)->nodes();
-  if (path.front().first == firstWayNodes.front()) {
-    routePath.emplace_back(firstWayNodes.back().ref());
+  const MemberWay* firstWay = _wayDatabase.way(path.front().second);
+  if (path.front().first == firstWay->firstNode) {
+    routePath.emplace_back(firstWay->lastNode);
   } else {
-    routePath.emplace_back(firstWayNodes.front().ref());
+    routePath.emplace_back(firstWay->firstNode);
   }
 
   for (const auto& way : path) {
     _usedWaysIds.emplace(way.second);
-    const auto& nodes = _wayDatabase.get(way.second)->nodes();
+    const MemberWay* memberWay = _wayDatabase.way(way.second);
+    const auto& nodes = _wayDatabase.get(*memberWay).nodes();
 
     // Check if the way is needed forward or backward.
-    if (way.first == nodes.front()) {
+    if (way.first == memberWay->firstNode) {
       for (auto rit = nodes.crbegin() + 1; rit != nodes.crend(); ++rit) {
         routePath.emplace_back(rit->ref());
       }
@@ -229,11 +239,11 @@ std::vector<std::vector<uint64_t>>
     if (!_river) { collectTunnelsAndBridges(subroute); }
   }
 
-  // Build route paths starting from all other found startpoints.
+  // Build route paths starting from all other found startpoints, as long
+  // as there are edges left for a new path and work left in the budget.
   uint64_t currentStart = _routeGraph.getStartpoint();
-  uint64_t count = 0;
-  while (currentStart != 0 && count < 200) {
-    ++count;
+  while (currentStart != 0 && !_routeGraph.allEdgesUsed() &&
+         _routeGraph.workLeft()) {
     const auto subRoute = pathFromStartNode(currentStart, unfinishedPath, true);
 
     if (subRoute.size() == 0) {
@@ -252,33 +262,25 @@ std::vector<std::vector<uint64_t>>
     ProcessRouteRelation::getRoutePathsFromUnfinished() {
   std::vector<std::vector<uint64_t>> routePaths;
 
-  // Build route paths by start building from unfinished paths.
-  auto unfinishedPath = _routeGraph.getUnfinishedPath();
-  uint64_t count = 0;
-  while (unfinishedPath.size() != 0 && count < 10000) {
-    ++count;
-
-    // Start building from the last node of the unfinished path.
-    auto remainingPath =
-        pathFromStartNode(unfinishedPath.back().first, unfinishedPath, false);
-
-    // If the remaining path is empty, the path was already covered.
-    if (remainingPath.size() == 0) {
-      unfinishedPath = _routeGraph.getUnfinishedPath();
+  // Build route paths by continuing the unfinished paths from their last
+  // node, as long as there are edges left for a new path and work left in
+  // the budget.
+  std::vector<std::pair<uint64_t, uint64_t>> path;
+  while (!_routeGraph.allEdgesUsed() && _routeGraph.workLeft() &&
+         _routeGraph.continueUnfinishedPath(_river, &path)) {
+    // If the path is empty, the remaining path was already covered.
+    if (path.size() == 0) {
       continue;
     }
-    unfinishedPath.insert(unfinishedPath.end(),
-                          std::make_move_iterator(remainingPath.begin()),
-                          std::make_move_iterator(remainingPath.end()));
-
     // Convert to route path.
-    routePaths.emplace_back(graphPathToRoutePath(unfinishedPath));
+    routePaths.emplace_back(graphPathToRoutePath(path));
 
     // Find and collect tunnels/bridges in the path.
-    if (!_river) { collectTunnelsAndBridges(unfinishedPath); }
-
-    // Get the next unfinished path.
-    unfinishedPath = _routeGraph.getUnfinishedPath();
+    if (!_river) { collectTunnelsAndBridges(path); }
+  }
+  // The paths of the unused edges are lost.
+  if (!_routeGraph.allEdgesUsed() && !_routeGraph.workLeft()) {
+    Metrics::get().add("routeGraphsOverWorkBudget", 1);
   }
   return routePaths;
 }
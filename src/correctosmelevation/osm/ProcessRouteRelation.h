@@ -10,16 +10,15 @@
 #include <utility>
 #include <osmium/osm/relation.hpp>
 #include <osmium/osm/way.hpp>
-#include <osmium/relations/members_database.hpp>
 #include "util/osm/Way.h"
 #include "util/graph/Graph.h"
+#include "correctosmelevation/osm/RelationWays.h"
 
 namespace correctosmelevation {
 namespace osm {
 
 using util::osm::Way;
 using util::graph::Graph;
-using osmium::relations::MembersDatabase;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
 /*
@@ -28,8 +27,7 @@ using RoutePaths = std::vector<std::vector<uint64_t>>;
  */
 class ProcessRouteRelation {
  public:
-  ProcessRouteRelation(const MembersDatabase<osmium::Way>& wayDatabase,
-                       const osmium::Relation& relation);
+  explicit ProcessRouteRelation(const RelationWays& relationWays);
 
   // Get all ways with role "forward".
   std::vector<Way> getForward() const;
@@ -91,11 +89,11 @@ class ProcessRouteRelation {
   void collectTunnelsAndBridges(
       const std::vector<std::pair<uint64_t, uint64_t>>& path);
 
-  // Database that maps way ids to their data, i.e. the associated
-  // nodes and tags. Given by osmium.
-  const MembersDatabase<osmium::Way>& _wayDatabase;
+  // Maps the ids of the member ways to their data, i.e. the associated
+  // nodes and tags. Copied from osmium.
+  const RelationWays& _wayDatabase;
 
-  // The relation as given from osmium. Unnecessary members
+  // The relation as copied from osmium. Unnecessary members
   // were already removed.
   const osmium::Relation& _relation;
 
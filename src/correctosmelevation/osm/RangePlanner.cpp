@@ -0,0 +1,74 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "correctosmelevation/osm/RangePlanner.h"
+
+using correctosmelevation::osm::RangePlanner;
+
+// ____________________________________________________________________________
+RangePlanner::RangePlanner(const uint64_t budget, const double bytesPerUnit) :
+                           _budget(budget),
+                           _bytesPerUnit(std::max(bytesPerUnit, 1.0)) {}
+
+// ____________________________________________________________________________
+uint64_t RangePlanner::rangeEnd(const std::vector<uint32_t>& units,
+                                const uint64_t first,
+                                const uint64_t maxRoutes) const {
+  if (first >= units.size()) {
+    return first;
+  }
+  const uint64_t last = first + std::min<uint64_t>(maxRoutes,
+                                                   units.size() - first);
+  uint64_t end = first;
+  double bytes = 0;
+  while (end < last) {
+    bytes += units[end] * _bytesPerUnit;
+    if (bytes > _budget && end > first) {
+      break;
+    }
+    ++end;
+  }
+  return end;
+}
+
+// ____________________________________________________________________________
+uint64_t RangePlanner::rangeSize(const double unitsPerRoute,
+                                 const uint64_t maxRoutes) const {
+  const double bytesPerRoute = std::max(unitsPerRoute, 1.0) * _bytesPerUnit;
+  const double routes = _budget / bytesPerRoute;
+  if (routes >= maxRoutes) {
+    return std::max<uint64_t>(maxRoutes, 1);
+  }
+  return std::max<uint64_t>(routes, 1);
+}
+
+// ____________________________________________________________________________
+void RangePlanner::measured(const uint64_t units, const uint64_t bytes) {
+  if (units == 0) {
+    return;
+  }
+  const double bytesPerUnit = static_cast<double>(bytes) / units;
+  if (bytesPerUnit > _bytesPerUnit) {
+    _bytesPerUnit = bytesPerUnit;
+  } else {
+    _bytesPerUnit = std::max((_bytesPerUnit + bytesPerUnit) / 2, 1.0);
+  }
+}
+
+// ____________________________________________________________________________
+void RangePlanner::setBudget(const uint64_t budget) {
+  _budget = budget;
+}
+
+// ____________________________________________________________________________
+uint64_t RangePlanner::budget() const {
+  return _budget;
+}
+
+// ____________________________________________________________________________
+double RangePlanner::bytesPerUnit() const {
+  return _bytesPerUnit;
+}
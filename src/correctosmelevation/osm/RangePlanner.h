@@ -0,0 +1,60 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_CORRECTOSMELEVATION_OSM_RANGEPLANNER_H_
+#define SRC_CORRECTOSMELEVATION_OSM_RANGEPLANNER_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace correctosmelevation {
+namespace osm {
+
+/*
+ * Size the ranges of routes such that the data of each range stays
+ * within a memory budget. The size of a route is given in units, like
+ * its member ways or nodes, which are known from a pre-scan of the file.
+ * The bytes per unit start with an estimate, which is corrected with the
+ * bytes measured after each range. Measuring more bytes than estimated
+ * takes effect at once, measuring less only halfway, such that the
+ * following ranges stay within the budget.
+ */
+class RangePlanner {
+ public:
+  RangePlanner(const uint64_t budget, const double bytesPerUnit);
+
+  // The end of the range starting at the first of the routes with the
+  // given units, such that the estimated bytes of the range fit into the
+  // budget, but with at most maxRoutes routes. A range contains at least
+  // one route, even if it doesn't fit.
+  uint64_t rangeEnd(const std::vector<uint32_t>& units, const uint64_t first,
+                    const uint64_t maxRoutes) const;
+
+  // The number of routes of a range, if every route has the given units.
+  // At least one, at most maxRoutes.
+  uint64_t rangeSize(const double unitsPerRoute,
+                     const uint64_t maxRoutes) const;
+
+  // Correct the estimate with the bytes measured for a range of the
+  // given units.
+  void measured(const uint64_t units, const uint64_t bytes);
+
+  // Change the budget, e.g. when other data grows.
+  void setBudget(const uint64_t budget);
+
+  uint64_t budget() const;
+
+  double bytesPerUnit() const;
+
+ private:
+  // The bytes the data of a single range may take.
+  uint64_t _budget;
+
+  // The current estimate of the bytes per unit.
+  double _bytesPerUnit;
+};
+
+}  // namespace osm
+}  // namespace correctosmelevation
+
+#endif  // SRC_CORRECTOSMELEVATION_OSM_RANGEPLANNER_H_
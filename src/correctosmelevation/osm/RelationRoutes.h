@@ -0,0 +1,76 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_CORRECTOSMELEVATION_OSM_RELATIONROUTES_H_
+#define SRC_CORRECTOSMELEVATION_OSM_RELATIONROUTES_H_
+
+#include <vector>
+#include <cstdint>
+
+namespace correctosmelevation {
+namespace osm {
+
+using RoutePaths = std::vector<std::vector<uint64_t>>;
+
+// The number of nodes along all paths of the routes.
+inline uint64_t routesNodeCount(const std::vector<RoutePaths>& routes) {
+  uint64_t count = 0;
+  for (const auto& route : routes) {
+    for (const auto& path : route) {
+      count += path.size();
+    }
+  }
+  return count;
+}
+
+// The memory used by the routes in bytes.
+inline uint64_t routesByteSize(const std::vector<RoutePaths>& routes) {
+  uint64_t bytes = routes.capacity() * sizeof(RoutePaths);
+  for (const auto& route : routes) {
+    bytes += route.capacity() * sizeof(std::vector<uint64_t>);
+    for (const auto& path : route) {
+      bytes += path.capacity() * sizeof(uint64_t);
+    }
+  }
+  return bytes;
+}
+
+/*
+ * The route paths, rivers and tunnels/bridges found in the route
+ * relations of one routes range. Only the node ids along the routes are
+ * kept, such that all ranges can be collected in a single pass over
+ * the ways.
+ */
+struct RelationRoutes {
+  // Free the memory of the range after it has been processed.
+  void clear() {
+    std::vector<RoutePaths>().swap(routePaths);
+    std::vector<uint16_t>().swap(routePathWeights);
+    std::vector<RoutePaths>().swap(rivers);
+    std::vector<RoutePaths>().swap(tunnelsAndBridges);
+  }
+
+  // The memory used by the routes of the range in bytes.
+  uint64_t byteSize() const {
+    return routesByteSize(routePaths) + routesByteSize(rivers) +
+           routesByteSize(tunnelsAndBridges) +
+           routePathWeights.capacity() * sizeof(uint16_t);
+  }
+
+  // Whether there is anything to correct in the range.
+  bool empty() const {
+    return routePaths.empty() && rivers.empty();
+  }
+
+  std::vector<RoutePaths> routePaths;
+  std::vector<RoutePaths> rivers;
+  std::vector<RoutePaths> tunnelsAndBridges;
+
+  // How often each route path was found, once if empty.
+  std::vector<uint16_t> routePathWeights;
+};
+
+}  // namespace osm
+}  // namespace correctosmelevation
+
+#endif  // SRC_CORRECTOSMELEVATION_OSM_RELATIONROUTES_H_
@@ -0,0 +1,88 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/relation.hpp>
+#include <osmium/osm/way.hpp>
+#include <osmium/relations/members_database.hpp>
+#include "correctosmelevation/osm/RelationWays.h"
+
+using correctosmelevation::osm::MemberWay;
+using correctosmelevation::osm::RelationWays;
+
+namespace {
+
+// Initial size of the buffer, it grows with the ways.
+constexpr size_t INITIAL_BUFFER_SIZE = 1 << 14;
+
+// ____________________________________________________________________________
+uint8_t wayFlags(const osmium::Way& way) {
+  const auto& tags = way.tags();
+  uint8_t flags = 0;
+  if (tags.has_key("tunnel")) { flags |= MemberWay::TUNNEL; }
+  if (tags.has_key("bridge")) { flags |= MemberWay::BRIDGE; }
+  if (tags.has_key("embankment")) { flags |= MemberWay::EMBANKMENT; }
+  if (tags.has_key("incline")) { flags |= MemberWay::INCLINE; }
+  if (tags.has_tag("oneway", "yes")) { flags |= MemberWay::ONEWAY_YES; }
+  if (tags.has_tag("oneway", "no")) { flags |= MemberWay::ONEWAY_NO; }
+  return flags;
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+RelationWays::RelationWays(const MembersDatabase<osmium::Way>& wayDatabase,
+                           const osmium::Relation& relation) :
+                           _buffer(INITIAL_BUFFER_SIZE,
+                                   osmium::memory::Buffer::auto_grow::yes) {
+  _buffer.add_item(relation);
+  _relation = _buffer.commit();
+  // A way can be a member more than once, copy it only once.
+  std::vector<uint64_t> ids;
+  for (const auto& member : relation.members()) {
+    if (member.ref() != 0) {
+      ids.push_back(member.ref());
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  _ways.reserve(ids.size());
+  for (const auto id : ids) {
+    const osmium::Way* way = wayDatabase.get(id);
+    if (!way) {
+      continue;
+    }
+    // The buffer may move while growing, so only keep the offsets.
+    _buffer.add_item(*way);
+    const auto& nodes = way->nodes();
+    const uint64_t firstNode = nodes.empty() ? 0 : nodes.front().ref();
+    const uint64_t lastNode = nodes.empty() ? 0 : nodes.back().ref();
+    _ways.push_back({ id, firstNode, lastNode, _buffer.commit(),
+                      wayFlags(*way) });
+  }
+}
+
+// ____________________________________________________________________________
+const osmium::Relation& RelationWays::relation() const {
+  return _buffer.get<osmium::Relation>(_relation);
+}
+
+// ____________________________________________________________________________
+const osmium::Way& RelationWays::get(const MemberWay& way) const {
+  return _buffer.get<osmium::Way>(way.offset);
+}
+
+// ____________________________________________________________________________
+const MemberWay* RelationWays::way(const uint64_t id) const {
+  const auto it = std::lower_bound(
+      _ways.begin(), _ways.end(), id,
+      [](const MemberWay& way, const uint64_t id) { return way.id < id; });
+  if (it == _ways.end() || it->id != id) {
+    return nullptr;
+  }
+  return &*it;
+}
@@ -0,0 +1,85 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_CORRECTOSMELEVATION_OSM_RELATIONWAYS_H_
+#define SRC_CORRECTOSMELEVATION_OSM_RELATIONWAYS_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/relation.hpp>
+#include <osmium/osm/way.hpp>
+#include <osmium/relations/members_database.hpp>
+
+namespace correctosmelevation {
+namespace osm {
+
+using osmium::relations::MembersDatabase;
+
+/*
+ * A member way with its end nodes and the tags needed to find the routes,
+ * as bits of a flag word. They are taken from the tags once, when the way
+ * is copied, such that finding the paths and tunnels/bridges only tests
+ * integers.
+ */
+struct MemberWay {
+  // The flags of a way, set if the way has the tag or the key.
+  static constexpr uint8_t TUNNEL = 1 << 0;
+  static constexpr uint8_t BRIDGE = 1 << 1;
+  static constexpr uint8_t EMBANKMENT = 1 << 2;
+  static constexpr uint8_t INCLINE = 1 << 3;
+  static constexpr uint8_t ONEWAY_YES = 1 << 4;
+  static constexpr uint8_t ONEWAY_NO = 1 << 5;
+
+  // Whether any of the flags is set.
+  bool has(const uint8_t flag) const { return flags & flag; }
+
+  uint64_t id;
+  uint64_t firstNode;
+  uint64_t lastNode;
+
+  // The offset of the way in the buffer.
+  size_t offset;
+
+  uint8_t flags;
+};
+
+/*
+ * A complete relation together with its member ways, copied out of the
+ * osmium databases. Osmium removes the members as soon as the relation is
+ * completed, so the copy is what a relation can be processed from later
+ * on, on another thread. The member ways are looked up by id, with
+ * their end nodes and flags beside the copied ways.
+ */
+class RelationWays {
+ public:
+  // Copy the relation and those of its members found in the database.
+  RelationWays(const MembersDatabase<osmium::Way>& wayDatabase,
+               const osmium::Relation& relation);
+
+  // The copied relation.
+  const osmium::Relation& relation() const;
+
+  // The end nodes and flags of the member way with the id, or nullptr if
+  // it is no member.
+  const MemberWay* way(const uint64_t id) const;
+
+  // The copied way of a member way.
+  const osmium::Way& get(const MemberWay& way) const;
+
+ private:
+  // The relation first, then the ways.
+  osmium::memory::Buffer _buffer;
+
+  // The offset of the relation in the buffer.
+  size_t _relation;
+
+  // The ways sorted by id.
+  std::vector<MemberWay> _ways;
+};
+
+}  // namespace osm
+}  // namespace correctosmelevation
+
+#endif  // SRC_CORRECTOSMELEVATION_OSM_RELATIONWAYS_H_
@@ -0,0 +1,101 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <unordered_map>
+#include "correctosmelevation/osm/RoutePathCache.h"
+
+using correctosmelevation::osm::RoutePathCache;
+using RoutePaths = std::vector<std::vector<uint64_t>>;
+
+namespace {
+
+// Mix the bits of a hash, see splitmix64.
+uint64_t mix(uint64_t hash) {
+  hash ^= hash >> 30;
+  hash *= 0xbf58476d1ce4e5b9;
+  hash ^= hash >> 27;
+  hash *= 0x94d049bb133111eb;
+  return hash ^ (hash >> 31);
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+void RoutePathCache::add(RoutePaths&& routePath) {
+  const uint64_t routeHash = hash(routePath);
+  const auto candidates = _positions.equal_range(routeHash);
+  for (auto it = candidates.first; it != candidates.second; ++it) {
+    // A route added more often than a weight can hold is kept once more.
+    if (_weights[it->second] < std::numeric_limits<uint16_t>::max() &&
+        same(_routePaths[it->second], routePath)) {
+      ++_weights[it->second];
+      ++_duplicates;
+      return;
+    }
+  }
+  _positions.emplace(routeHash, _routePaths.size());
+  _routePaths.emplace_back(std::move(routePath));
+  _weights.push_back(1);
+}
+
+// ____________________________________________________________________________
+std::vector<RoutePaths> RoutePathCache::getRoutePaths() {
+  return std::move(_routePaths);
+}
+
+// ____________________________________________________________________________
+std::vector<uint16_t> RoutePathCache::getWeights() {
+  return std::move(_weights);
+}
+
+// ____________________________________________________________________________
+uint64_t RoutePathCache::duplicates() const {
+  return _duplicates;
+}
+
+// ____________________________________________________________________________
+bool RoutePathCache::reversed(const RoutePaths& routePath) {
+  if (routePath.size() != 1 || routePath[0].empty()) {
+    return false;
+  }
+  const auto& path = routePath[0];
+  if (path.front() != path.back()) {
+    return path.back() < path.front();
+  }
+  // A closed path, compare all nodes.
+  return std::lexicographical_compare(path.rbegin(), path.rend(),
+                                      path.begin(), path.end());
+}
+
+// ____________________________________________________________________________
+uint64_t RoutePathCache::hash(const RoutePaths& routePath) {
+  uint64_t routeHash = mix(routePath.size());
+  if (reversed(routePath)) {
+    for (auto it = routePath[0].rbegin(); it != routePath[0].rend(); ++it) {
+      routeHash = mix(routeHash + *it);
+    }
+    return mix(routeHash + routePath[0].size());
+  }
+  for (const auto& path : routePath) {
+    for (const auto node : path) {
+      routeHash = mix(routeHash + node);
+    }
+    // Separate the paths.
+    routeHash = mix(routeHash + path.size());
+  }
+  return routeHash;
+}
+
+// ____________________________________________________________________________
+bool RoutePathCache::same(const RoutePaths& a, const RoutePaths& b) {
+  if (a == b) {
+    return true;
+  }
+  return a.size() == 1 && b.size() == 1 && a[0].size() == b[0].size() &&
+         std::equal(a[0].begin(), a[0].end(), b[0].rbegin());
+}
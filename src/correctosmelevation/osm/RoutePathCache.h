@@ -0,0 +1,64 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_CORRECTOSMELEVATION_OSM_ROUTEPATHCACHE_H_
+#define SRC_CORRECTOSMELEVATION_OSM_ROUTEPATHCACHE_H_
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+namespace correctosmelevation {
+namespace osm {
+
+using RoutePaths = std::vector<std::vector<uint64_t>>;
+
+/*
+ * Keep each distinct route path once, with the number of times it was
+ * added as its weight. Route relations of buses, trams, hiking and cycling
+ * often share the same ways, so smoothing each distinct path once with its
+ * weight gives the same averages for a fraction of the work.
+ * A route with a single path is the same as its reverse, since the
+ * smoothing window is symmetric. The paths are found by a hash of their
+ * nodes in the direction with the smaller first node.
+ */
+class RoutePathCache {
+ public:
+  // Add a route. If it was added before, only increase its weight.
+  void add(RoutePaths&& routePath);
+
+  // Get the distinct routes in the order they were first added.
+  // Works only once because the routes are moved at return.
+  std::vector<RoutePaths> getRoutePaths();
+
+  // Get the weight of each distinct route.
+  // Works only once because the weights are moved at return.
+  std::vector<uint16_t> getWeights();
+
+  // The number of routes that were added, but already known.
+  uint64_t duplicates() const;
+
+ private:
+  // Whether the route is added in the reverse direction.
+  static bool reversed(const RoutePaths& routePath);
+
+  // The hash of the route in the direction it is added in.
+  static uint64_t hash(const RoutePaths& routePath);
+
+  // Whether both routes are the same, maybe reversed.
+  static bool same(const RoutePaths& a, const RoutePaths& b);
+
+  // The distinct routes and their weights.
+  std::vector<RoutePaths> _routePaths;
+  std::vector<uint16_t> _weights;
+
+  // The positions of the distinct routes by their hash.
+  std::unordered_multimap<uint64_t, uint32_t> _positions;
+
+  uint64_t _duplicates = 0;
+};
+
+}  // namespace osm
+}  // namespace correctosmelevation
+
+#endif  // SRC_CORRECTOSMELEVATION_OSM_ROUTEPATHCACHE_H_
@@ -0,0 +1,69 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <osmium/osm.hpp>
+#include "global/Constants.h"
+#include "util/index/NodeStore.h"
+#include "util/osm/GetOsmStats.h"
+#include "correctosmelevation/osm/OsmRelationsManager.h"
+#include "correctosmelevation/osm/RouteStatsHandler.h"
+
+using global::INVALID_ELEV;
+using util::index::NodeStore;
+using util::osm::GetOsmStats;
+using correctosmelevation::osm::OsmRelationsManager;
+using correctosmelevation::osm::RouteStats;
+using correctosmelevation::osm::RouteStatsHandler;
+
+// ____________________________________________________________________________
+RouteStatsHandler::RouteStatsHandler(NodeStore* nodeStore,
+                                     const std::string& elevationTag) :
+                                     _nodeStore(nodeStore),
+                                     _elevationTag(elevationTag) {}
+
+// ____________________________________________________________________________
+void RouteStatsHandler::node(const osmium::Node& node) {
+  GetOsmStats::node(node);
+  if (!_nodeStore || !node.visible() || node.id() < 0) {
+    return;
+  }
+  // The same elevation as read by the OsmNodesHandler.
+  const char* elevation = node.tags()[_elevationTag.c_str()];
+  const int16_t elevationInt = (elevation) ? atoi(elevation) : INVALID_ELEV;
+  _nodeStore->append(node.id(), node.location().x(), node.location().y(),
+                     elevationInt);
+}
+
+// ____________________________________________________________________________
+void RouteStatsHandler::way(const osmium::Way& way) {
+  GetOsmStats::way(way);
+  if (way.tags().has_key("highway")) {
+    ++_routeStats.highwayWays;
+    _routeStats.highwayNodes += way.nodes().size();
+  }
+}
+
+// ____________________________________________________________________________
+void RouteStatsHandler::relation(const osmium::Relation& relation) {
+  GetOsmStats::relation(relation);
+  // The same relations as taken by the OsmRelationsManager.
+  if (!relation.tags().has_tag("type", "route") &&
+      !relation.tags().has_tag("waterway", "river")) {
+    return;
+  }
+  uint32_t members = 0;
+  for (const auto& member : relation.members()) {
+    if (OsmRelationsManager::isRouteMember(member)) {
+      ++members;
+    }
+  }
+  _routeStats.relationMembers.push_back(members);
+}
+
+// ____________________________________________________________________________
+RouteStats RouteStatsHandler::getRouteStats() const {
+  return _routeStats;
+}
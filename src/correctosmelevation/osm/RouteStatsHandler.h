@@ -0,0 +1,66 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_CORRECTOSMELEVATION_OSM_ROUTESTATSHANDLER_H_
+#define SRC_CORRECTOSMELEVATION_OSM_ROUTESTATSHANDLER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "util/index/NodeStore.h"
+#include "util/osm/GetOsmStats.h"
+
+namespace correctosmelevation {
+namespace osm {
+
+using util::osm::GetOsmStats;
+using util::index::NodeStore;
+
+/*
+ * The sizes of the routes in the OSM file, used to plan the ranges.
+ */
+struct RouteStats {
+  // The number of ways with a highway tag and their nodes.
+  uint64_t highwayWays = 0;
+  uint64_t highwayNodes = 0;
+
+  // The number of member ways of each route relation and river,
+  // in the order of the file.
+  std::vector<uint32_t> relationMembers;
+};
+
+/*
+ * Collect the statistics about the OSM file and the sizes of the routes
+ * in the same pass. If a node store is given, it is filled with the
+ * location and elevation of all nodes, too.
+ */
+class RouteStatsHandler : public GetOsmStats {
+ public:
+  RouteStatsHandler() = default;
+
+  RouteStatsHandler(NodeStore* nodeStore, const std::string& elevationTag);
+
+  // Gets called for each node.
+  void node(const osmium::Node&) override;
+
+  // Gets called for each way.
+  void way(const osmium::Way&) override;
+
+  // Gets called for each relation.
+  void relation(const osmium::Relation&) override;
+
+  RouteStats getRouteStats() const;
+
+ private:
+  RouteStats _routeStats;
+
+  NodeStore* _nodeStore = nullptr;
+
+  // The elevation tag of the nodes in the store.
+  std::string _elevationTag;
+};
+
+}  // namespace osm
+}  // namespace correctosmelevation
+
+#endif  // SRC_CORRECTOSMELEVATION_OSM_ROUTESTATSHANDLER_H_
@@ -1,32 +1,67 @@
 // Copyright 2022, Urs Spiegelhalter
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
-#include <set>
 #include <vector>
 #include <cstdint>
+#include <iterator>
 #include <osmium/io/any_input.hpp>
+#include "util/index/IdBitmap.h"
 #include "correctosmelevation/osm/OsmRelationsManager.h"
+#include "correctosmelevation/osm/RelationRoutes.h"
 #include "correctosmelevation/osm/RoutesFromRelations.h"
+#include "parser/PbfBlockInput.h"
 
+using util::index::IdBitmap;
 using correctosmelevation::osm::OsmRelationsManager;
 using correctosmelevation::osm::RoutesFromRelations;
+using correctosmelevation::osm::RelationRoutes;
+using parser::PbfBlockInput;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
 // _____________________________________________________________________________
 void RoutesFromRelations::getRoutesAndIds(
-    std::set<uint64_t>& correctedWayIds,
+    IdBitmap& correctedWayIds,
     std::vector<RoutePaths>& routePaths,
     std::vector<RoutePaths>& rivers,
     std::vector<RoutePaths>& tunnelsAndBridges) const {
+  // The whole routes range as a single range.
+  auto ranges = getRoutesInRanges(correctedWayIds, _rangeEnd - _rangeStart);
+  for (auto& routes : ranges) {
+    routePaths.insert(routePaths.end(),
+                      std::make_move_iterator(routes.routePaths.begin()),
+                      std::make_move_iterator(routes.routePaths.end()));
+    rivers.insert(rivers.end(),
+                  std::make_move_iterator(routes.rivers.begin()),
+                  std::make_move_iterator(routes.rivers.end()));
+    tunnelsAndBridges.insert(
+        tunnelsAndBridges.end(),
+        std::make_move_iterator(routes.tunnelsAndBridges.begin()),
+        std::make_move_iterator(routes.tunnelsAndBridges.end()));
+  }
+}
 
-  osmium::io::File inputFile{_osmFile};
-
-  OsmRelationsManager osmRelationsManager(correctedWayIds, routePaths, rivers,
-                                          tunnelsAndBridges, _rangeStart,
-                                          _rangeEnd);
+// _____________________________________________________________________________
+std::vector<RelationRoutes> RoutesFromRelations::getRoutesInRanges(
+    IdBitmap& correctedWayIds,
+    const uint64_t relationsPerRange,
+    const uint16_t threads) const {
+  std::vector<RelationRoutes> ranges;
+  OsmRelationsManager osmRelationsManager(correctedWayIds, ranges,
+                                          _rangeStart, _rangeEnd,
+                                          relationsPerRange, threads);
 
-  osmium::relations::read_relations(inputFile, osmRelationsManager);
+  // The first pass only needs the relations, skip all other blocks.
+  {
+    PbfBlockInput relationInput{_osmFile, osmium::osm_entity_bits::relation};
+    osmium::relations::read_relations(relationInput.file(),
+                                      osmRelationsManager);
+  }
 
-  osmium::io::Reader reader{inputFile};
+  // The second pass collects the member ways of all ranges at once.
+  PbfBlockInput wayInput{_osmFile, osmium::osm_entity_bits::way};
+  osmium::io::Reader reader{wayInput.file(), osmium::osm_entity_bits::way};
   osmium::apply(reader, osmRelationsManager.handler());
+  reader.close();
+  osmRelationsManager.finish();
+  return ranges;
 }
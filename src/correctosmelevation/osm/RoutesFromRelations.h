@@ -4,14 +4,16 @@
 #ifndef SRC_CORRECTOSMELEVATION_OSM_ROUTESFROMRELATIONS_H_
 #define SRC_CORRECTOSMELEVATION_OSM_ROUTESFROMRELATIONS_H_
 
-#include <set>
 #include <vector>
 #include <cstdint>
+#include "util/index/IdBitmap.h"
 #include "correctosmelevation/osm/OsmRoutesRange.h"
+#include "correctosmelevation/osm/RelationRoutes.h"
 
 namespace correctosmelevation {
 namespace osm {
 
+using util::index::IdBitmap;
 using correctosmelevation::osm::OsmRoutesRange;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
@@ -27,10 +29,21 @@ class RoutesFromRelations : public OsmRoutesRange {
   // relations in a routes range using the OsmRelationsManager.
   // Also, get the ids of all used ways in the route relations.
   void getRoutesAndIds(
-      std::set<uint64_t>& correctedWayIds,
+      IdBitmap& correctedWayIds,
       std::vector<RoutePaths>& routePaths,
       std::vector<RoutePaths>& rivers,
       std::vector<RoutePaths>& tunnelsAndBridges) const override;
+
+  // Get all route paths, bridges/tunnels, and rivers of the routes range,
+  // split into ranges of relationsPerRange route relations each. The
+  // relations and the ways are read only once, independent of the number
+  // of ranges. Also, get the ids of all used ways in the route relations.
+  // The relations are processed on the given number of threads while the
+  // ways are read.
+  std::vector<RelationRoutes> getRoutesInRanges(
+      IdBitmap& correctedWayIds,
+      const uint64_t relationsPerRange,
+      const uint16_t threads = 1) const;
 };
 
 }  // namespace osm
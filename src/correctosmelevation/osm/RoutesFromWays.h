@@ -4,14 +4,15 @@
 #ifndef SRC_CORRECTOSMELEVATION_OSM_ROUTESFROMWAYS_H_
 #define SRC_CORRECTOSMELEVATION_OSM_ROUTESFROMWAYS_H_
 
-#include <set>
 #include <vector>
 #include <cstdint>
+#include "util/index/IdBitmap.h"
 #include "correctosmelevation/osm/OsmRoutesRange.h"
 
 namespace correctosmelevation {
 namespace osm {
 
+using util::index::IdBitmap;
 using correctosmelevation::osm::OsmRoutesRange;
 using RoutePaths = std::vector<std::vector<uint64_t>>;
 
@@ -27,7 +28,7 @@ class RoutesFromWays : public OsmRoutesRange {
   // using the OsmWaysHandler. Exclude route paths that are
   // in the correctedWayIds set.
   std::vector<RoutePaths> getRoutesAndExcludeIds(
-      const std::set<uint64_t>& correctedWayIds) const override;
+      const IdBitmap& correctedWayIds) const override;
 };
 
 }  // namespace osm
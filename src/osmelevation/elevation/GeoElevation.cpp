@@ -7,91 +7,85 @@
 #include "util/geo/Geo.h"
 #include "global/Constants.h"
 #include "osmelevation/elevation/GeoElevation.h"
+#include "util/metrics/Metrics.h"
 
 using osmelevation::elevation::GeoElevation;
 using osmelevation::elevation::NasademFile;
 using util::geo::haversineApprox;
 using global::INVALID_ELEV;
+using util::metrics::Metrics;
 using CoordInt = util::geo::Point<int16_t>;
 using Coordinate = util::geo::Point<double>;
 using Cell = util::geo::Point<uint16_t>;
 
 // ____________________________________________________________________________
 GeoElevation::GeoElevation(const std::string& nasademDir) :
-                           _nasademDir(nasademDir) {}
+                           _nasademDir(nasademDir),
+                           _cacheHits(0) {}
+
+// ____________________________________________________________________________
+GeoElevation::~GeoElevation() {
+  Metrics::get().add("nasademCacheHits", _cacheHits);
+}
 
 // ____________________________________________________________________________
 int16_t GeoElevation::getInterpolatedElevation(const Coordinate& coord) {
   // Bottom left coordinate of the NASADEM file.
   const CoordInt originCoord = coord.toFloor16();
-  const NasademFile& centerNasademFile = getNasademFile(originCoord);
-  const Cell centerCell = centerNasademFile.getCellFromCoord(coord);
-  const uint16_t samples = centerNasademFile.getSamples();
+  const NasademFile& nasademFile = getHaloedNasademFile(originCoord);
+  const Cell centerCell = nasademFile.getCellFromCoord(coord);
 
-  // Use inverse distance weighting to get the interpolated elevation.
-  double weights = 0.0;
-  double elevation = 0.0;
-
-  const int16_t cellElevation =
-    centerNasademFile.getElevationFromCell(centerCell);
-
-  if (cellElevation != INVALID_ELEV) {
-    // Cell containing the coordinate.
-    const auto cellCenter = centerNasademFile.getCellCenter(centerCell);
-    if (coord == cellCenter) {
-      return centerNasademFile.getElevationFromCell(centerCell);
-    }
-
-    const double distance = haversineApprox(cellCenter, coord);
-    const double squareDistance = distance * distance;
-    weights += 1 / squareDistance;
-    elevation += cellElevation / squareDistance;
-  } else {
+  // Cell containing the coordinate.
+  const int16_t cellElevation = nasademFile.getElevationFromCell(centerCell);
+  if (cellElevation == INVALID_ELEV) {
     return INVALID_ELEV;
   }
+  const auto cellCenter = nasademFile.getCellCenter(centerCell);
+  if (coord == cellCenter) {
+    return cellElevation;
+  }
 
-  // Neighbor cells.
+  // Use inverse distance weighting to get the interpolated elevation.
+  const double distance = haversineApprox(cellCenter, coord);
+  const double squareDistance = distance * distance;
+  double weights = 1 / squareDistance;
+  double elevation = cellElevation / squareDistance;
+
+  // Neighbor cells, all of them are inside the haloed grid.
+  // Invalid cells get a weight of zero.
+  const int16_t* center = nasademFile.getHaloedCell(centerCell);
+  const int32_t stride = nasademFile.getStride();
   for (const auto& offset : cellOffsets) {
-    // Respectively to the number of samples.
-    Cell neighborCell = centerCell.addOffsetAndNormalize(offset, samples);
-
-    // Check if the neighboring cell is inside the center NASADEM file.
-    const bool inCenterFile = cellInNasademFile(centerCell, neighborCell,
-                                                offset);
-    // Get the adjacent NASADEM file if needed.
-    const NasademFile& cellNasademFile =
-      inCenterFile ? centerNasademFile
-      : getNasademFile(originCoord + (offset * Point<int16_t>(1, -1)));
-
-    // If the cell is in a neigbor file, need to go two steps in the
-    // offset direction since the NASADEM files are overlapping at
-    // all the edges.
-    if (!inCenterFile) {
-      neighborCell.addOffsetAndNormalizeInPlace(offset, samples);
-    }
-    const int16_t cellElevation =
-      cellNasademFile.getElevationFromCell(neighborCell);
-
-    // Add to inverse distance weighting.
-    if (cellElevation != INVALID_ELEV) {
-      const Coordinate cellCenter = cellNasademFile.getCellCenter(neighborCell);
-      const double distance = haversineApprox(cellCenter, coord);
-      const double squareDistance = distance * distance;
-      weights += 1 / squareDistance;
-      elevation += cellElevation / squareDistance;
-    }
+    const int16_t neighborElevation =
+      center[offset.getY() * stride + offset.getX()];
+    const Coordinate neighborCenter = nasademFile.getCellCenter(centerCell,
+                                                                offset);
+    const double distance = haversineApprox(neighborCenter, coord);
+    const double squareDistance = distance * distance;
+    const double valid = neighborElevation != INVALID_ELEV;
+    weights += valid / squareDistance;
+    elevation += valid * neighborElevation / squareDistance;
   }
   return static_cast<int16_t>(std::lround(elevation / weights));
 }
 
 // ____________________________________________________________________________
-bool GeoElevation::cellInNasademFile(const Cell& originCell,
-                                     const Cell& newCell,
-                                     const Point<int16_t>& newOffset) {
-  int16_t newX = static_cast<int16_t>(newCell.getX()) - newOffset.getX();
-  int16_t newY = static_cast<int16_t>(newCell.getY()) - newOffset.getY();
-
-  return newX == originCell.getX() && newY == originCell.getY();
+NasademFile& GeoElevation::getHaloedNasademFile(const CoordInt& originCoord) {
+  NasademFile& nasademFile = getNasademFile(originCoord);
+  if (nasademFile.isHaloed()) {
+    return nasademFile;
+  }
+  // Without data there are no cells to interpolate, so the
+  // neighboring files are not needed.
+  if (nasademFile.exists()) {
+    for (const auto& offset : cellOffsets) {
+      const NasademFile& neighbor =
+        getNasademFile(originCoord + (offset * Point<int16_t>(1, -1)));
+      nasademFile.copyHaloFrom(neighbor, offset);
+    }
+  }
+  nasademFile.setHaloed();
+  return nasademFile;
 }
 
 // ____________________________________________________________________________
@@ -100,6 +94,7 @@ NasademFile& GeoElevation::getNasademFile(const CoordInt& originCoord) {
   const size_t key = coordToKey(originCoord);
   auto nasademFileIt = _nasademFiles.try_emplace(key, _nasademDir,
                                                  originCoord);
+  _cacheHits += !nasademFileIt.second;
 
   return nasademFileIt.first->second;
 }
@@ -110,6 +105,12 @@ int16_t GeoElevation::getElevation(const Coordinate& coord) {
   return getNasademFile(coordOrigin).getElevationFromCoord(coord);
 }
 
+// ____________________________________________________________________________
+int16_t GeoElevation::getBilinearElevation(const Coordinate& coord) {
+  const CoordInt coordOrigin = coord.toFloor16();
+  return getNasademFile(coordOrigin).getElevationBilinear(coord);
+}
+
 // ____________________________________________________________________________
 size_t GeoElevation::coordToKey(const Point<int16_t>& point) {
   return static_cast<size_t>(point.getX()) << 32 | (unsigned int)point.getY();
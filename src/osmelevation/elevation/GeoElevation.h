@@ -4,9 +4,11 @@
 #ifndef SRC_OSMELEVATION_ELEVATION_GEOELEVATION_H_
 #define SRC_OSMELEVATION_ELEVATION_GEOELEVATION_H_
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include "osmelevation/elevation/NasademFile.h"
+#include "osmelevation/elevation/Interpolation.h"
 #include "util/geo/Point.h"
 
 using util::geo::Point;
@@ -37,6 +39,9 @@ class GeoElevation {
  public:
   explicit GeoElevation(const std::string& nasademDir);
 
+  // Add the cache hits to the metrics of the program run.
+  ~GeoElevation();
+
   // Get the elevation for a coordinate without any further processing.
   int16_t getElevation(const Coordinate& coord);
 
@@ -44,12 +49,33 @@ class GeoElevation {
   // surrounding available cells of the coordinate.
   int16_t getInterpolatedElevation(const Coordinate& coord);
 
+  // Get the elevation for a coordinate by bilinear interpolation
+  // of the 4 cell centers surrounding the coordinate.
+  int16_t getBilinearElevation(const Coordinate& coord);
+
+  // Get the elevation for a coordinate with the interpolation kernel
+  // chosen at compile time, so there is no dispatch per coordinate.
+  template <Interpolation kernel>
+  int16_t getKernelElevation(const Coordinate& coord) {
+    if constexpr (kernel == Interpolation::NEAREST) {
+      return getElevation(coord);
+    } else if constexpr (kernel == Interpolation::BILINEAR) {
+      return getBilinearElevation(coord);
+    } else {
+      return getInterpolatedElevation(coord);
+    }
+  }
+
   // Get access to the requested NASADEM file. Either invoke loading
   // the NASADEM file into memory and creating an NasademFile object
   // which provides an interface accessing it, or access the object
   // directly from memory if already done so.
   NasademFile& getNasademFile(const CoordInt& originCoord);
 
+  // Get access to the requested NASADEM file with its halo filled from
+  // the surrounding NASADEM files, which are loaded as well if needed.
+  NasademFile& getHaloedNasademFile(const CoordInt& originCoord);
+
   // Remove all NASADEM files that have been loaded into memory.
   void clear();
 
@@ -60,11 +86,8 @@ class GeoElevation {
   // The in-memory NASADEM files.
   std::unordered_map<size_t, NasademFile> _nasademFiles;
 
-  // Check if a cell is still inside the same NASADEM file
-  // as the origin cell after an offset was added to it.
-  static bool cellInNasademFile(const Cell& originCell,
-                                const Cell& newcell,
-                                const Point<int16_t>& newOffset);
+  // Number of requests for NASADEM files already in memory.
+  uint64_t _cacheHits;
 
   // Create an unique ID for a coordinate to use the coordinate
   // as a key for an unordered_map.
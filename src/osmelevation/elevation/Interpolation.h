@@ -0,0 +1,24 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_OSMELEVATION_ELEVATION_INTERPOLATION_H_
+#define SRC_OSMELEVATION_ELEVATION_INTERPOLATION_H_
+
+#include <cstdint>
+
+namespace osmelevation {
+namespace elevation {
+
+/*
+ * The available kernels to derive the elevation of a coordinate
+ * from the cells of the NASADEM files.
+ * NEAREST: The elevation of the cell containing the coordinate.
+ * BILINEAR: Bilinear interpolation of the 4 surrounding cell centers.
+ * IDW: Inverse distance weighting of the 3x3 cells around the coordinate.
+ */
+enum class Interpolation : uint8_t { NEAREST, BILINEAR, IDW };
+
+}  // namespace elevation
+}  // namespace osmelevation
+
+#endif  // SRC_OSMELEVATION_ELEVATION_INTERPOLATION_H_
@@ -7,10 +7,12 @@
 #include <memory>
 #include <fstream>
 #include <tuple>
+#include <algorithm>
 #include "osmelevation/elevation/NasademFile.h"
 #include "util/geo/Point.h"
 #include "global/Constants.h"
 #include "osmelevation/elevation/NasademFileName.h"
+#include "util/metrics/Metrics.h"
 
 using osmelevation::elevation::NasademFile;
 using osmelevation::elevation::convertToNasademNaming;
@@ -21,6 +23,9 @@ using Cell = util::geo::Point<uint16_t>;
 using global::INVALID_ELEV;
 using global::MIN_ELEV_EARTH;
 using global::MAX_ELEV_EARTH;
+using util::metrics::Metrics;
+using util::metrics::fileBytes;
+using util::metrics::wallSeconds;
 
 // ____________________________________________________________________________
 NasademFile::NasademFile(const std::string& nasademDir,
@@ -28,8 +33,10 @@ NasademFile::NasademFile(const std::string& nasademDir,
   _nasademFileName = convertToNasademNaming(coord);
   std::string fp = getNasademFilePath(nasademDir, _nasademFileName);
   _exists = true ? fp != std::string("invalid") : false;
-  _data = getData(fp);
+  _haloed = false;
+  const auto data = getData(fp);
   _samples = floor(sqrt(_length / 2));
+  fillGrid(data.get());
   _cellSize = _exists ? 1 / static_cast<double>(_samples - 1) : 1;
   _cellCenterOffset = _cellSize / static_cast<double>(2);
   _lon = floor(coord.getX());
@@ -61,8 +68,10 @@ std::unique_ptr<uint8_t[]> NasademFile::getData(
     const std::string& zippedFile) {
   // If the NASADEM file doesn't exist, write 10000 into contents.
   if (!_exists) {
+    Metrics::get().add("nasademFilesMissing", 1);
     return getDataInvalid();
   }
+  const double decompressStart = wallSeconds();
 
   // Open the ZIP archive.
   int err = 0;
@@ -97,6 +106,11 @@ std::unique_ptr<uint8_t[]> NasademFile::getData(
   zip_fclose(f);
   zip_close(z);
 
+  Metrics& metrics = Metrics::get();
+  metrics.add("nasademFilesLoaded", 1);
+  metrics.add("nasademBytesRead", fileBytes(zippedFile));
+  metrics.addSeconds("nasademDecompressSeconds",
+                     wallSeconds() - decompressStart);
   return contents;
 }
 
@@ -111,6 +125,81 @@ std::unique_ptr<uint8_t[]> NasademFile::getDataInvalid() {
   return contents;
 }
 
+// ____________________________________________________________________________
+void NasademFile::fillGrid(const uint8_t* data) {
+  _stride = _samples + 2;
+  _grid.assign(static_cast<size_t>(_stride) * _stride, INVALID_ELEV);
+
+  for (uint32_t row = 0; row < _samples; ++row) {
+    int16_t* gridRow = &_grid[(row + 1) * _stride + 1];
+    const uint8_t* dataRow = data + row * _samples * 2;
+    for (uint32_t col = 0; col < _samples; ++col) {
+      const int16_t elevation = (int16_t)(dataRow[col * 2] << 8) +
+                                dataRow[col * 2 + 1];
+      const bool onEarth = elevation >= MIN_ELEV_EARTH &&
+                           elevation <= MAX_ELEV_EARTH;
+      gridRow[col] = onEarth ? elevation : INVALID_ELEV;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void NasademFile::copyHaloFrom(const NasademFile& neighbor,
+                               const Point<int16_t>& offset) {
+  // Only files with the same resolution can be stitched together.
+  if (!_exists || !neighbor.exists() || neighbor.getSamples() != _samples) {
+    return;
+  }
+  // The halo cells in the direction of the offset, given as first and
+  // last column and row relative to the top left cell.
+  const int32_t last = _samples - 1;
+  const int32_t firstCol = offset.getX() < 0 ? -1 :
+                           (offset.getX() > 0 ? _samples : 0);
+  const int32_t lastCol = offset.getX() == 0 ? last : firstCol;
+  const int32_t firstRow = offset.getY() < 0 ? -1 :
+                           (offset.getY() > 0 ? _samples : 0);
+  const int32_t lastRow = offset.getY() == 0 ? last : firstRow;
+
+  // The same cell in the neighboring file is shifted by one file.
+  for (int32_t row = firstRow; row <= lastRow; ++row) {
+    const int32_t neighborRow = row - offset.getY() * last;
+    for (int32_t col = firstCol; col <= lastCol; ++col) {
+      const int32_t neighborCol = col - offset.getX() * last;
+      _grid[(row + 1) * _stride + col + 1] =
+        neighbor._grid[(neighborRow + 1) * _stride + neighborCol + 1];
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void NasademFile::setHaloed() {
+  _haloed = true;
+}
+
+// ____________________________________________________________________________
+bool NasademFile::isHaloed() const {
+  return _haloed;
+}
+
+// ____________________________________________________________________________
+uint32_t NasademFile::getStride() const {
+  return _stride;
+}
+
+// ____________________________________________________________________________
+const int16_t* NasademFile::getHaloedCell(const Cell& cell) const {
+  return &_grid[(cell.getY() + 1) * _stride + cell.getX() + 1];
+}
+
+// ____________________________________________________________________________
+Coordinate NasademFile::getCellCenter(const Cell& cell,
+                                      const Point<int16_t>& offset) const {
+  Coordinate cellCenter((_lon + ((cell.getX() + offset.getX()) * _cellSize)),
+                        (_lat + 1 - ((cell.getY() + offset.getY()) *
+                                     _cellSize)));
+  return cellCenter;
+}
+
 // ____________________________________________________________________________
 Coordinate NasademFile::getCellCenter(const Cell& cell) const {
   Coordinate cellCenter((_lon + (cell.getX() * _cellSize)),
@@ -134,15 +223,7 @@ int16_t NasademFile::getElevationFromCell(const Cell& cell) const {
     return INVALID_ELEV;
   }
 
-  // Calculate the position of (row, col) in the bytearray.
-  const uint32_t cellIndex = (cell.getY() * _samples + cell.getX()) * 2;
-  int16_t elevation = (int16_t)(_data.get()[cellIndex] << 8) +
-                      _data.get()[cellIndex + 1];
-
-  if (elevation < MIN_ELEV_EARTH || elevation > MAX_ELEV_EARTH) {
-    elevation = INVALID_ELEV;
-  }
-  return elevation;
+  return *getHaloedCell(cell);
 }
 
 // ____________________________________________________________________________
@@ -150,3 +231,49 @@ int16_t NasademFile::getElevationFromCoord(const Coordinate& coord) const {
   const Cell cell = getCellFromCoord(coord);
   return getElevationFromCell(cell);
 }
+
+// ____________________________________________________________________________
+int16_t NasademFile::getElevationBilinear(const Coordinate& coord) const {
+  if (!_exists) {
+    return INVALID_ELEV;
+  }
+  // The position of the coordinate in units of cells, relative to
+  // the center of the top left cell.
+  const double x = (coord.getX() - _lon) * static_cast<double>(_samples - 1);
+  const double y = (_lat + 1 - coord.getY()) *
+                   static_cast<double>(_samples - 1);
+
+  // The top left cell of the 4 surrounding cells. Coordinates on the
+  // bottom or right edge use the last row or column as the far cells.
+  const uint16_t maxCell = _samples - 2;
+  const uint16_t col = std::min(static_cast<uint16_t>(floor(x)), maxCell);
+  const uint16_t row = std::min(static_cast<uint16_t>(floor(y)), maxCell);
+  const double dx = x - col;
+  const double dy = y - row;
+
+  const int16_t elevations[4] = {
+    getElevationFromCell(Cell(col, row)),
+    getElevationFromCell(Cell(col + 1, row)),
+    getElevationFromCell(Cell(col, row + 1)),
+    getElevationFromCell(Cell(col + 1, row + 1)) };
+  const double weights[4] = { (1 - dx) * (1 - dy), dx * (1 - dy),
+                              (1 - dx) * dy, dx * dy };
+
+  // No elevation if the cell containing the coordinate is a void,
+  // the same as for the other kernels.
+  const uint8_t nearest = (dx >= 0.5) + 2 * (dy >= 0.5);
+  if (elevations[nearest] == INVALID_ELEV) {
+    return INVALID_ELEV;
+  }
+
+  // Leave out voids and weight the remaining cells accordingly.
+  double weightSum = 0.0;
+  double elevation = 0.0;
+  for (uint8_t i = 0; i < 4; ++i) {
+    if (elevations[i] != INVALID_ELEV) {
+      weightSum += weights[i];
+      elevation += weights[i] * elevations[i];
+    }
+  }
+  return static_cast<int16_t>(std::lround(elevation / weightSum));
+}
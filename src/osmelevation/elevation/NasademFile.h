@@ -7,11 +7,13 @@
 #include <cstdint>
 #include <string>
 #include <memory>
+#include <vector>
 #include "util/geo/Point.h"
 
 using CoordInt = util::geo::Point<int16_t>;
 using Coordinate = util::geo::Point<double>;
 using Cell = util::geo::Point<uint16_t>;
+using util::geo::Point;
 
 namespace osmelevation {
 namespace elevation {
@@ -22,6 +24,9 @@ namespace elevation {
  * The NASADEM file is divided into cells.
  * Elevation data for a coordinate can also be extracted by
  * directly providing the cell the coordinate corresponds to.
+ * The cells are kept in a grid with a halo of one cell on each side,
+ * filled with the adjacent cells of the neighboring NASADEM files.
+ * So the 3x3 neighborhood of every cell is inside the same array.
  */
 class NasademFile {
  public:
@@ -35,6 +40,11 @@ class NasademFile {
   // Get the elevation for a coordinate.
   int16_t getElevationFromCoord(const Coordinate& coord) const;
 
+  // Get the elevation for a coordinate by bilinear interpolation of the
+  // 4 cell centers around it. Since NASADEM files overlap at their edges,
+  // the 4 cells are always inside this file.
+  int16_t getElevationBilinear(const Coordinate& coord) const;
+
   // Calculate the cell from the collumn and
   // row and get the elevation in the cell.
   int16_t getElevationFromCell(const Cell& cell) const;
@@ -45,17 +55,48 @@ class NasademFile {
   // Get the center of a cell given by row and column.
   Coordinate getCellCenter(const Cell& cell) const;
 
+  // Get the center of the cell at an offset to a cell. The offset
+  // cell can be in the halo.
+  Coordinate getCellCenter(const Cell& cell,
+                           const Point<int16_t>& offset) const;
+
+  // Get a pointer to a cell in the haloed grid. The elevations of
+  // the 8 surrounding cells are at offset.x + offset.y * getStride().
+  const int16_t* getHaloedCell(const Cell& cell) const;
+
+  // Number of cells in a row of the haloed grid.
+  uint32_t getStride() const;
+
+  // Copy the cells adjacent to this file from the neighboring file in
+  // the direction of the cell offset into the halo. NASADEM files are
+  // overlapping at the edges, so these are the second row or column
+  // of the neighboring file.
+  void copyHaloFrom(const NasademFile& neighbor,
+                    const Point<int16_t>& offset);
+
+  // Mark and check if the halo has been filled. Halo cells without
+  // a neighboring file stay invalid.
+  void setHaloed();
+  bool isHaloed() const;
+
  private:
   // Extract the bytes from the NASADEM file.
   std::unique_ptr<uint8_t[]> getData(const std::string& zippedFile);
 
+  // Convert the raw big-endian data into the haloed grid, replacing
+  // all elevations that are not on earth by the invalid elevation.
+  void fillGrid(const uint8_t* data);
+
   // If the requested NASADEM file doesn't exist or is invalid for
   // another reason, return dummy data that will be recognized
   // as invalid.
   std::unique_ptr<uint8_t[]> getDataInvalid();
 
-  // The raw NASADEM elevation data array.
-  std::unique_ptr<uint8_t[]> _data;
+  // The elevations in row major order with a halo of one cell.
+  std::vector<int16_t> _grid;
+
+  // Number of cells in a row of the haloed grid.
+  uint32_t _stride;
 
   // Number of bytes in the data.
   uint32_t _length;
@@ -78,6 +119,9 @@ class NasademFile {
 
   // If the file doesn't exist, there is no elevation data available.
   bool _exists;
+
+  // If the halo has been filled from the neighboring files.
+  bool _haloed;
 };
 
 }  // namespace elevation
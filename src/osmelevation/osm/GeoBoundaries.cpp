@@ -2,6 +2,7 @@
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
 #include <cstdint>
+#include <algorithm>
 #include <vector>
 #include <tuple>
 #include "util/osm/OsmStats.h"
@@ -10,6 +11,7 @@
 
 using osmelevation::osm::GeoBoundaries;
 using util::osm::OsmStats;
+using util::osm::tileIndex;
 using global::NASADEM_MIN_LAT;
 using global::NASADEM_MAX_LAT;
 using GeoBoundary = std::tuple<int16_t, int16_t, int16_t, int16_t>;
@@ -42,3 +44,109 @@ std::vector<GeoBoundary> GeoBoundaries::buildBoundaries() const {
   }
   return boundaries;
 }
+
+// ____________________________________________________________________________
+std::vector<GeoBoundary> GeoBoundaries::planBoundaries() const {
+  if (_osmStats.tileNodeCounts.empty()) {
+    return buildBoundaries();
+  }
+  auto boundaries = std::vector<GeoBoundary>();
+
+  const int16_t minLatNasadem = (_osmStats.minLat < NASADEM_MIN_LAT)
+                                ? NASADEM_MIN_LAT : _osmStats.minLat;
+  const int16_t maxLatNasadem = (_osmStats.maxLat > NASADEM_MAX_LAT)
+                                ? NASADEM_MAX_LAT : _osmStats.maxLat;
+  if (_osmStats.minLon < _osmStats.maxLon && minLatNasadem < maxLatNasadem) {
+    planBoundary(GeoBoundary(_osmStats.minLon, minLatNasadem,
+                             _osmStats.maxLon, maxLatNasadem), &boundaries);
+  }
+  return boundaries;
+}
+
+// ____________________________________________________________________________
+void GeoBoundaries::planBoundary(GeoBoundary boundary,
+                                 std::vector<GeoBoundary>* boundaries) const {
+  auto& [minLon, minLat, maxLon, maxLat] = boundary;
+
+  // Shrink to the bounding box of the occupied tiles.
+  int16_t minLonOcc = maxLon;
+  int16_t minLatOcc = maxLat;
+  int16_t maxLonOcc = minLon;
+  int16_t maxLatOcc = minLat;
+  for (int16_t lon = minLon; lon < maxLon; ++lon) {
+    for (int16_t lat = minLat; lat < maxLat; ++lat) {
+      if (occupied(lon, lat)) {
+        minLonOcc = std::min(minLonOcc, lon);
+        minLatOcc = std::min(minLatOcc, lat);
+        maxLonOcc = std::max(maxLonOcc, static_cast<int16_t>(lon + 1));
+        maxLatOcc = std::max(maxLatOcc, static_cast<int16_t>(lat + 1));
+      }
+    }
+  }
+  // No nodes, so nothing to do.
+  if (minLonOcc >= maxLonOcc) {
+    return;
+  }
+  boundary = GeoBoundary(minLonOcc, minLatOcc, maxLonOcc, maxLatOcc);
+
+  // A quadratic tile of buildBoundaries() needs up to
+  // (size + 2)^2 NASADEM files in memory.
+  const uint32_t maxInMemory = (_size + 2) * (_size + 2);
+  const int16_t width = maxLon - minLon;
+  const int16_t height = maxLat - minLat;
+  if ((width == 1 && height == 1) ||
+      nasademFilesNeeded(boundary) <= maxInMemory) {
+    boundaries->push_back(boundary);
+    return;
+  }
+
+  // Split the longer side. If it is longer than the tile size, split off
+  // a multiple of the tile size, so the parts fit together like tiles.
+  const int16_t length = std::max(width, height);
+  int16_t split = length / 2;
+  if (length > _size) {
+    split = std::max(static_cast<int16_t>(_size),
+                     static_cast<int16_t>((split + _size / 2) / _size * _size));
+  }
+  if (width >= height) {
+    planBoundary(GeoBoundary(minLon, minLat, minLon + split, maxLat),
+                 boundaries);
+    planBoundary(GeoBoundary(minLon + split, minLat, maxLon, maxLat),
+                 boundaries);
+  } else {
+    planBoundary(GeoBoundary(minLon, minLat, maxLon, minLat + split),
+                 boundaries);
+    planBoundary(GeoBoundary(minLon, minLat + split, maxLon, maxLat),
+                 boundaries);
+  }
+}
+
+// ____________________________________________________________________________
+bool GeoBoundaries::occupied(const int16_t lon, const int16_t lat) const {
+  return _osmStats.tileNodeCounts[tileIndex(lon, lat)] > 0;
+}
+
+// ____________________________________________________________________________
+uint32_t GeoBoundaries::nasademFilesNeeded(const GeoBoundary& boundary) const {
+  const auto& [minLon, minLat, maxLon, maxLat] = boundary;
+  if (_osmStats.tileNodeCounts.empty()) {
+    return (maxLon - minLon + 2) * (maxLat - minLat + 2);
+  }
+  uint32_t files = 0;
+  // Check each tile in and around the boundary, if it is or is next to an
+  // occupied tile inside the boundary.
+  for (int16_t lon = minLon - 1; lon <= maxLon; ++lon) {
+    for (int16_t lat = minLat - 1; lat <= maxLat; ++lat) {
+      bool needed = false;
+      for (int16_t x = std::max(lon - 1, static_cast<int>(minLon));
+           x <= std::min(lon + 1, maxLon - 1) && !needed; ++x) {
+        for (int16_t y = std::max(lat - 1, static_cast<int>(minLat));
+             y <= std::min(lat + 1, maxLat - 1) && !needed; ++y) {
+          needed = occupied(x, y);
+        }
+      }
+      files += needed;
+    }
+  }
+  return files;
+}
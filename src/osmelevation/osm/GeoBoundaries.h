@@ -19,6 +19,8 @@ using GeoBoundary = std::tuple<int16_t, int16_t, int16_t, int16_t>;
  * Divide the given OSM boundary (given by its min and max coordinates)
  * into quadratic tiles with side length tileSize.
  * Each tile is defined by its bottom-left and top-right coordinate.
+ * If the number of nodes per 1 degree tile is known, the boundaries can
+ * instead be planned around the tiles that actually contain nodes.
  */
 class GeoBoundaries {
  public:
@@ -28,7 +30,30 @@ class GeoBoundaries {
   // coordinates of each tile. Must be at least one tile.
   std::vector<GeoBoundary> buildBoundaries() const;
 
+  // Return boundaries that only cover 1 degree tiles containing nodes.
+  // Each boundary needs at most as many NASADEM files in memory as a
+  // quadratic tile of buildBoundaries(), including the neighboring
+  // files needed for interpolation. Falls back to buildBoundaries() if
+  // the node histogram is not available.
+  std::vector<GeoBoundary> planBoundaries() const;
+
+  // The number of NASADEM files that are loaded for the nodes inside
+  // the boundary. These are the occupied tiles and their neighbors.
+  // Without the node histogram, all tiles are assumed to be occupied.
+  uint32_t nasademFilesNeeded(const GeoBoundary& boundary) const;
+
  private:
+  // Shrink the boundary to the tiles containing nodes and add it, if the
+  // NASADEM files it needs fit into memory. Otherwise split it in two
+  // along its longer side and continue with both halves.
+  void planBoundary(GeoBoundary boundary,
+                    std::vector<GeoBoundary>* boundaries) const;
+
+  // Check if the 1 degree tile with the given bottom-left corner
+  // contains at least one node.
+  bool occupied(const int16_t lon, const int16_t lat) const;
+
+
   // Side length of each quadratic tile.
   const uint8_t _size;
 
@@ -3,11 +3,13 @@
 
 #include <string>
 #include <iostream>
+#include <sstream>
 #include <tuple>
 #include "util/index/ElevationIndex.h"
 #include "util/osm/OsmStats.h"
 #include "parser/NodeParser.h"
 #include "osmelevation/elevation/GeoElevation.h"
+#include "osmelevation/elevation/Interpolation.h"
 #include "osmelevation/osm/OsmNodesHandler.h"
 #include "osmelevation/osm/GeoPartition.h"
 
@@ -16,6 +18,7 @@ using util::index::ElevationIndex;
 using util::osm::OsmStats;
 using osmelevation::osm::OsmNodesHandler;
 using osmelevation::elevation::GeoElevation;
+using osmelevation::elevation::Interpolation;
 using osmelevation::osm::GeoPartition;
 using GeoBoundary = std::tuple<int16_t, int16_t, int16_t, int16_t>;
 
@@ -24,24 +27,52 @@ GeoPartition::GeoPartition(ElevationIndex& elevationIndex,
                            const OsmStats& osmStats,
                            const std::string& inFile,
                            const std::string& nasademDir,
-                           const GeoBoundary& boundary) :
+                           const GeoBoundary& boundary,
+                           const Interpolation interpolation,
+                           const bool showProgress) :
                            _elevationIndex(elevationIndex),
                            _osmStats(osmStats),
                            _inFile(inFile),
                            _nasademDir(nasademDir),
-                           _boundary(boundary) {}
+                           _boundary(boundary),
+                           _interpolation(interpolation),
+                           _showProgress(showProgress) {}
 
 // _____________________________________________________________________________
 void GeoPartition::elevationsInPartition() {
   GeoElevation geoElevation(_nasademDir);
-  std::cout << "\nWorking on geographic partition with minlon: ";
-  std::cout << std::get<0>(_boundary) << ", ";
-  std::cout << "minlat: " << std::get<1>(_boundary) << ", ";
-  std::cout << "maxlon: " << std::get<2>(_boundary) << ", ";
-  std::cout << "maxlat: " << std::get<3>(_boundary) << std::endl;
+  // Print at once, other partitions might be worked off at the same time.
+  std::ostringstream message;
+  message << "\nWorking on geographic partition with minlon: ";
+  message << std::get<0>(_boundary) << ", ";
+  message << "minlat: " << std::get<1>(_boundary) << ", ";
+  message << "maxlon: " << std::get<2>(_boundary) << ", ";
+  message << "maxlat: " << std::get<3>(_boundary) << "\n";
+  std::cout << message.str() << std::flush;
 
-  OsmNodesHandler handler(_elevationIndex, geoElevation, _boundary);
-  NodeParser parser(_inFile, &handler, _osmStats);
-  parser.parse();
+  // Select the kernel once for the whole partition.
+  switch (_interpolation) {
+    case Interpolation::NEAREST:
+      parseNodes<Interpolation::NEAREST>(geoElevation);
+      break;
+    case Interpolation::BILINEAR:
+      parseNodes<Interpolation::BILINEAR>(geoElevation);
+      break;
+    case Interpolation::IDW:
+      parseNodes<Interpolation::IDW>(geoElevation);
+      break;
+  }
   geoElevation.clear();
 }
+
+// _____________________________________________________________________________
+template <Interpolation kernel>
+void GeoPartition::parseNodes(GeoElevation& geoElevation) {
+  OsmNodesHandler<kernel> handler(_elevationIndex, geoElevation, _boundary);
+  NodeParser parser(_inFile, &handler, _osmStats);
+  if (_showProgress) {
+    parser.parse();
+  } else {
+    parser.parseNoProgressBar();
+  }
+}
@@ -7,6 +7,7 @@
 #include <string>
 #include <tuple>
 #include "osmelevation/elevation/GeoElevation.h"
+#include "osmelevation/elevation/Interpolation.h"
 #include "util/osm/OsmStats.h"
 #include "util/index/ElevationIndex.h"
 
@@ -16,6 +17,7 @@ namespace osm {
 using util::index::ElevationIndex;
 using util::osm::OsmStats;
 using osmelevation::elevation::GeoElevation;
+using osmelevation::elevation::Interpolation;
 using GeoBoundary = std::tuple<int16_t, int16_t, int16_t, int16_t>;
 
 /*
@@ -28,13 +30,19 @@ class GeoPartition {
                const OsmStats& osmStats,
                const std::string& inFile,
                const std::string& nasademDir,
-               const GeoBoundary& boundary);
+               const GeoBoundary& boundary,
+               const Interpolation interpolation,
+               const bool showProgress);
 
   // Get the elevation of all nodes inside a geographic partition
   // using the OsmNodesHandler.
   void elevationsInPartition();
 
  private:
+  // Parse all nodes with the OsmNodesHandler using the given kernel.
+  template <Interpolation kernel>
+  void parseNodes(GeoElevation& geoElevation);
+
   // The index where the elevation data for nodes is stored.
   ElevationIndex& _elevationIndex;
 
@@ -49,6 +57,13 @@ class GeoPartition {
 
   // The boundaries of the geographic partition.
   const GeoBoundary& _boundary;
+
+  // The kernel used to interpolate the elevation of the nodes.
+  const Interpolation _interpolation;
+
+  // Show the progress bar while parsing. Not useful if several
+  // partitions are worked off at the same time.
+  const bool _showProgress;
 };
 
 }  // namespace osm
@@ -6,24 +6,30 @@
 #include <osmium/osm/node.hpp>
 #include "util/index/ElevationIndex.h"
 #include "osmelevation/elevation/GeoElevation.h"
+#include "osmelevation/elevation/Interpolation.h"
 #include "osmelevation/osm/OsmNodesHandler.h"
 
 using osmelevation::elevation::GeoElevation;
+using osmelevation::elevation::Interpolation;
 using util::index::ElevationIndex;
 using osmelevation::osm::OsmNodesHandler;
 using Partition = std::tuple<int16_t, int16_t, int16_t, int16_t>;
 
 // ____________________________________________________________________________
-OsmNodesHandler::OsmNodesHandler(ElevationIndex& elevationIndex,
-                                 GeoElevation& geoElevation,
-                                 const Partition& geoPartition) :
-                                 _elevationIndex(elevationIndex),
-                                 _geoElevation(geoElevation),
-                                 _geoPartition(geoPartition) {}
+template <Interpolation kernel>
+OsmNodesHandler<kernel>::OsmNodesHandler(ElevationIndex& elevationIndex,
+                                         GeoElevation& geoElevation,
+                                         const Partition& geoPartition) :
+                                         _elevationIndex(elevationIndex),
+                                         _geoElevation(geoElevation),
+                                         _geoPartition(geoPartition) {}
 
 // ____________________________________________________________________________
-void OsmNodesHandler::node(const osmium::Node& node) {
+template <Interpolation kernel>
+void OsmNodesHandler<kernel>::node(const osmium::Node& node) {
   ++_count;
+  // Deleted nodes of an OsmChange file have no location.
+  if (!node.visible()) { return; }
   const double lon = node.location().lon();
   const double lat = node.location().lat();
 
@@ -34,9 +40,14 @@ void OsmNodesHandler::node(const osmium::Node& node) {
       lat <= std::get<3>(_geoPartition)) {
     // Get the elevation at the node's location.
     const int16_t elevation =
-      _geoElevation.getInterpolatedElevation(Coordinate(lon, lat));
+      _geoElevation.getKernelElevation<kernel>(Coordinate(lon, lat));
 
     // Store the node's id and elevation in the elevation index.
     _elevationIndex.setElevation(node.id(), elevation);
   }
 }
+
+// Instantiate the handler for all available interpolation kernels.
+template class osmelevation::osm::OsmNodesHandler<Interpolation::NEAREST>;
+template class osmelevation::osm::OsmNodesHandler<Interpolation::BILINEAR>;
+template class osmelevation::osm::OsmNodesHandler<Interpolation::IDW>;
@@ -8,12 +8,14 @@
 #include <cstdint>
 #include "parser/OsmHandler.h"
 #include "osmelevation/elevation/GeoElevation.h"
+#include "osmelevation/elevation/Interpolation.h"
 #include "util/index/ElevationIndex.h"
 
 namespace osmelevation {
 namespace osm {
 
 using osmelevation::elevation::GeoElevation;
+using osmelevation::elevation::Interpolation;
 using util::index::ElevationIndex;
 using parser::OsmHandler;
 using Partition = std::tuple<int16_t, int16_t, int16_t, int16_t>;
@@ -27,7 +29,10 @@ using Partition = std::tuple<int16_t, int16_t, int16_t, int16_t>;
  * to work off all nodes of an OSM file.
  * This way, the order of which all nodes are being processed
  * provides a geographical clustering of the nodes.
+ * The interpolation kernel is a template parameter, such that
+ * it is resolved at compile time and not for every node.
  */
+template <Interpolation kernel = Interpolation::IDW>
 class OsmNodesHandler : public OsmHandler {
  public:
   OsmNodesHandler(ElevationIndex& elevationIndex,
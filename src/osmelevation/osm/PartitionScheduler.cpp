@@ -0,0 +1,128 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+#include "util/index/ElevationIndex.h"
+#include "util/index/ElevationIndexBuffer.h"
+#include "util/osm/OsmStats.h"
+#include "osmelevation/elevation/Interpolation.h"
+#include "osmelevation/osm/GeoPartition.h"
+#include "osmelevation/osm/PartitionScheduler.h"
+
+using util::index::ElevationIndex;
+using util::index::ElevationIndexBuffer;
+using util::osm::OsmStats;
+using osmelevation::elevation::Interpolation;
+using osmelevation::osm::GeoPartition;
+using osmelevation::osm::PartitionScheduler;
+using GeoBoundary = std::tuple<int16_t, int16_t, int16_t, int16_t>;
+
+// _____________________________________________________________________________
+PartitionScheduler::PartitionScheduler(ElevationIndex& elevationIndex,
+                                       const OsmStats& osmStats,
+                                       const std::string& inFile,
+                                       const std::string& nasademDir,
+                                       const Interpolation interpolation,
+                                       const uint32_t maxInMemory,
+                                       const uint16_t threads) :
+                                       _elevationIndex(elevationIndex),
+                                       _osmStats(osmStats),
+                                       _inFile(inFile),
+                                       _nasademDir(nasademDir),
+                                       _interpolation(interpolation),
+                                       _maxInMemory(maxInMemory),
+                                       _threads(std::max(threads,
+                                                static_cast<uint16_t>(1))) {}
+
+// _____________________________________________________________________________
+void PartitionScheduler::run(const std::vector<GeoBoundary>& boundaries,
+                             const std::vector<uint32_t>& footprints) {
+  // A single thread writes directly into the index, like before.
+  if (_threads == 1) {
+    for (const auto& boundary : boundaries) {
+      GeoPartition geoPartition(_elevationIndex, _osmStats, _inFile,
+                                _nasademDir, boundary, _interpolation, true);
+      geoPartition.elevationsInPartition();
+    }
+    return;
+  }
+
+  schedule(footprints, [&](size_t i) {
+    ElevationIndexBuffer buffer(_elevationIndex, _indexMutex);
+    GeoPartition geoPartition(buffer, _osmStats, _inFile, _nasademDir,
+                              boundaries[i], _interpolation, false);
+    geoPartition.elevationsInPartition();
+  });
+}
+
+// _____________________________________________________________________________
+void PartitionScheduler::schedule(const std::vector<uint32_t>& footprints,
+                                  const std::function<void(size_t)>& work) {
+  _next = 0;
+  _admitted = 0;
+  _inMemory = 0;
+  _error = nullptr;
+
+  const size_t threadCount = std::min(static_cast<size_t>(_threads),
+                                      footprints.size());
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount);
+  for (size_t i = 0; i < threadCount; ++i) {
+    threads.emplace_back(&PartitionScheduler::worker, this,
+                         std::cref(footprints), std::cref(work));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (_error) {
+    std::rethrow_exception(_error);
+  }
+}
+
+// _____________________________________________________________________________
+void PartitionScheduler::worker(const std::vector<uint32_t>& footprints,
+                                const std::function<void(size_t)>& work) {
+  while (true) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_next >= footprints.size()) {
+      return;
+    }
+    const size_t i = _next++;
+
+    // Wait for the turn of this partition and enough memory. A partition
+    // that doesn't fit into memory on its own runs alone.
+    _changed.wait(lock, [&] {
+      return _error || (i == _admitted && (_inMemory == 0 ||
+                        _inMemory + footprints[i] <= _maxInMemory));
+    });
+    if (_error) {
+      return;
+    }
+    ++_admitted;
+    _inMemory += footprints[i];
+    lock.unlock();
+    _changed.notify_all();
+
+    std::exception_ptr error = nullptr;
+    try {
+      work(i);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    _inMemory -= footprints[i];
+    if (error && !_error) {
+      _error = error;
+      _next = footprints.size();
+    }
+    lock.unlock();
+    _changed.notify_all();
+  }
+}
@@ -0,0 +1,108 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_OSMELEVATION_OSM_PARTITIONSCHEDULER_H_
+#define SRC_OSMELEVATION_OSM_PARTITIONSCHEDULER_H_
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <tuple>
+#include <vector>
+#include "osmelevation/elevation/Interpolation.h"
+#include "util/index/ElevationIndex.h"
+#include "util/osm/OsmStats.h"
+
+namespace osmelevation {
+namespace osm {
+
+using util::index::ElevationIndex;
+using util::osm::OsmStats;
+using osmelevation::elevation::Interpolation;
+using GeoBoundary = std::tuple<int16_t, int16_t, int16_t, int16_t>;
+
+/*
+ * Work off geographic partitions on several threads at once.
+ * Each partition needs a number of NASADEM files in memory. A partition
+ * is only started, if the NASADEM files of all running partitions
+ * together still fit into memory. Partitions are started in order.
+ * All threads write into the same elevation index.
+ */
+class PartitionScheduler {
+ public:
+  PartitionScheduler(ElevationIndex& elevationIndex,
+                     const OsmStats& osmStats,
+                     const std::string& inFile,
+                     const std::string& nasademDir,
+                     const Interpolation interpolation,
+                     const uint32_t maxInMemory,
+                     const uint16_t threads);
+
+  // Get the elevation of all nodes in all partitions. The footprint of a
+  // partition is the number of NASADEM files it needs in memory.
+  void run(const std::vector<GeoBoundary>& boundaries,
+           const std::vector<uint32_t>& footprints);
+
+  // Run the work for each footprint on the threads, with the same
+  // admission as for the partitions. Work gets the index of the footprint.
+  // If any work throws, no further work is started and the first
+  // exception is rethrown when all threads are done.
+  void schedule(const std::vector<uint32_t>& footprints,
+                const std::function<void(size_t)>& work);
+
+ private:
+  // Take the next footprint, wait until it fits into memory and
+  // do the work. Repeat until all footprints are done.
+  void worker(const std::vector<uint32_t>& footprints,
+              const std::function<void(size_t)>& work);
+
+  // The index where the elevation data for nodes is stored.
+  ElevationIndex& _elevationIndex;
+
+  // Statistics about the input OSM file.
+  const OsmStats& _osmStats;
+
+  // The input OSM file.
+  const std::string& _inFile;
+
+  // The directory where all NASADEM files are located.
+  const std::string& _nasademDir;
+
+  // The kernel used to interpolate the elevation of the nodes.
+  const Interpolation _interpolation;
+
+  // The number of NASADEM files that fit into memory at the same time.
+  const uint32_t _maxInMemory;
+
+  // The maximum number of partitions worked off at the same time.
+  const uint16_t _threads;
+
+  // Guards the admission state below.
+  std::mutex _mutex;
+
+  // Notified whenever a partition was started or is done.
+  std::condition_variable _changed;
+
+  // The next footprint to be taken by a thread.
+  size_t _next;
+
+  // The next footprint to be started, to start them in order.
+  size_t _admitted;
+
+  // The number of NASADEM files in memory of the running partitions.
+  uint32_t _inMemory;
+
+  // The first exception thrown by any work.
+  std::exception_ptr _error;
+
+  // Guards writing into the elevation index.
+  std::mutex _indexMutex;
+};
+
+}  // namespace osm
+}  // namespace osmelevation
+
+#endif  // SRC_OSMELEVATION_OSM_PARTITIONSCHEDULER_H_
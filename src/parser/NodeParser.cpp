@@ -7,11 +7,13 @@
 #include "util/console/Console.h"
 #include "util/osm/OsmStats.h"
 #include "parser/OsmHandler.h"
+#include "parser/PbfBlockInput.h"
 #include "parser/NodeParser.h"
 
 using util::console::ProgressBar;
 using util::osm::OsmStats;
 using parser::OsmHandler;
+using parser::PbfBlockInput;
 using parser::NodeParser;
 
 // ____________________________________________________________________________
@@ -24,8 +26,9 @@ NodeParser::NodeParser(const std::string& osmFile,
 
 // ____________________________________________________________________________
 void NodeParser::parse() {
-  osmium::io::File input_file{_osmFile};
-  osmium::io::Reader reader{input_file, osmium::osm_entity_bits::node};
+  // Only read the blocks containing nodes, if the file allows it.
+  PbfBlockInput input{_osmFile, osmium::osm_entity_bits::node};
+  osmium::io::Reader reader{input.file(), osmium::osm_entity_bits::node};
 
   // Initialize progress bar.
   ProgressBar progressBar(_osmStats.nodeCount);
@@ -43,8 +46,9 @@ void NodeParser::parse() {
 
 // ____________________________________________________________________________
 void NodeParser::parseNoProgressBar() {
-  osmium::io::File input_file{_osmFile};
-  osmium::io::Reader reader{input_file, osmium::osm_entity_bits::node};
+  // Only read the blocks containing nodes, if the file allows it.
+  PbfBlockInput input{_osmFile, osmium::osm_entity_bits::node};
+  osmium::io::Reader reader{input.file(), osmium::osm_entity_bits::node};
 
   // OSM data comes in buffers, read until there are no more.
   while (osmium::memory::Buffer buffer = reader.read()) {
@@ -0,0 +1,322 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "parser/PbfBlockIndex.h"
+
+using parser::PbfBlockIndex;
+using parser::PBF_SORTED_FEATURE;
+
+namespace {
+
+// Blob headers are limited to 64KB by the PBF format.
+constexpr uint32_t MAX_BLOB_HEADER_SIZE = 64 * 1024;
+
+// Protobuf wire types.
+constexpr uint32_t WIRE_VARINT = 0;
+constexpr uint32_t WIRE_FIXED64 = 1;
+constexpr uint32_t WIRE_BYTES = 2;
+constexpr uint32_t WIRE_FIXED32 = 5;
+
+/*
+ * Minimal reader of protobuf messages, just enough for the few fields of
+ * the blob headers, blobs and blocks the index needs.
+ */
+class ProtoReader {
+ public:
+  explicit ProtoReader(std::string_view message) :
+    _pos(message.data()), _end(message.data() + message.size()) {}
+
+  // Read the key of the next field, return false at the end of the message.
+  bool next(uint32_t* field, uint32_t* wireType) {
+    if (_pos == _end) { return false; }
+    const uint64_t key = varint();
+    *field = key >> 3;
+    *wireType = key & 0x07;
+    return true;
+  }
+
+  uint64_t varint() {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+      if (_pos == _end) { break; }
+      const uint8_t byte = *_pos++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) { return value; }
+    }
+    throw std::runtime_error("Invalid varint in PBF file.");
+  }
+
+  std::string_view bytes() {
+    const uint64_t size = varint();
+    if (size > static_cast<uint64_t>(_end - _pos)) {
+      throw std::runtime_error("Invalid length in PBF file.");
+    }
+    std::string_view value(_pos, size);
+    _pos += size;
+    return value;
+  }
+
+  void skip(const uint32_t wireType) {
+    uint64_t size = 0;
+    switch (wireType) {
+      case WIRE_VARINT: varint(); return;
+      case WIRE_BYTES: bytes(); return;
+      case WIRE_FIXED64: size = 8; break;
+      case WIRE_FIXED32: size = 4; break;
+      default: throw std::runtime_error("Invalid wire type in PBF file.");
+    }
+    if (size > static_cast<uint64_t>(_end - _pos)) {
+      throw std::runtime_error("Invalid length in PBF file.");
+    }
+    _pos += size;
+  }
+
+ private:
+  const char* _pos;
+  const char* _end;
+};
+
+// ____________________________________________________________________________
+std::string decompressBlob(std::string_view blob) {
+  ProtoReader reader(blob);
+  uint32_t field, wireType;
+  uint64_t rawSize = 0;
+  std::string_view zlibData;
+  while (reader.next(&field, &wireType)) {
+    if (field == 1 && wireType == WIRE_BYTES) {
+      return std::string(reader.bytes());
+    } else if (field == 2 && wireType == WIRE_VARINT) {
+      rawSize = reader.varint();
+    } else if (field == 3 && wireType == WIRE_BYTES) {
+      zlibData = reader.bytes();
+    } else if (field >= 4 && field <= 7) {
+      throw std::runtime_error("Unsupported compression in PBF file.");
+    } else {
+      reader.skip(wireType);
+    }
+  }
+  std::string raw(rawSize, '\0');
+  uLongf size = rawSize;
+  if (uncompress(reinterpret_cast<Bytef*>(raw.data()), &size,
+                 reinterpret_cast<const Bytef*>(zlibData.data()),
+                 zlibData.size()) != Z_OK || size != rawSize) {
+    throw std::runtime_error("Invalid compressed block in PBF file.");
+  }
+  return raw;
+}
+
+// ____________________________________________________________________________
+bool isSortedByTypeThenId(std::string_view headerBlock) {
+  ProtoReader reader(headerBlock);
+  uint32_t field, wireType;
+  while (reader.next(&field, &wireType)) {
+    if (field == 5 && wireType == WIRE_BYTES) {
+      if (reader.bytes() == PBF_SORTED_FEATURE) { return true; }
+    } else {
+      reader.skip(wireType);
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+PbfBlockIndex::PbfBlockIndex(const std::string& osmFile) :
+    _fd(-1), _valid(false), _headerSize(0), _firstWay(0), _endNodes(0),
+    _firstRelation(0), _endWays(0) {
+  _fd = open(osmFile.c_str(), O_RDONLY);
+  struct stat fileStat;
+  if (_fd < 0 || fstat(_fd, &fileStat) != 0) {
+    if (_fd >= 0) { close(_fd); }
+    return;
+  }
+  const uint64_t fileSize = fileStat.st_size;
+  try {
+    // The file must start with a header that promises sorted data.
+    uint64_t size;
+    std::string type;
+    std::string data;
+    if (!readBlob(0, &size, &type, &data) || type != "OSMHeader" ||
+        !isSortedByTypeThenId(decompressBlob(data))) {
+      throw std::runtime_error("No PBF file sorted by type, then ID.");
+    }
+    _headerSize = size;
+    // Only the blob headers are needed to find all blocks.
+    uint64_t offset = size;
+    while (offset < fileSize) {
+      if (!readBlob(offset, &size, &type, nullptr) ||
+          offset + size > fileSize) {
+        throw std::runtime_error("Incomplete block in PBF file.");
+      }
+      if (type == "OSMData") {
+        _offsets.push_back(offset);
+      }
+      offset += size;
+    }
+    _offsets.push_back(fileSize);
+
+    _firstWay = firstBlockOfType(3, true, 0);
+    _endNodes = firstBlockOfType(3, false, _firstWay);
+    _firstRelation = firstBlockOfType(4, true, _firstWay);
+    _endWays = firstBlockOfType(4, false, _firstRelation);
+    _valid = true;
+  } catch (const std::runtime_error&) {
+    // Read the whole file instead.
+    _valid = false;
+    _offsets.clear();
+  }
+  close(_fd);
+  _fd = -1;
+}
+
+// ____________________________________________________________________________
+bool PbfBlockIndex::readBlob(const uint64_t offset, uint64_t* size,
+                             std::string* type, std::string* data) const {
+  // The blob header size as 4 byte big-endian integer.
+  unsigned char sizeBytes[4];
+  if (pread(_fd, sizeBytes, 4, offset) != 4) { return false; }
+  const uint32_t headerSize = (sizeBytes[0] << 24) | (sizeBytes[1] << 16) |
+                              (sizeBytes[2] << 8) | sizeBytes[3];
+  if (headerSize > MAX_BLOB_HEADER_SIZE) { return false; }
+
+  std::string header(headerSize, '\0');
+  if (pread(_fd, header.data(), headerSize, offset + 4) !=
+      static_cast<ssize_t>(headerSize)) {
+    return false;
+  }
+  ProtoReader reader(header);
+  uint32_t field, wireType;
+  uint64_t dataSize = 0;
+  type->clear();
+  while (reader.next(&field, &wireType)) {
+    if (field == 1 && wireType == WIRE_BYTES) {
+      *type = reader.bytes();
+    } else if (field == 3 && wireType == WIRE_VARINT) {
+      dataSize = reader.varint();
+    } else {
+      reader.skip(wireType);
+    }
+  }
+  *size = 4 + headerSize + dataSize;
+
+  if (data) {
+    data->resize(dataSize);
+    if (pread(_fd, data->data(), dataSize, offset + 4 + headerSize) !=
+        static_cast<ssize_t>(dataSize)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+std::pair<uint32_t, uint32_t> PbfBlockIndex::blockTypes(
+    const size_t block) const {
+  // The last entry of the offsets is the file size, not a block.
+  for (size_t next = block; next + 1 < _offsets.size(); ++next) {
+    uint64_t size;
+    std::string type;
+    std::string data;
+    if (!readBlob(_offsets[next], &size, &type, &data)) {
+      throw std::runtime_error("Incomplete block in PBF file.");
+    }
+    const std::string primitiveBlock = decompressBlob(data);
+    ProtoReader reader(primitiveBlock);
+    uint32_t field, wireType;
+    bool found = false;
+    std::pair<uint32_t, uint32_t> types;
+    while (reader.next(&field, &wireType)) {
+      // A primitive group holds a single type, its first field tells it.
+      if (field == 2 && wireType == WIRE_BYTES) {
+        ProtoReader groupReader(reader.bytes());
+        if (groupReader.next(&field, &wireType)) {
+          if (!found) { types.first = field; }
+          types.second = field;
+          found = true;
+        }
+      } else {
+        reader.skip(wireType);
+      }
+    }
+    if (found) {
+      return types;
+    }
+  }
+  // Only blocks without any entities follow.
+  return { UINT32_MAX, UINT32_MAX };
+}
+
+// ____________________________________________________________________________
+size_t PbfBlockIndex::firstBlockOfType(const uint32_t type, const bool last,
+                                       const size_t first) const {
+  // The last entry of the offsets is the file size, not a block.
+  size_t low = first;
+  size_t high = _offsets.size() - 1;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    const auto types = blockTypes(middle);
+    if ((last ? types.second : types.first) < type) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+// ____________________________________________________________________________
+bool PbfBlockIndex::valid() const {
+  return _valid;
+}
+
+// ____________________________________________________________________________
+uint64_t PbfBlockIndex::headerSize() const {
+  return _headerSize;
+}
+
+// ____________________________________________________________________________
+size_t PbfBlockIndex::blockCount() const {
+  return _offsets.empty() ? 0 : _offsets.size() - 1;
+}
+
+// ____________________________________________________________________________
+std::pair<uint64_t, uint64_t> PbfBlockIndex::range(
+    const osmium::osm_entity_bits::type types) const {
+  const bool nodes = types & osmium::osm_entity_bits::node;
+  const bool ways = types & osmium::osm_entity_bits::way;
+  const bool relations = types & osmium::osm_entity_bits::relation;
+  if (!nodes && !ways && !relations) {
+    return { headerSize(), headerSize() };
+  }
+  // Changesets and anything else come after the relations.
+  const size_t begin = nodes ? 0 : (ways ? _firstWay : _firstRelation);
+  const size_t end = relations ? _offsets.size() - 1
+                               : (ways ? _endWays : _endNodes);
+  return { _offsets[begin], _offsets[end] };
+}
+
+// ____________________________________________________________________________
+const PbfBlockIndex& PbfBlockIndex::get(const std::string& osmFile) {
+  static std::mutex mutex;
+  static std::map<std::string, std::unique_ptr<PbfBlockIndex>> indexes;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& index = indexes[osmFile];
+  if (!index) {
+    index = std::make_unique<PbfBlockIndex>(osmFile);
+  }
+  return *index;
+}
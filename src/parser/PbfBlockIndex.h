@@ -0,0 +1,95 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_PARSER_PBFBLOCKINDEX_H_
+#define SRC_PARSER_PBFBLOCKINDEX_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <osmium/osm/entity_bits.hpp>
+
+namespace parser {
+
+// Optional feature of the PBF header block of files sorted by type, then ID.
+constexpr char PBF_SORTED_FEATURE[] = "Sort.Type_then_ID";
+
+/*
+ * Index of the data blocks (blobs) of an OSM PBF file.
+ * Only the blob headers are read to get the offset of each block. In a file
+ * sorted by type, then ID, all nodes come before all ways and all ways
+ * before all relations, but a block may hold groups of several types. The
+ * first and last block of each type are then found with binary searches
+ * over the types of the first and last group of the blocks, decompressing
+ * only a few blocks. A block with several types is in the range of each of
+ * them; the reader skips the entities of the other types.
+ * This way, a pass over a single entity type reads only the byte range of
+ * its blocks, see PbfBlockInput.
+ * For any other file (not PBF, not sorted or not zlib compressed), the
+ * index is not valid and the whole file has to be read.
+ */
+class PbfBlockIndex {
+ public:
+  explicit PbfBlockIndex(const std::string& osmFile);
+
+  // Whether the byte ranges of the entity types are known.
+  bool valid() const;
+
+  // Size of the header block at the beginning of the file, which any
+  // reader needs before the data blocks.
+  uint64_t headerSize() const;
+
+  // Number of data blocks.
+  size_t blockCount() const;
+
+  // The byte range [begin, end) of the data blocks containing entities of
+  // the given types. Only valid if valid() is true.
+  std::pair<uint64_t, uint64_t> range(
+      const osmium::osm_entity_bits::type types) const;
+
+  // The index of the given file, built on first use and then shared by
+  // all passes over the file.
+  static const PbfBlockIndex& get(const std::string& osmFile);
+
+ private:
+  // The entity types of the first and the last group in a data block, as
+  // field numbers of the PrimitiveGroup message (1 and 2 nodes, 3 ways,
+  // 4 relations). A block without entities has the types of the next block
+  // with entities, such that the types stay ordered, or the maximum if
+  // there is none.
+  std::pair<uint32_t, uint32_t> blockTypes(const size_t block) const;
+
+  // Read the blob header at the given offset. Set the total size of the
+  // blob and its type, and if data is given, also read the blob data.
+  // Return false if the blob is not complete.
+  bool readBlob(const uint64_t offset, uint64_t* size, std::string* type,
+                std::string* data) const;
+
+  // Find the first block whose first type (or last type if last is true)
+  // is not less than the given one, starting at the given block.
+  size_t firstBlockOfType(const uint32_t type, const bool last,
+                          const size_t first) const;
+
+  // Only open while the index is built.
+  int _fd;
+
+  bool _valid;
+
+  uint64_t _headerSize;
+
+  // Offset of each data block, followed by the file size.
+  std::vector<uint64_t> _offsets;
+
+  // Index of the first block with ways and of the block after the last
+  // block with nodes, the same for the ways and relations.
+  size_t _firstWay;
+  size_t _endNodes;
+
+  size_t _firstRelation;
+  size_t _endWays;
+};
+
+}  // namespace parser
+
+#endif  // SRC_PARSER_PBFBLOCKINDEX_H_
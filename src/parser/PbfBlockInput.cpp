@@ -0,0 +1,93 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+#include <cstdint>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <osmium/io/file.hpp>
+#include "parser/PbfBlockIndex.h"
+#include "parser/PbfBlockInput.h"
+
+using parser::PbfBlockIndex;
+using parser::PbfBlockInput;
+
+// ____________________________________________________________________________
+PbfBlockInput::PbfBlockInput(const std::string& osmFile,
+                             const osmium::osm_entity_bits::type types) :
+                             _osmFile(osmFile),
+                             _pipe{-1, -1} {
+  const PbfBlockIndex& index = PbfBlockIndex::get(_osmFile);
+  if (!index.valid()) {
+    return;
+  }
+  const auto range = index.range(types);
+  // Nothing to skip, read the file as it is.
+  if (range == index.range(osmium::osm_entity_bits::nwr)) {
+    return;
+  }
+  if (pipe(_pipe) != 0) {
+    _pipe[0] = _pipe[1] = -1;
+    return;
+  }
+  _feeder = std::thread(&PbfBlockInput::feed, this, index.headerSize(),
+                        range.first, range.second);
+}
+
+// ____________________________________________________________________________
+PbfBlockInput::~PbfBlockInput() {
+  if (_pipe[0] < 0) {
+    return;
+  }
+  // If the reader stopped early, closing the read end lets the feeder fail
+  // instead of waiting for the pipe to be drained.
+  close(_pipe[0]);
+  _feeder.join();
+}
+
+// ____________________________________________________________________________
+osmium::io::File PbfBlockInput::file() const {
+  if (_pipe[0] < 0) {
+    return osmium::io::File{_osmFile};
+  }
+  return osmium::io::File{"/dev/fd/" + std::to_string(_pipe[0]), "pbf"};
+}
+
+// ____________________________________________________________________________
+bool PbfBlockInput::skipsBlocks() const {
+  return _pipe[0] >= 0;
+}
+
+// ____________________________________________________________________________
+void PbfBlockInput::feed(const uint64_t headerSize, const uint64_t begin,
+                         const uint64_t end) {
+  // A reader that stops early must not kill the program with SIGPIPE.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  const int fd = open(_osmFile.c_str(), O_RDONLY);
+  // Copy a byte range of the file to the pipe, without copying the data
+  // to user space.
+  auto sendRange = [this, fd](off_t offset, const off_t last) {
+    while (offset < last) {
+      if (sendfile(_pipe[1], fd, &offset, last - offset) <= 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (fd >= 0) {
+    if (sendRange(0, headerSize)) {
+      sendRange(begin, end);
+    }
+    close(fd);
+  }
+  // The reader sees the end of the file.
+  close(_pipe[1]);
+}
@@ -0,0 +1,54 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_PARSER_PBFBLOCKINPUT_H_
+#define SRC_PARSER_PBFBLOCKINPUT_H_
+
+#include <cstdint>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <osmium/io/file.hpp>
+#include <osmium/osm/entity_bits.hpp>
+
+namespace parser {
+
+/*
+ * The input of a pass over only some entity types of an OSM file.
+ * If the block index of the file is valid, a pipe is fed with the header
+ * block and the byte range of the blocks containing these types, such that
+ * osmium never reads (and decompresses) the other blocks. Otherwise, the
+ * input is the whole file.
+ * The input must outlive the osmium reader reading from it.
+ */
+class PbfBlockInput {
+ public:
+  PbfBlockInput(const std::string& osmFile,
+                const osmium::osm_entity_bits::type types);
+
+  ~PbfBlockInput();
+
+  PbfBlockInput(const PbfBlockInput&) = delete;
+  PbfBlockInput& operator=(const PbfBlockInput&) = delete;
+
+  // The file to be read by osmium.
+  osmium::io::File file() const;
+
+  // Whether only the blocks of the entity types are read.
+  bool skipsBlocks() const;
+
+ private:
+  // Write the header and the blocks to the pipe.
+  void feed(const uint64_t headerSize, const uint64_t begin,
+            const uint64_t end);
+
+  const std::string _osmFile;
+
+  // The read and write end of the pipe, -1 if the whole file is read.
+  int _pipe[2];
+
+  std::thread _feeder;
+};
+
+}  // namespace parser
+
+#endif  // SRC_PARSER_PBFBLOCKINPUT_H_
@@ -7,11 +7,13 @@
 #include "util/console/Console.h"
 #include "util/osm/OsmStats.h"
 #include "parser/OsmHandler.h"
+#include "parser/PbfBlockInput.h"
 #include "parser/RelationParser.h"
 
 using util::console::ProgressBar;
 using util::osm::OsmStats;
 using parser::OsmHandler;
+using parser::PbfBlockInput;
 using parser::RelationParser;
 
 // ____________________________________________________________________________
@@ -24,8 +26,9 @@ RelationParser::RelationParser(const std::string& osmFile,
 
 // ____________________________________________________________________________
 void RelationParser::parse() {
-  osmium::io::File input_file{_osmFile};
-  osmium::io::Reader reader{input_file, osmium::osm_entity_bits::relation};
+  // Only read the blocks containing relations, if the file allows it.
+  PbfBlockInput input{_osmFile, osmium::osm_entity_bits::relation};
+  osmium::io::Reader reader{input.file(), osmium::osm_entity_bits::relation};
 
   // Initialize progress bar.
   ProgressBar progressBar(_osmStats.nodeCount);
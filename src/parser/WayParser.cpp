@@ -7,11 +7,13 @@
 #include "util/console/Console.h"
 #include "util/osm/OsmStats.h"
 #include "parser/OsmHandler.h"
+#include "parser/PbfBlockInput.h"
 #include "parser/WayParser.h"
 
 using util::console::ProgressBar;
 using util::osm::OsmStats;
 using parser::OsmHandler;
+using parser::PbfBlockInput;
 using parser::WayParser;
 
 // ____________________________________________________________________________
@@ -24,8 +26,9 @@ WayParser::WayParser(const std::string& osmFile,
 
 // ____________________________________________________________________________
 void WayParser::parse() {
-  osmium::io::File input_file{_osmFile};
-  osmium::io::Reader reader{input_file, osmium::osm_entity_bits::way};
+  // Only read the blocks containing ways, if the file allows it.
+  PbfBlockInput input{_osmFile, osmium::osm_entity_bits::way};
+  osmium::io::Reader reader{input.file(), osmium::osm_entity_bits::way};
 
   // Initialize progress bar.
   ProgressBar progressBar(_osmStats.wayCount);
@@ -43,8 +46,9 @@ void WayParser::parse() {
 
 // ____________________________________________________________________________
 void WayParser::parseNoProgressBar() {
-  osmium::io::File input_file{_osmFile};
-  osmium::io::Reader reader{input_file, osmium::osm_entity_bits::way};
+  // Only read the blocks containing ways, if the file allows it.
+  PbfBlockInput input{_osmFile, osmium::osm_entity_bits::way};
+  osmium::io::Reader reader{input.file(), osmium::osm_entity_bits::way};
 
   // OSM data comes in buffers, read until there are no more.
   while (osmium::memory::Buffer buffer = reader.read()) {
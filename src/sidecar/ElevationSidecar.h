@@ -0,0 +1,53 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_SIDECAR_ELEVATIONSIDECAR_H_
+#define SRC_SIDECAR_ELEVATIONSIDECAR_H_
+
+#include <cstdint>
+
+namespace sidecar {
+
+/*
+ * The binary elevation sidecar file stores the elevation of nodes
+ * without the rest of the OSM data. All integers are little endian.
+ *
+ * Header:  8 bytes magic "OSMELEV" followed by the format version,
+ *          8 bytes number of nodes.
+ * Nodes:   Sorted by node ID. For each node the difference to the ID
+ *          of the previous node as varint, then the difference to the
+ *          elevation of the previous node as zigzag encoded varint.
+ *          The first node is compared to ID 0 and elevation 0.
+ */
+static const char SIDECAR_MAGIC[8] = { 'O', 'S', 'M', 'E', 'L', 'E', 'V', 1 };
+static const uint8_t SIDECAR_HEADER_SIZE = 16;
+
+// Maximum number of bytes of a varint encoded 64-bit integer.
+static const uint8_t MAX_VARINT_SIZE = 10;
+
+// Write the value as varint, 7 bits per byte with the highest bit set
+// if more bytes follow. Return the number of bytes written.
+inline uint8_t encodeVarint(uint64_t value, uint8_t* out) {
+  uint8_t size = 0;
+  while (value >= 0x80) {
+    out[size++] = static_cast<uint8_t>(value) | 0x80;
+    value >>= 7;
+  }
+  out[size++] = static_cast<uint8_t>(value);
+  return size;
+}
+
+// Map signed to unsigned integers, so small absolute values
+// get small varints.
+inline uint64_t encodeZigzag(const int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ (value >> 63);
+}
+
+// ____________________________________________________________________________
+inline int64_t decodeZigzag(const uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+}  // namespace sidecar
+
+#endif  // SRC_SIDECAR_ELEVATIONSIDECAR_H_
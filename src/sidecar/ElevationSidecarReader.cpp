@@ -0,0 +1,81 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "sidecar/ElevationSidecar.h"
+#include "sidecar/ElevationSidecarReader.h"
+
+using sidecar::ElevationSidecarReader;
+using sidecar::SIDECAR_MAGIC;
+using sidecar::SIDECAR_HEADER_SIZE;
+using sidecar::decodeZigzag;
+
+// Size of the buffer holding the bytes read from the file.
+static const size_t BUFFER_SIZE = 1 << 20;
+
+// ____________________________________________________________________________
+ElevationSidecarReader::ElevationSidecarReader(const std::string& file) :
+    _in(file, std::ios::binary), _buffer(BUFFER_SIZE), _position(0),
+    _size(0), _count(0), _read(0), _previousId(0), _previousElevation(0) {
+  if (!_in) {
+    throw std::runtime_error("Could not open the sidecar file " + file);
+  }
+  char header[SIDECAR_HEADER_SIZE];
+  _in.read(header, SIDECAR_HEADER_SIZE);
+  if (_in.gcount() != SIDECAR_HEADER_SIZE ||
+      std::memcmp(header, SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC))) {
+    throw std::runtime_error("Not a binary elevation sidecar file: " + file);
+  }
+  for (uint8_t i = 0; i < 8; ++i) {
+    _count |= static_cast<uint64_t>(
+      static_cast<uint8_t>(header[sizeof(SIDECAR_MAGIC) + i])) << (8 * i);
+  }
+}
+
+// ____________________________________________________________________________
+uint64_t ElevationSidecarReader::getCount() const {
+  return _count;
+}
+
+// ____________________________________________________________________________
+bool ElevationSidecarReader::next(uint64_t* nodeId, int16_t* elevation) {
+  if (_read == _count) {
+    return false;
+  }
+  _previousId += readVarint();
+  _previousElevation += decodeZigzag(readVarint());
+  ++_read;
+  *nodeId = _previousId;
+  *elevation = _previousElevation;
+  return true;
+}
+
+// ____________________________________________________________________________
+uint64_t ElevationSidecarReader::readVarint() {
+  uint64_t value = 0;
+  for (uint8_t shift = 0; shift < 64; shift += 7) {
+    const uint8_t byte = readByte();
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+  throw std::runtime_error("Invalid varint in the sidecar file.");
+}
+
+// ____________________________________________________________________________
+uint8_t ElevationSidecarReader::readByte() {
+  if (_position == _size) {
+    _in.read(_buffer.data(), _buffer.size());
+    _size = _in.gcount();
+    _position = 0;
+    if (_size == 0) {
+      throw std::runtime_error("Unexpected end of the sidecar file.");
+    }
+  }
+  return static_cast<uint8_t>(_buffer[_position++]);
+}
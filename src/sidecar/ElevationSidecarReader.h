@@ -0,0 +1,57 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_SIDECAR_ELEVATIONSIDECARREADER_H_
+#define SRC_SIDECAR_ELEVATIONSIDECARREADER_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace sidecar {
+
+/*
+ * Read the nodes of a binary elevation sidecar file one after
+ * another, ordered by node ID. Doesn't depend on any OSM library,
+ * so it can be used by any consumer of the elevation data.
+ */
+class ElevationSidecarReader {
+ public:
+  // Open the file and read the header. Throws if the file can't be
+  // opened or is not a binary elevation sidecar file.
+  explicit ElevationSidecarReader(const std::string& file);
+
+  // The number of nodes in the file.
+  uint64_t getCount() const;
+
+  // Read the next node. Return false if there are no more nodes.
+  // Throws if the file ends before all nodes were read.
+  bool next(uint64_t* nodeId, int16_t* elevation);
+
+ private:
+  // Read a varint from the file.
+  uint64_t readVarint();
+
+  // Read the next byte from the file, refilling the buffer if needed.
+  uint8_t readByte();
+
+  std::ifstream _in;
+
+  // Holds the bytes read from the file, but not yet decoded.
+  std::vector<char> _buffer;
+  size_t _position;
+  size_t _size;
+
+  // The number of nodes in the file and already read.
+  uint64_t _count;
+  uint64_t _read;
+
+  // The node ID and elevation of the previously read node.
+  uint64_t _previousId;
+  int16_t _previousElevation;
+};
+
+}  // namespace sidecar
+
+#endif  // SRC_SIDECAR_ELEVATIONSIDECARREADER_H_
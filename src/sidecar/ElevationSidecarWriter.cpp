@@ -0,0 +1,128 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "util/index/ElevationIndex.h"
+#include "sidecar/ElevationSidecar.h"
+#include "sidecar/OutputFormat.h"
+#include "sidecar/ElevationSidecarWriter.h"
+
+using util::index::ElevationIndex;
+using sidecar::ElevationSidecarWriter;
+using sidecar::OutputFormat;
+using sidecar::SIDECAR_MAGIC;
+using sidecar::SIDECAR_HEADER_SIZE;
+using sidecar::MAX_VARINT_SIZE;
+using sidecar::encodeVarint;
+using sidecar::encodeZigzag;
+
+// Size of the buffer collecting the encoded nodes.
+static const size_t BUFFER_SIZE = 1 << 20;
+
+// ____________________________________________________________________________
+ElevationSidecarWriter::ElevationSidecarWriter(
+    const std::string& outFile,
+    const ElevationIndex* elevationIndex,
+    const OutputFormat format) :
+    _outFile(outFile),
+    _elevationIndex(elevationIndex),
+    _format(format),
+    _previousId(0),
+    _previousElevation(0) {}
+
+// ____________________________________________________________________________
+uint64_t ElevationSidecarWriter::write() {
+  time_t start, end;
+  start = time(&start);
+  std::cout << "\nWriting the elevations to the sidecar file ";
+  std::cout << _outFile << std::endl;
+
+  _out.open(_outFile, std::ios::binary);
+  if (!_out) {
+    throw std::runtime_error("Could not open the sidecar file " + _outFile);
+  }
+  _buffer.reserve(BUFFER_SIZE);
+  _previousId = 0;
+  _previousElevation = 0;
+
+  uint64_t count = 0;
+  if (_format == OutputFormat::CSV) {
+    const std::string header = "id,elevation\n";
+    _buffer.insert(_buffer.end(), header.begin(), header.end());
+    _elevationIndex->forEachElevation([&](uint64_t id, int16_t elevation) {
+      writeCsv(id, elevation);
+      ++count;
+    });
+    flush(true);
+  } else {
+    // The number of nodes is only known at the end, fill it in later.
+    _buffer.resize(SIDECAR_HEADER_SIZE, 0);
+    std::copy(SIDECAR_MAGIC, SIDECAR_MAGIC + sizeof(SIDECAR_MAGIC),
+              _buffer.begin());
+    _elevationIndex->forEachElevation([&](uint64_t id, int16_t elevation) {
+      writeBinary(id, elevation);
+      ++count;
+    });
+    flush(true);
+
+    char countBytes[8];
+    for (uint8_t i = 0; i < 8; ++i) {
+      countBytes[i] = static_cast<char>(count >> (8 * i));
+    }
+    _out.seekp(sizeof(SIDECAR_MAGIC));
+    _out.write(countBytes, sizeof(countBytes));
+  }
+  _out.close();
+  if (!_out) {
+    throw std::runtime_error("Could not write the sidecar file " + _outFile);
+  }
+
+  end = time(&end);
+  double timeDiff = difftime(end, start);
+  std::cout << "Done, wrote the elevation of " << count << " nodes, took ";
+  std::cout << timeDiff;
+  std::cout << " seconds." << "\n" << std::endl;
+  return count;
+}
+
+// ____________________________________________________________________________
+void ElevationSidecarWriter::writeBinary(const uint64_t nodeId,
+                                         const int16_t elevation) {
+  uint8_t bytes[2 * MAX_VARINT_SIZE];
+  uint8_t size = encodeVarint(nodeId - _previousId, bytes);
+  size += encodeVarint(encodeZigzag(elevation - _previousElevation),
+                       bytes + size);
+  _buffer.insert(_buffer.end(), bytes, bytes + size);
+  _previousId = nodeId;
+  _previousElevation = elevation;
+  flush(false);
+}
+
+// ____________________________________________________________________________
+void ElevationSidecarWriter::writeCsv(const uint64_t nodeId,
+                                      const int16_t elevation) {
+  // At most 20 digits for the ID, a comma, 6 characters for the
+  // elevation and the newline.
+  char line[32];
+  char* end = std::to_chars(line, line + sizeof(line), nodeId).ptr;
+  *end++ = ',';
+  end = std::to_chars(end, line + sizeof(line), elevation).ptr;
+  *end++ = '\n';
+  _buffer.insert(_buffer.end(), line, end);
+  flush(false);
+}
+
+// ____________________________________________________________________________
+void ElevationSidecarWriter::flush(const bool force) {
+  if (force || _buffer.size() >= BUFFER_SIZE - 64) {
+    _out.write(_buffer.data(), _buffer.size());
+    _buffer.clear();
+  }
+}
@@ -0,0 +1,58 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_SIDECAR_ELEVATIONSIDECARWRITER_H_
+#define SRC_SIDECAR_ELEVATIONSIDECARWRITER_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "util/index/ElevationIndex.h"
+#include "sidecar/OutputFormat.h"
+
+namespace sidecar {
+
+using util::index::ElevationIndex;
+
+/*
+ * Write the elevations of a processed elevation index into a sidecar
+ * file, either binary (see ElevationSidecar.h) or as CSV with a header
+ * line "id,elevation". Nodes without elevation are left out.
+ */
+class ElevationSidecarWriter {
+ public:
+  ElevationSidecarWriter(const std::string& outFile,
+                         const ElevationIndex* elevationIndex,
+                         const OutputFormat format);
+
+  // Write the sidecar file and return the number of nodes written.
+  uint64_t write();
+
+ private:
+  // Write the node ID and elevation of a node.
+  void writeBinary(const uint64_t nodeId, const int16_t elevation);
+  void writeCsv(const uint64_t nodeId, const int16_t elevation);
+
+  // Write the buffer to the file if it is almost full, or if forced.
+  void flush(const bool force);
+
+  const std::string& _outFile;
+
+  const ElevationIndex* _elevationIndex;
+
+  const OutputFormat _format;
+
+  std::ofstream _out;
+
+  // Collects the encoded nodes before writing them to the file.
+  std::vector<char> _buffer;
+
+  // The node ID and elevation of the previously written node.
+  uint64_t _previousId;
+  int16_t _previousElevation;
+};
+
+}  // namespace sidecar
+
+#endif  // SRC_SIDECAR_ELEVATIONSIDECARWRITER_H_
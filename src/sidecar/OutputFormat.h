@@ -0,0 +1,29 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_SIDECAR_OUTPUTFORMAT_H_
+#define SRC_SIDECAR_OUTPUTFORMAT_H_
+
+#include <cstdint>
+
+namespace sidecar {
+
+/*
+ * The formats the elevations can be written in.
+ * OSM: The input OSM file with an elevation tag added to each node.
+ * BINARY: Only node ID and elevation, sorted by node ID and delta
+ *         encoded, see ElevationSidecar.h.
+ * CSV: Only node ID and elevation as text, one node per line.
+ * OSC: An OsmChange file with only the nodes whose elevation tag was
+ *      added or updated.
+ */
+enum class OutputFormat : uint8_t {
+  OSM,
+  BINARY,
+  CSV,
+  OSC
+};
+
+}  // namespace sidecar
+
+#endif  // SRC_SIDECAR_OUTPUTFORMAT_H_
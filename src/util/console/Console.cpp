@@ -4,12 +4,17 @@
 #include "util/console/Console.h"
 #include <getopt.h>
 #include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include "global/Constants.h"
 
 using global::DEFAULT_ELE_TAG;
 using util::console::CommandLineArgsAdd;
 using util::console::CommandLineArgsCorrect;
 using util::console::ProgressBar;
+using osmelevation::elevation::Interpolation;
+using sidecar::OutputFormat;
 
 // ____________________________________________________________________________
 ProgressBar::ProgressBar(const uint64_t& total) {
@@ -52,6 +57,23 @@ void util::console::printUsageAndExitAdd() {
   std::cerr << "--tag <tag key>: The elevation tag used to add the ";
   std::cerr << "elevation to each node." << std::endl;
   std::cerr << "(default: 'ele')" << std::endl;
+  std::cerr << "--interpolation <nearest|bilinear|idw>: The kernel used to ";
+  std::cerr << "interpolate the elevation of each node." << std::endl;
+  std::cerr << "(default: 'idw')" << std::endl;
+  std::cerr << "--threads <number>: The maximum number of geographic ";
+  std::cerr << "partitions worked off at the same time, as long as their ";
+  std::cerr << "NASADEM files fit into memory." << std::endl;
+  std::cerr << "(default: 1)" << std::endl;
+  std::cerr << "--format <osm|binary|csv|osc>: Write the OSM input file ";
+  std::cerr << "with the elevation tags added, only the node IDs with their ";
+  std::cerr << "elevation as binary sidecar file or as CSV, or an OsmChange ";
+  std::cerr << "file with only the changed nodes." << std::endl;
+  std::cerr << "(default: 'osm')" << std::endl;
+  std::cerr << "--update: The OSM input file is an OsmChange file, write it ";
+  std::cerr << "with the elevation tags added to the created and modified ";
+  std::cerr << "nodes to the OsmChange output file." << std::endl;
+  std::cerr << "--metrics-out <file>: Write the time, memory and ";
+  std::cerr << "throughput of each phase as JSON to the file." << std::endl;
   exit(1);
 }
 
@@ -63,6 +85,17 @@ void util::console::printUsageAndExitCorrect() {
   std::cerr << "--tag <tag key>: The elevation tag on which the corrections ";
   std::cerr << "are performed." << std::endl;
   std::cerr << "(default: 'ele')" << std::endl;
+  std::cerr << "--threads <number>: The number of threads correcting the ";
+  std::cerr << "routes of a range at the same time." << std::endl;
+  std::cerr << "(default: 1)" << std::endl;
+  std::cerr << "--memory-limit <size>: The memory the routes and nodes of ";
+  std::cerr << "the ranges may use, in bytes or with suffix K, M or G.";
+  std::cerr << std::endl;
+  std::cerr << "(default: the physical memory minus 5G)" << std::endl;
+  std::cerr << "--resume: Continue a killed run from the checkpoint next to ";
+  std::cerr << "the output file." << std::endl;
+  std::cerr << "--metrics-out <file>: Write the time, memory and ";
+  std::cerr << "throughput of each phase as JSON to the file." << std::endl;
   exit(1);
 }
 
@@ -71,20 +104,66 @@ CommandLineArgsAdd util::console::parseCommandLineArgumentsAdd(int argc,
                                                                char** argv) {
   struct option options[] = {
     {"tag", 1, NULL, 't'},
+    {"interpolation", 1, NULL, 'i'},
+    {"threads", 1, NULL, 'j'},
+    {"format", 1, NULL, 'f'},
+    {"update", 0, NULL, 'u'},
+    {"metrics-out", 1, NULL, 'm'},
     {NULL, 0, NULL, 0}
   };
   optind = 1;
 
-  // Default value
+  // Default values
   std::string elevationTag = DEFAULT_ELE_TAG;
+  Interpolation interpolation = Interpolation::IDW;
+  int threads = 1;
+  OutputFormat format = OutputFormat::OSM;
+  bool update = false;
+  std::string metricsOut;
 
   while (true) {
-    char t = getopt_long(argc, argv, "t:", options, NULL);
+    char t = getopt_long(argc, argv, "t:i:j:f:um:", options, NULL);
     if (t == -1) { break; }
     switch (t) {
       case 't':
         elevationTag = optarg;
         break;
+      case 'i':
+        if (!std::strcmp(optarg, "nearest")) {
+          interpolation = Interpolation::NEAREST;
+        } else if (!std::strcmp(optarg, "bilinear")) {
+          interpolation = Interpolation::BILINEAR;
+        } else if (!std::strcmp(optarg, "idw")) {
+          interpolation = Interpolation::IDW;
+        } else {
+          util::console::printUsageAndExitAdd();
+        }
+        break;
+      case 'j':
+        threads = atoi(optarg);
+        if (threads < 1 || threads > UINT16_MAX) {
+          util::console::printUsageAndExitAdd();
+        }
+        break;
+      case 'f':
+        if (!std::strcmp(optarg, "osm")) {
+          format = OutputFormat::OSM;
+        } else if (!std::strcmp(optarg, "binary")) {
+          format = OutputFormat::BINARY;
+        } else if (!std::strcmp(optarg, "csv")) {
+          format = OutputFormat::CSV;
+        } else if (!std::strcmp(optarg, "osc")) {
+          format = OutputFormat::OSC;
+        } else {
+          util::console::printUsageAndExitAdd();
+        }
+        break;
+      case 'u':
+        update = true;
+        break;
+      case 'm':
+        metricsOut = optarg;
+        break;
       case '?':
       default:
         util::console::printUsageAndExitAdd();
@@ -99,6 +178,11 @@ CommandLineArgsAdd util::console::parseCommandLineArgumentsAdd(int argc,
   args.inputFile = argv[optind + 1];
   args.outputFile = argv[optind + 2];
   args.elevationTag = elevationTag;
+  args.interpolation = interpolation;
+  args.threads = threads;
+  args.format = format;
+  args.update = update;
+  args.metricsOut = metricsOut;
 
   return args;
 }
@@ -108,20 +192,46 @@ CommandLineArgsCorrect util::console::parseCommandLineArgumentsCorrect(
     int argc, char** argv) {
   struct option options[] = {
     {"tag", 1, NULL, 't'},
+    {"threads", 1, NULL, 'j'},
+    {"metrics-out", 1, NULL, 'm'},
+    {"memory-limit", 1, NULL, 'l'},
+    {"resume", 0, NULL, 'r'},
     {NULL, 0, NULL, 0}
   };
   optind = 1;
 
-  // Default value
+  // Default values
   std::string elevationTag = DEFAULT_ELE_TAG;
+  int threads = 1;
+  std::string metricsOut;
+  uint64_t memoryLimit = 0;
+  bool resume = false;
 
   while (true) {
-    char t = getopt_long(argc, argv, "t:", options, NULL);
+    char t = getopt_long(argc, argv, "t:j:m:l:r", options, NULL);
     if (t == -1) { break; }
     switch (t) {
       case 't':
         elevationTag = optarg;
         break;
+      case 'j':
+        threads = atoi(optarg);
+        if (threads < 1 || threads > UINT16_MAX) {
+          util::console::printUsageAndExitCorrect();
+        }
+        break;
+      case 'm':
+        metricsOut = optarg;
+        break;
+      case 'l':
+        memoryLimit = parseByteSize(optarg);
+        if (memoryLimit == 0) {
+          util::console::printUsageAndExitCorrect();
+        }
+        break;
+      case 'r':
+        resume = true;
+        break;
       case '?':
       default:
         util::console::printUsageAndExitCorrect();
@@ -134,6 +244,31 @@ CommandLineArgsCorrect util::console::parseCommandLineArgumentsCorrect(
   args.inputFile = argv[optind];
   args.outputFile = argv[optind + 1];
   args.elevationTag = elevationTag;
+  args.threads = threads;
+  args.metricsOut = metricsOut;
+  args.memoryLimit = memoryLimit;
+  args.resume = resume;
 
   return args;
 }
+
+// ____________________________________________________________________________
+uint64_t util::console::parseByteSize(const char* size) {
+  char* end;
+  const double value = std::strtod(size, &end);
+  if (end == size || value <= 0) {
+    return 0;
+  }
+  double factor = 1;
+  switch (*end) {
+    case '\0': break;
+    case 'K': case 'k': factor = 1024.0; ++end; break;
+    case 'M': case 'm': factor = 1024.0 * 1024; ++end; break;
+    case 'G': case 'g': factor = 1024.0 * 1024 * 1024; ++end; break;
+    default: return 0;
+  }
+  if (*end != '\0') {
+    return 0;
+  }
+  return static_cast<uint64_t>(value * factor);
+}
@@ -6,16 +6,26 @@
 
 #include <cstdint>
 #include <string>
+#include "osmelevation/elevation/Interpolation.h"
+#include "sidecar/OutputFormat.h"
 
 namespace util {
 namespace console {
 
+using osmelevation::elevation::Interpolation;
+using sidecar::OutputFormat;
+
 struct CommandLineArgsAdd {
  public:
   std::string nasademDir;
   std::string inputFile;
   std::string outputFile;
   std::string elevationTag;
+  Interpolation interpolation;
+  uint16_t threads;
+  OutputFormat format;
+  bool update;
+  std::string metricsOut;
 };
 
 struct CommandLineArgsCorrect {
@@ -23,6 +33,11 @@ struct CommandLineArgsCorrect {
   std::string inputFile;
   std::string outputFile;
   std::string elevationTag;
+  uint16_t threads;
+  std::string metricsOut;
+  // In bytes, 0 if not given.
+  uint64_t memoryLimit;
+  bool resume;
 };
 
 /*
@@ -52,6 +67,10 @@ void printUsageAndExitCorrect();
 CommandLineArgsAdd parseCommandLineArgumentsAdd(int argc, char** argv);
 CommandLineArgsCorrect parseCommandLineArgumentsCorrect(int argc, char** argv);
 
+// Parse a size in bytes with an optional K, M or G suffix (powers of 1024).
+// Return 0 if the size is invalid.
+uint64_t parseByteSize(const char* size);
+
 }  // namespace console
 }  // namespace util
 
@@ -1,9 +1,9 @@
 // Copyright 2022, Urs Spiegelhalter
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
+#include <algorithm>
 #include <vector>
 #include <utility>
-#include <set>
 #include <unordered_map>
 #include <cstdint>
 #include "util/graph/Edge.h"
@@ -12,74 +12,226 @@
 using util::graph::Edge;
 using util::graph::Graph;
 
+namespace {
+
+// ____________________________________________________________________________
+bool testBit(const std::vector<uint64_t>& bits, const uint64_t index) {
+  return bits[index / 64] & (uint64_t(1) << (index % 64));
+}
+
+// ____________________________________________________________________________
+void setBit(std::vector<uint64_t>& bits, const uint64_t index) {
+  bits[index / 64] |= uint64_t(1) << (index % 64);
+}
+
+// ____________________________________________________________________________
+void clearBit(std::vector<uint64_t>& bits, const uint64_t index) {
+  bits[index / 64] &= ~(uint64_t(1) << (index % 64));
+}
+
+// ____________________________________________________________________________
+void sortUnique(std::vector<uint64_t>& ids) {
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+}  // namespace
+
 // ____________________________________________________________________________
 Graph::Graph(const uint64_t estimatedNodeCount) {
-  _graph.reserve(estimatedNodeCount);
+  _addedEdges.reserve(estimatedNodeCount);
 }
 
 // ____________________________________________________________________________
 std::unordered_map<uint64_t, std::vector<Edge>> Graph::getGraph() const {
-  return _graph;
+  std::unordered_map<uint64_t, std::vector<Edge>> graph;
+  for (const auto& [node, edge] : _addedEdges) {
+    graph[node].push_back(edge);
+  }
+  // After the build, the edges are only in the compressed rows.
+  for (uint64_t node = 0; _built && node < _nodeIds.size(); ++node) {
+    for (uint32_t i = _rowStart[node]; i < _rowStart[node + 1]; ++i) {
+      const RowEdge& edge = _rowEdges[i];
+      graph[_nodeIds[node]].emplace_back(_edgeIds[edge.edge],
+                                         _nodeIds[edge.pointsTo],
+                                         edge.reversedEdgeExists);
+    }
+  }
+  return graph;
 }
 
 // ____________________________________________________________________________
 uint64_t Graph::getStartpoint() {
-  if (_startpoints.empty()) {
-    return 0;
+  // The startpoints in the order of their ids.
+  for (; _nextStartpoint < _nodeIds.size(); ++_nextStartpoint) {
+    if (testBit(_startpoints, _nextStartpoint)) {
+      clearBit(_startpoints, _nextStartpoint);
+      return _nodeIds[_nextStartpoint++];
+    }
   }
-  const uint64_t startPoint = *_startpoints.begin();
-  _startpoints.erase(_startpoints.begin());
-  return startPoint;
+  return 0;
 }
 
 // ____________________________________________________________________________
 std::vector<std::pair<uint64_t, uint64_t>> Graph::getUnfinishedPath() {
-  if (_unfinishedPaths.empty()) {
+  if (_nextUnfinished == _unfinishedPaths.size()) {
     return std::vector<std::pair<uint64_t, uint64_t>>();
   }
-  const auto unfinishedPath = *_unfinishedPaths.begin();
-  _unfinishedPaths.pop_front();
-  return unfinishedPath;
+  const PathRef path = _unfinishedPaths[_nextUnfinished++];
+  return std::vector<std::pair<uint64_t, uint64_t>>(
+      _steps.begin() + path.offset,
+      _steps.begin() + path.offset + path.length);
+}
+
+// ____________________________________________________________________________
+bool Graph::continueUnfinishedPath(
+    const bool river, std::vector<std::pair<uint64_t, uint64_t>>* path) {
+  path->clear();
+  if (_nextUnfinished == _unfinishedPaths.size()) {
+    return false;
+  }
+  const PathRef unfinished = _unfinishedPaths[_nextUnfinished++];
+  if (unfinished.length == 0) {
+    return false;
+  }
+  // The unfinished path stays in place, since the traversal only appends
+  // to the steps.
+  const uint64_t last = unfinished.offset + unfinished.length - 1;
+  if (traverse(_steps[last].first, &_steps[unfinished.offset],
+               unfinished.length, false, river, path)) {
+    path->insert(path->begin(), _steps.begin() + unfinished.offset,
+                 _steps.begin() + unfinished.offset + unfinished.length);
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Graph::allEdgesUsed() const {
+  return _built && _unusedEdges == 0;
+}
+
+// ____________________________________________________________________________
+void Graph::setWorkBudget(const uint64_t work) {
+  _workBudget = work;
+}
+
+// ____________________________________________________________________________
+bool Graph::workLeft() const {
+  return _work < _workBudget;
 }
 
 // ____________________________________________________________________________
 void Graph::addEdge(const uint64_t v1, const uint64_t v2,
                     const uint64_t id, const bool oppositeExists) {
-  auto edgeIt = _graph.try_emplace(v1, std::vector<Edge>());
+  if (_built) {
+    // Take the edges back from the compressed rows, the outgoing edges of
+    // each node stay in the order they were added.
+    for (uint64_t node = 0; node < _nodeIds.size(); ++node) {
+      for (uint32_t i = _rowStart[node]; i < _rowStart[node + 1]; ++i) {
+        const RowEdge& edge = _rowEdges[i];
+        _addedEdges.emplace_back(_nodeIds[node],
+                                 Edge(_edgeIds[edge.edge],
+                                      _nodeIds[edge.pointsTo],
+                                      edge.reversedEdgeExists));
+      }
+    }
+    _built = false;
+  }
+  _addedEdges.emplace_back(v1, Edge(id, v2, oppositeExists));
+}
 
-  edgeIt.first->second.emplace_back(id, v2, oppositeExists);
+// ____________________________________________________________________________
+void Graph::build() {
+  if (_built) {
+    return;
+  }
+  _built = true;
+  _nodeIds.clear();
+  _edgeIds.clear();
+  for (const auto& [node, edge] : _addedEdges) {
+    _nodeIds.push_back(node);
+    _nodeIds.push_back(edge.pointsTo);
+    _edgeIds.push_back(edge.edgeId);
+  }
+  sortUnique(_nodeIds);
+  sortUnique(_edgeIds);
 
-  // Keep track of the in-degrees of the nodes.
+  // Count the outgoing edges of each node, then place the edges of each
+  // node in the order they were added.
+  const uint64_t nodeCount = _nodeIds.size();
+  _rowStart.assign(nodeCount + 1, 0);
+  _inDegree.assign(nodeCount, 0);
+  std::vector<uint32_t> from(_addedEdges.size());
+  for (size_t i = 0; i < _addedEdges.size(); ++i) {
+    from[i] = nodeIndex(_addedEdges[i].first);
+    ++_rowStart[from[i] + 1];
+  }
+  for (uint64_t i = 0; i < nodeCount; ++i) {
+    _rowStart[i + 1] += _rowStart[i];
+  }
+  std::vector<uint32_t> next(_rowStart.begin(), _rowStart.end() - 1);
+  _rowEdges.resize(_addedEdges.size());
+  for (size_t i = 0; i < _addedEdges.size(); ++i) {
+    const Edge& edge = _addedEdges[i].second;
+    const uint32_t pointsTo = nodeIndex(edge.pointsTo);
+    const uint32_t edgeIndex =
+        std::lower_bound(_edgeIds.begin(), _edgeIds.end(), edge.edgeId) -
+        _edgeIds.begin();
+    _rowEdges[next[from[i]]++] = { pointsTo, edgeIndex,
+                                   edge.reversedEdgeExists };
+    ++_inDegree[pointsTo];
+  }
+
+  const uint64_t nodeWords = (nodeCount + 63) / 64;
+  _startpoints.assign(nodeWords, 0);
+  _nextStartpoint = 0;
+  _visitedNodes.assign(nodeWords, 0);
+  _usedEdges.assign((_edgeIds.size() + 63) / 64, 0);
+  _unusedEdges = _edgeIds.size();
+  _work = 0;
+  _steps.clear();
+  _unfinishedPaths.clear();
+  _nextUnfinished = 0;
+  // The compressed rows hold all edges now.
+  std::vector<std::pair<uint64_t, Edge>>().swap(_addedEdges);
+}
 
-  _inDegree.try_emplace(v1, 0);
-  auto endpoint = _inDegree.emplace(v2, 0).first;
-  endpoint->second++;
+// ____________________________________________________________________________
+int64_t Graph::nodeIndex(const uint64_t node) const {
+  const auto it = std::lower_bound(_nodeIds.begin(), _nodeIds.end(), node);
+  if (it == _nodeIds.end() || *it != node) {
+    return -1;
+  }
+  return it - _nodeIds.begin();
 }
 
 // ____________________________________________________________________________
 void Graph::findStartpoints() {
-  _startpoints.clear();
-  for (auto edgeIt = _inDegree.begin(); edgeIt != _inDegree.end(); ) {
-    if (edgeIt->second == 0) {
-      _startpoints.emplace(edgeIt->first);
-    } else if (edgeIt->second == 1) {
+  build();
+  std::fill(_startpoints.begin(), _startpoints.end(), 0);
+  _nextStartpoint = 0;
+  for (uint64_t node = 0; node < _inDegree.size(); ++node) {
+    const uint32_t outDegree = _rowStart[node + 1] - _rowStart[node];
+    if (_inDegree[node] == 0) {
+      setBit(_startpoints, node);
+    } else if (_inDegree[node] == 1 && outDegree == 1 &&
+               _rowEdges[_rowStart[node]].reversedEdgeExists) {
       // If the node has in-degree and out-degree of 1,
       // and the outgoing/ingoing edge are opposites, it's also a startpoint.
-      if (_graph.contains(edgeIt->first) &&
-          _graph.find(edgeIt->first)->second.size() == 1 &&
-          _graph.find(edgeIt->first)->second.front().reversedEdgeExists) {
-        _startpoints.emplace(edgeIt->first);
-      }
+      setBit(_startpoints, node);
     }
-    edgeIt++;
   }
-  _inDegree.clear();
+  std::vector<uint32_t>().swap(_inDegree);
 }
 
 // ____________________________________________________________________________
 bool Graph::removeStartNode(const uint64_t node) {
-  const bool existed = _startpoints.erase(node);
-  return existed;
+  const int64_t index = nodeIndex(node);
+  if (index < 0 || !testBit(_startpoints, index)) {
+    return false;
+  }
+  clearBit(_startpoints, index);
+  return true;
 }
 
 // ____________________________________________________________________________
@@ -88,13 +240,41 @@ std::vector<std::pair<uint64_t, uint64_t>> Graph::traverseGraph(
     const std::vector<std::pair<uint64_t, uint64_t>>& unfinishedPath,
     const bool fromStartPoint, const bool river) {
   std::vector<std::pair<uint64_t, uint64_t>> path;
-  std::set<uint64_t> visitedNodes;
-  visitedNodes.emplace(startNode);
+  traverse(startNode, unfinishedPath.data(), unfinishedPath.size(),
+           fromStartPoint, river, &path);
+  return path;
+}
 
-  // The nodes used in the unfinished path can not be used again.
-  for (const auto& edge : unfinishedPath) {
-    visitedNodes.emplace(edge.first);
+// ____________________________________________________________________________
+bool Graph::traverse(const uint64_t startNode,
+                     const std::pair<uint64_t, uint64_t>* prefix,
+                     const uint64_t prefixLength, const bool fromStartPoint,
+                     const bool river,
+                     std::vector<std::pair<uint64_t, uint64_t>>* path) {
+  build();
+  const int64_t start = nodeIndex(startNode);
+  if (start < 0) {
+    return false;
   }
+  auto visit = [this](const uint32_t node) {
+    if (!testBit(_visitedNodes, node)) {
+      setBit(_visitedNodes, node);
+      _visitedList.push_back(node);
+    }
+  };
+  visit(start);
+
+  // The nodes used in the unfinished path can not be used again. The
+  // prefix may be in the steps, so it is only read before the traversal.
+  _work += prefixLength;
+  for (uint64_t i = 0; i < prefixLength; ++i) {
+    const int64_t node = nodeIndex(prefix[i].first);
+    if (node >= 0) { visit(node); }
+  }
+
+  // The path goes into the steps, as long as unfinished paths refer to it.
+  const uint64_t pathStart = _steps.size();
+  const uint64_t unfinishedBefore = _unfinishedPaths.size();
 
   // Denote if the constructed path has not been seen before
   // (at least one node has not been seen before).
@@ -104,12 +284,13 @@ std::vector<std::pair<uint64_t, uint64_t>> Graph::traverseGraph(
   uint64_t consecutiveKnown = 0;
 
   // Traverse nodes.
-  for (auto nodeIt = _graph.find(startNode); nodeIt != _graph.end(); ) {
+  int64_t node = start;
+  while (node >= 0) {
     // Refer to an edge that was used in a prior
-    // traversal (i.e. is present in _usedEdges),
+    // traversal (i.e. its bit in _usedEdges is set),
     // or was not used before respectively.
-    Edge* nextEdgeUsed = nullptr;
-    Edge* nextEdgeUnused = nullptr;
+    const RowEdge* nextEdgeUsed = nullptr;
+    const RowEdge* nextEdgeUnused = nullptr;
 
     // Prefer edges marked with oppositeExists=true, i.e.
     // the edge is present in both directions.
@@ -117,29 +298,29 @@ std::vector<std::pair<uint64_t, uint64_t>> Graph::traverseGraph(
     bool foundPreferredEdgeUnused = false;
 
     // Counter for the number of unused outgoing edges of the node.
-    uint8_t availableBranches = 0;
+    uint32_t availableBranches = 0;
 
     // Look at all outgoing edges of the node.
-    for (auto edgeIt = nodeIt->second.begin();
-         edgeIt != nodeIt->second.end(); ) {
+    _work += 1 + _rowStart[node + 1] - _rowStart[node];
+    for (uint32_t i = _rowStart[node]; i < _rowStart[node + 1]; ++i) {
+      const RowEdge& edge = _rowEdges[i];
       // Cycle if the endpoint was already visited.
-      if (!visitedNodes.contains(edgeIt->pointsTo)) {
-        const bool preferredEdge = edgeIt->reversedEdgeExists;
-        const bool unused = !_usedEdges.contains(edgeIt->edgeId);
+      if (!testBit(_visitedNodes, edge.pointsTo)) {
+        const bool preferredEdge = edge.reversedEdgeExists;
+        const bool unused = !testBit(_usedEdges, edge.edge);
 
         // Keep track of the number of outgoing unused edges.
         if (unused) { ++availableBranches; }
 
         if (!foundPreferredEdgeUnused && unused) {
-          nextEdgeUnused = &*edgeIt;
+          nextEdgeUnused = &edge;
           if (preferredEdge) { foundPreferredEdgeUnused = true; }
         }
         if (!foundPreferredEdgeUsed && !unused) {
-          nextEdgeUsed = &*edgeIt;
+          nextEdgeUsed = &edge;
           if (preferredEdge) { foundPreferredEdgeUsed = true; }
         }
       }
-      ++edgeIt;
     }
     // Prefer an unused edge over an used.
     auto nextEdge = (nextEdgeUnused) ? nextEdgeUnused : nextEdgeUsed;
@@ -153,9 +334,11 @@ std::vector<std::pair<uint64_t, uint64_t>> Graph::traverseGraph(
 
     // If no edge with an unvisited endpoint was found, terminate traversal.
     if (!nextEdge) {
-      nodeIt = _graph.end();
+      node = -1;
     } else {
-      if (_usedEdges.emplace(nextEdge->edgeId).second) {
+      if (!testBit(_usedEdges, nextEdge->edge)) {
+        setBit(_usedEdges, nextEdge->edge);
+        --_unusedEdges;
         uniquePath = true;
       } else {
         ++consecutiveKnown;
@@ -164,32 +347,43 @@ std::vector<std::pair<uint64_t, uint64_t>> Graph::traverseGraph(
       // add an unfinished path consisting of the current path
       // until this node.
       if (availableBranches >= 2) {
-        // Reset the counter, unvisited edge found.
-        addUnfinishedPath(path, river);
+        addUnfinishedPath(pathStart, river);
       }
       // Continue with traversal.
-      path.emplace_back(nextEdge->pointsTo, nextEdge->edgeId);
-      nodeIt = _graph.find(nextEdge->pointsTo);
-      visitedNodes.emplace(nextEdge->pointsTo);
+      node = nextEdge->pointsTo;
+      _steps.emplace_back(_nodeIds[node], _edgeIds[nextEdge->edge]);
+      visit(node);
     }
 
     // Stop if river and the last edge has already been seen.
     if (river && consecutiveKnown > 0) {
-      nodeIt = _graph.end();
+      node = -1;
     }
   }
-  return (uniquePath) ? path : std::vector<std::pair<uint64_t, uint64_t>>();
+  for (const auto visitedNode : _visitedList) {
+    clearBit(_visitedNodes, visitedNode);
+  }
+  _visitedList.clear();
+
+  if (uniquePath) {
+    path->insert(path->end(), _steps.begin() + pathStart, _steps.end());
+  }
+  // Only keep the steps the new unfinished paths refer to.
+  uint64_t keepEnd = pathStart;
+  for (uint64_t i = unfinishedBefore; i < _unfinishedPaths.size(); ++i) {
+    keepEnd = std::max(keepEnd, _unfinishedPaths[i].offset +
+                                _unfinishedPaths[i].length);
+  }
+  _steps.resize(keepEnd);
+  return uniquePath;
 }
 
 // ____________________________________________________________________________
-void Graph::addUnfinishedPath(
-    const std::vector<std::pair<uint64_t, uint64_t>>& path, const bool river) {
-  std::vector<std::pair<uint64_t, uint64_t>> unfinishedPath;
-
-  if (river && path.size() > 0) {
-    unfinishedPath.emplace_back(path.back());
+void Graph::addUnfinishedPath(const uint64_t pathStart, const bool river) {
+  const uint64_t length = _steps.size() - pathStart;
+  if (river && length > 0) {
+    _unfinishedPaths.push_back({ _steps.size() - 1, 1 });
   } else {
-    unfinishedPath.insert(unfinishedPath.end(), path.begin(), path.end());
+    _unfinishedPaths.push_back({ pathStart, length });
   }
-  _unfinishedPaths.emplace_back(unfinishedPath);
 }
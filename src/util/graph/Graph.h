@@ -5,11 +5,10 @@
 #define SRC_UTIL_GRAPH_GRAPH_H_
 
 #include <vector>
-#include <set>
-#include <list>
 #include <utility>
 #include <unordered_map>
 #include <cstdint>
+#include <limits>
 #include "util/graph/Edge.h"
 
 namespace util {
@@ -20,7 +19,18 @@ using util::graph::Edge;
 /*
  * Graph that holds directed edges in an adjacency list where
  * nodes point to outgoing egdes. A node is represented by an unique id.
- */ 
+ * Before the first traversal, the node ids and edge ids are mapped to
+ * dense indices in the order of the ids, and the edges are stored in
+ * compressed sparse rows: the outgoing edges of all nodes one after the
+ * other, in the order they were added. So the traversals only need array
+ * accesses and keep the used edges and visited nodes as bitsets.
+ * All paths of the traversals go into a single array, unfinished paths
+ * refer to a prefix of a path in it. An unfinished path is continued in
+ * place, and once every edge is used, no traversal can find a new path.
+ * The traversals are greedy, and a continued path repeats its prefix, so
+ * their work is not linear in the size of the graph. It is counted, such
+ * that callers can stop at a work budget.
+ */
 class Graph {
  public:
   explicit Graph(const uint64_t estimatedNodeCount);
@@ -40,8 +50,32 @@ class Graph {
   // If none exists, return an empty path.
   std::vector<std::pair<uint64_t, uint64_t>> getUnfinishedPath();
 
-  // Add an edge, defined by start-node and end-node.
-  // Also keep track of the in-degrees of the edges' start-nodes.
+  // Take the next unfinished path and continue it like traverseGraph does
+  // from its last node. Set path to the unfinished path followed by the
+  // traversal, or to an empty path if the traversal found no unused edge.
+  // Return false if there is no unfinished path left or it is empty.
+  // A traversal with its prefix costs O(V + E) for V nodes and E edges. At
+  // most E traversals find a path of at most 2V steps, and each traversal
+  // records at most V unfinished paths. So the paths have O(V * E) steps,
+  // and continuing all unfinished paths is O(V * (V + E)^2) in the worst
+  // case, unless the work budget stops it earlier.
+  bool continueUnfinishedPath(
+      const bool river, std::vector<std::pair<uint64_t, uint64_t>>* path);
+
+  // Whether every edge is used by a path found so far. Then a traversal
+  // can't find a new path.
+  bool allEdgesUsed() const;
+
+  // Limit the work of the traversals, counted as prefix steps, visited
+  // nodes and looked at edges. Unlimited by default.
+  void setWorkBudget(const uint64_t work);
+
+  // Whether the work of the traversals since the graph was built is below
+  // the budget. A traversal that is started is always finished.
+  bool workLeft() const;
+
+  // Add an edge, defined by start-node and end-node. All edges have to be
+  // added before the first traversal.
   void addEdge(const uint64_t v1, const uint64_t v2,
                const uint64_t id, const bool oppositeExists);
 
@@ -61,28 +95,84 @@ class Graph {
       const std::vector<std::pair<uint64_t, uint64_t>>& unfinishedPath,
       const bool fromStartPoint, const bool river);
 
-  // Add a complete path or only the last node of the path to
-  // the _unfinishedPaths list. An unused edge is reachable
-  // from the last node of an unfinished path.
-  void addUnfinishedPath(
-      const std::vector<std::pair<uint64_t, uint64_t>>& path,
-      const bool river);
-
  private:
-  // The graph saved as an adjacency list where nodes point to adjacent edges.
-  std::unordered_map<uint64_t, std::vector<Edge>> _graph;
-
-  // The in-degree of each node.
-  std::unordered_map<uint64_t, uint8_t> _inDegree;
-
-  // The set of startpoints that have been found by findStartpoints().
-  std::set<uint64_t> _startpoints;
-
-  // All edges (given by id) that have been used so far.
-  std::set<uint64_t> _usedEdges;
-
-  // Paths where an unused edge is reachable from the last node of the path.
-  std::list<std::vector<std::pair<uint64_t, uint64_t>>> _unfinishedPaths;
+  // An edge in the compressed rows, with the indices of its endpoint and
+  // of its id.
+  struct RowEdge {
+    uint32_t pointsTo;
+    uint32_t edge;
+    bool reversedEdgeExists;
+  };
+
+  // A prefix of a path in _steps.
+  struct PathRef {
+    uint64_t offset;
+    uint64_t length;
+  };
+
+  // Map the ids to indices and build the compressed rows, unless done.
+  void build();
+
+  // The index of a node id, or -1 if the node has no edges.
+  int64_t nodeIndex(const uint64_t node) const;
+
+  // Traverse from the start node, without visiting the nodes of the
+  // prefix steps. If an unused edge was used, append the steps to path and
+  // return true.
+  bool traverse(const uint64_t startNode,
+                const std::pair<uint64_t, uint64_t>* prefix,
+                const uint64_t prefixLength, const bool fromStartPoint,
+                const bool river,
+                std::vector<std::pair<uint64_t, uint64_t>>* path);
+
+  // Add the path of the current traversal, which starts at pathStart in
+  // _steps, or only its last step for rivers to the unfinished paths.
+  // An unused edge is reachable from the last node of an unfinished path.
+  void addUnfinishedPath(const uint64_t pathStart, const bool river);
+
+  // The edges with their start-node, as added since the last build.
+  std::vector<std::pair<uint64_t, Edge>> _addedEdges;
+  bool _built = false;
+
+  // The sorted node ids and edge ids, their position is their index.
+  std::vector<uint64_t> _nodeIds;
+  std::vector<uint64_t> _edgeIds;
+
+  // The outgoing edges of node i are [_rowStart[i], _rowStart[i + 1]).
+  std::vector<uint32_t> _rowStart;
+  std::vector<RowEdge> _rowEdges;
+
+  // The in-degree of each node, until the startpoints are found.
+  std::vector<uint32_t> _inDegree;
+
+  // A bit for each startpoint found by findStartpoints() and not yet taken.
+  // Startpoints before _nextStartpoint were taken.
+  std::vector<uint64_t> _startpoints;
+  uint64_t _nextStartpoint = 0;
+
+  // A bit for each edge that has been used so far, and the number of
+  // edges not used yet.
+  std::vector<uint64_t> _usedEdges;
+  uint64_t _unusedEdges = 0;
+
+  // The work of the traversals so far and its limit.
+  uint64_t _work = 0;
+  uint64_t _workBudget = std::numeric_limits<uint64_t>::max();
+
+  // A bit for each node visited in the current traversal, and the nodes
+  // to reset them at its end.
+  std::vector<uint64_t> _visitedNodes;
+  std::vector<uint32_t> _visitedList;
+
+  // The (node, edge id) steps of all paths of the traversals, as far as
+  // unfinished paths refer to them.
+  std::vector<std::pair<uint64_t, uint64_t>> _steps;
+
+  // Paths where an unused edge is reachable from the last node of the
+  // path, in the order they were found. The ones before _nextUnfinished
+  // were taken.
+  std::vector<PathRef> _unfinishedPaths;
+  uint64_t _nextUnfinished = 0;
 };
 
 }  // namespace graph
@@ -4,15 +4,23 @@
 #include <math.h>
 #include <ctime>
 #include <algorithm>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <utility>
 #include "global/Constants.h"
 #include "util/index/IdElevationAverage.h"
 #include "util/index/ElevationIndex.h"
 #include "util/index/AverageElevationIndexSparse.h"
+#include "util/metrics/Metrics.h"
 
 using global::INVALID_ELEV;
 using global::INVALID_ELEV_F;
 using util::index::ElevationIndex;
 using util::index::AverageElevationIndexSparse;
+using util::metrics::Metrics;
+using util::metrics::wallSeconds;
 
 // ____________________________________________________________________________
 AverageElevationIndexSparse::AverageElevationIndexSparse(
@@ -40,6 +48,17 @@ void AverageElevationIndexSparse::setElevation(
   _averageElevationIndex.emplace_back(nodeId, elevation);
 }
 
+// ____________________________________________________________________________
+void AverageElevationIndexSparse::setElevation(
+    const uint64_t nodeId, const float elevation, const uint16_t weight) {
+  if (elevation == INVALID_ELEV_F || weight == 0) {
+    return;
+  }
+  auto& average = _averageElevationIndex.emplace_back(nodeId,
+                                                      elevation * weight);
+  average.count = weight;
+}
+
 // ____________________________________________________________________________
 void AverageElevationIndexSparse::setElevationTunnelOrBridge(
     const uint64_t nodeId, const float elevation) {
@@ -49,6 +68,15 @@ void AverageElevationIndexSparse::setElevationTunnelOrBridge(
   _averageElevationIndex.emplace_back(nodeId, elevation, true);
 }
 
+// ____________________________________________________________________________
+void AverageElevationIndexSparse::append(
+    const AverageElevationIndexSparse& buffer) {
+  // Skip the invalid entry every index starts with.
+  _averageElevationIndex.insert(_averageElevationIndex.end(),
+                                buffer._averageElevationIndex.begin() + 1,
+                                buffer._averageElevationIndex.end());
+}
+
 // ____________________________________________________________________________
 int16_t AverageElevationIndexSparse::getElevation(
     const uint64_t nodeId) const {
@@ -79,6 +107,7 @@ int16_t AverageElevationIndexSparse::getElevation(
 
 // ____________________________________________________________________________
 void AverageElevationIndexSparse::process() {
+  const double sortStart = wallSeconds();
   // Sort the array by node ID.
   std::sort(_averageElevationIndex.begin(),
             _averageElevationIndex.end(),
@@ -87,6 +116,7 @@ void AverageElevationIndexSparse::process() {
             });
   mergeDuplicates();
   _count = _averageElevationIndex.size();
+  Metrics::get().addSeconds("indexSortSeconds", wallSeconds() - sortStart);
 }
 
 // ____________________________________________________________________________
@@ -119,3 +149,66 @@ void AverageElevationIndexSparse::mergeDuplicates() {
   // Move the index back from the temporary vector.
   _averageElevationIndex.swap(tmpIndex);
 }
+
+// ____________________________________________________________________________
+void AverageElevationIndexSparse::forEachElevation(
+    const std::function<void(uint64_t, int16_t)>& visit) const {
+  for (const auto& idAvgElev : _averageElevationIndex) {
+    if (idAvgElev.count == 0) {
+      continue;
+    }
+    const int16_t elevation = static_cast<int16_t>(
+      std::lround(idAvgElev.elevationSum / idAvgElev.count));
+    if (elevation != INVALID_ELEV) {
+      visit(idAvgElev.id, elevation);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+uint64_t AverageElevationIndexSparse::byteSize() const {
+  return _averageElevationIndex.capacity() * sizeof(IdElevationAverage);
+}
+
+// ____________________________________________________________________________
+void AverageElevationIndexSparse::write(std::ostream& out) const {
+  const uint64_t size = _averageElevationIndex.size();
+  out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  out.write(reinterpret_cast<const char*>(_averageElevationIndex.data()),
+            size * sizeof(IdElevationAverage));
+}
+
+// ____________________________________________________________________________
+bool AverageElevationIndexSparse::read(std::istream& in) {
+  // The entries can't take more than the rest of the stream.
+  uint64_t maxSize = std::numeric_limits<uint64_t>::max();
+  const std::streampos position = in.tellg();
+  if (position >= 0) {
+    in.seekg(0, std::ios::end);
+    const std::streampos end = in.tellg();
+    in.seekg(position);
+    maxSize = end > position ?
+              (end - position) / sizeof(IdElevationAverage) : 0;
+  }
+  uint64_t size = 0;
+  in.read(reinterpret_cast<char*>(&size), sizeof(size));
+  // A processed index has at least the invalid entry it starts with.
+  if (!in || size == 0 || size > maxSize) {
+    return false;
+  }
+  std::vector<IdElevationAverage> index(size);
+  in.read(reinterpret_cast<char*>(index.data()),
+          size * sizeof(IdElevationAverage));
+  if (!in) {
+    return false;
+  }
+  _averageElevationIndex.swap(index);
+  _count = _averageElevationIndex.size();
+  return true;
+}
+
+// ____________________________________________________________________________
+void AverageElevationIndexSparse::swap(AverageElevationIndexSparse& other) {
+  _averageElevationIndex.swap(other._averageElevationIndex);
+  std::swap(_count, other._count);
+}
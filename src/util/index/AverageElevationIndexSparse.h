@@ -7,6 +7,9 @@
 #include <vector>
 #include <utility>
 #include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
 #include "util/index/IdElevationAverage.h"
 #include "util/index/ElevationIndex.h"
 
@@ -35,11 +38,21 @@ class AverageElevationIndexSparse : public ElevationIndex {
   void setElevation(const uint64_t nodeId,
                     const float elevation);
 
+  // Add the elevation for a node as often as the weight says, e.g. for a
+  // route path found in several routes. Duplicates are allowed.
+  void setElevation(const uint64_t nodeId,
+                    const float elevation,
+                    const uint16_t weight);
+
   // Add the elevation for a node belonging to a tunnel or bridge,
   // duplicates are allowed.
   void setElevationTunnelOrBridge(const uint64_t nodeId,
                                   const float elevation);
 
+  // Add all elevations of another index, e.g. the buffer of one thread.
+  // The elevations are merged with the next call to process.
+  void append(const AverageElevationIndexSparse& buffer);
+
   // Get the average elevation for a node.
   int16_t getElevation(const uint64_t nodeId) const override;
 
@@ -47,6 +60,24 @@ class AverageElevationIndexSparse : public ElevationIndex {
   // to maintain the averages of the nodes elevations.
   void process() override;
 
+  // Call visit for each node with a valid average elevation,
+  // ordered by node ID.
+  void forEachElevation(
+      const std::function<void(uint64_t, int16_t)>& visit) const override;
+
+  // Memory used by the index in bytes.
+  uint64_t byteSize() const override;
+
+  // Write the processed index to a binary stream, in host byte order.
+  void write(std::ostream& out) const;
+
+  // Replace the index by one written with write. Return false if the
+  // stream ends too early or holds more entries than it has bytes left.
+  bool read(std::istream& in);
+
+  // Exchange the entries with another index, e.g. one read from a stream.
+  void swap(AverageElevationIndexSparse& other);
+
  private:
   // Remove duplicates by keeping one version of each node which
   // stores the sum of the elevations of all duplicates and the total
@@ -2,10 +2,24 @@
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
 #include <cstdint>
+#include <functional>
+#include "global/Constants.h"
 #include "util/index/ElevationIndex.h"
 
 using util::index::ElevationIndex;
+using global::INVALID_ELEV;
 
 // ____________________________________________________________________________
 ElevationIndex::ElevationIndex(const uint64_t count, const uint64_t max) :
                                _count(count), _max(max) {}
+
+// ____________________________________________________________________________
+void ElevationIndex::forEachElevation(
+    const std::function<void(uint64_t, int16_t)>& visit) const {
+  for (uint64_t nodeId = 1; nodeId <= _max; ++nodeId) {
+    const int16_t elevation = getElevation(nodeId);
+    if (elevation != INVALID_ELEV) {
+      visit(nodeId, elevation);
+    }
+  }
+}
@@ -5,6 +5,7 @@
 #define SRC_UTIL_INDEX_ELEVATIONINDEX_H_
 
 #include <cstdint>
+#include <functional>
 
 namespace util {
 namespace index {
@@ -24,6 +25,15 @@ class ElevationIndex {
 
   virtual void process() = 0;
 
+  // Call visit for each node with a valid elevation, ordered by node ID.
+  // Only valid after process() was called. By default, all node IDs up
+  // to the maximum node ID are looked up.
+  virtual void forEachElevation(
+      const std::function<void(uint64_t, int16_t)>& visit) const;
+
+  // Memory used by the index in bytes.
+  virtual uint64_t byteSize() const = 0;
+
  protected:
   uint64_t _count;
   uint64_t _max;
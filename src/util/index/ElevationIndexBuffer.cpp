@@ -0,0 +1,67 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <cstdint>
+#include <mutex>  // NOLINT(build/c++11)
+#include "global/Constants.h"
+#include "util/index/ElevationIndex.h"
+#include "util/index/ElevationIndexBuffer.h"
+
+using global::INVALID_ELEV;
+using util::index::ElevationIndex;
+using util::index::ElevationIndexBuffer;
+
+// ____________________________________________________________________________
+ElevationIndexBuffer::ElevationIndexBuffer(ElevationIndex& elevationIndex,
+                                           std::mutex& mutex,
+                                           const uint64_t capacity) :
+                                           ElevationIndex(capacity, 0),
+                                           _elevationIndex(elevationIndex),
+                                           _mutex(mutex) {
+  _buffer.reserve(_count);
+}
+
+// ____________________________________________________________________________
+ElevationIndexBuffer::~ElevationIndexBuffer() {
+  process();
+}
+
+// ____________________________________________________________________________
+void ElevationIndexBuffer::setElevation(const uint64_t nodeId,
+                                        const int16_t elevation) {
+  if (elevation == INVALID_ELEV) {
+    return;
+  }
+  _buffer.emplace_back(nodeId, elevation);
+  if (_buffer.size() >= _count) {
+    process();
+  }
+}
+
+// ____________________________________________________________________________
+int16_t ElevationIndexBuffer::getElevation(const uint64_t nodeId) const {
+  return _elevationIndex.getElevation(nodeId);
+}
+
+// ____________________________________________________________________________
+void ElevationIndexBuffer::process() {
+  if (_buffer.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (const auto& idElevation : _buffer) {
+    _elevationIndex.setElevation(idElevation.id, idElevation.elevation);
+  }
+  _buffer.clear();
+}
+
+// ____________________________________________________________________________
+void ElevationIndexBuffer::forEachElevation(
+    const std::function<void(uint64_t, int16_t)>& visit) const {
+  _elevationIndex.forEachElevation(visit);
+}
+
+// ____________________________________________________________________________
+uint64_t ElevationIndexBuffer::byteSize() const {
+  return _buffer.capacity() * sizeof(IdElevation);
+}
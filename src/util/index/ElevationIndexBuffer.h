@@ -0,0 +1,66 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_UTIL_INDEX_ELEVATIONINDEXBUFFER_H_
+#define SRC_UTIL_INDEX_ELEVATIONINDEXBUFFER_H_
+
+#include <cstdint>
+#include <functional>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
+#include "util/index/IdElevation.h"
+#include "util/index/ElevationIndex.h"
+
+namespace util {
+namespace index {
+
+using util::index::IdElevation;
+using util::index::ElevationIndex;
+
+/*
+ * Collect the elevations of one thread and write them in batches into
+ * an elevation index shared by several threads. Writing into the shared
+ * index is guarded by a mutex shared by all buffers of the index.
+ */
+class ElevationIndexBuffer : public ElevationIndex {
+ public:
+  ElevationIndexBuffer(ElevationIndex& elevationIndex, std::mutex& mutex,
+                       const uint64_t capacity = 1 << 20);
+
+  // Write the remaining elevations into the shared index.
+  ~ElevationIndexBuffer() override;
+
+  // Buffer the elevation for a node ID, invalid elevations are skipped.
+  void setElevation(const uint64_t nodeId,
+                    const int16_t elevation) override;
+
+  // Get the elevation for a node ID from the shared index. Only valid
+  // if no other thread is writing into the shared index.
+  int16_t getElevation(const uint64_t nodeId) const override;
+
+  // Write all buffered elevations into the shared index.
+  void process() override;
+
+  // Iterate the shared index. Only valid if no other
+  // thread is writing into the shared index.
+  void forEachElevation(
+      const std::function<void(uint64_t, int16_t)>& visit) const override;
+
+  // Memory used by the index in bytes.
+  uint64_t byteSize() const override;
+
+ private:
+  // The index shared by all threads.
+  ElevationIndex& _elevationIndex;
+
+  // Guards writing into the shared index.
+  std::mutex& _mutex;
+
+  // The elevations not yet written into the shared index.
+  std::vector<IdElevation> _buffer;
+};
+
+}  // namespace index
+}  // namespace util
+
+#endif  // SRC_UTIL_INDEX_ELEVATIONINDEXBUFFER_H_
@@ -126,3 +126,8 @@ int16_t ElevationIndexDense::getElevation(const uint64_t nodeId) const {
 
   return elevation - 1000;  // Substract 1000 to allow negative elevations.
 }
+
+// ____________________________________________________________________________
+uint64_t ElevationIndexDense::byteSize() const {
+  return _denseIndex.capacity();
+}
@@ -48,6 +48,9 @@ class ElevationIndexDense : public ElevationIndex {
   // Nothing has to be done in the dense index.
   void process() override {};
 
+  // Memory used by the index in bytes.
+  uint64_t byteSize() const override;
+
  private:
   // The array that holds the index. The elevation of a node
   // can be directly accessed by the index, as the node id corresponds
@@ -3,16 +3,20 @@
 
 #include <math.h>
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include "global/Constants.h"
 #include "util/index/IdElevationAverage.h"
 #include "util/index/ElevationIndex.h"
 #include "util/index/ElevationIndexSparse.h"
+#include "util/metrics/Metrics.h"
 
 using global::INVALID_ELEV;
 using util::index::IdElevationAverage;
 using util::index::ElevationIndex;
 using util::index::ElevationIndexSparse;
+using util::metrics::Metrics;
+using util::metrics::wallSeconds;
 
 // ____________________________________________________________________________
 ElevationIndexSparse::ElevationIndexSparse(const uint64_t count,
@@ -56,6 +60,7 @@ int16_t ElevationIndexSparse::getElevation(const uint64_t nodeId) const {
 void ElevationIndexSparse::process() {
   time_t start, end;
   start = time(&start);
+  const double sortStart = wallSeconds();
   std::cout << "Sorting the sparse index by node ID." << std::endl;
   // Sort the array by node ID.
   std::sort(_sparseIndex.begin(), _sparseIndex.end(),
@@ -71,9 +76,26 @@ void ElevationIndexSparse::process() {
                                    return i.id == j.id;
                                   }), _sparseIndex.end());
 
+  Metrics::get().addSeconds("indexSortSeconds", wallSeconds() - sortStart);
+
   end = time(&end);
   double timeDiff = difftime(end, start);
   std::cout << "Done, sorting took ";
   std::cout << timeDiff;
   std::cout << " seconds." << "\n" << std::endl;
 }
+
+// ____________________________________________________________________________
+void ElevationIndexSparse::forEachElevation(
+    const std::function<void(uint64_t, int16_t)>& visit) const {
+  for (const auto& idElevation : _sparseIndex) {
+    if (idElevation.elevation != INVALID_ELEV) {
+      visit(idElevation.id, idElevation.elevation);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+uint64_t ElevationIndexSparse::byteSize() const {
+  return _sparseIndex.capacity() * sizeof(IdElevation);
+}
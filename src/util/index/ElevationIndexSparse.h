@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <cstdint>
+#include <functional>
 #include "util/index/IdElevation.h"
 #include "util/index/ElevationIndex.h"
 
@@ -33,6 +34,13 @@ class ElevationIndexSparse : public ElevationIndex {
   // When all nodes were set, sort the index by node ID.
   void process() override;
 
+  // Call visit for each node with a valid elevation, ordered by node ID.
+  void forEachElevation(
+      const std::function<void(uint64_t, int16_t)>& visit) const override;
+
+  // Memory used by the index in bytes.
+  uint64_t byteSize() const override;
+
  private:
   // The array that holds the index. Valid after being sorted by id.
   std::vector<IdElevation> _sparseIndex;
@@ -0,0 +1,201 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <bit>
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <vector>
+#include "util/index/IdBitmap.h"
+
+using util::index::IdBitmap;
+
+namespace {
+
+// The lower bits of an id are stored in the chunk of its upper bits.
+constexpr uint32_t CHUNK_BITS = 16;
+
+// A chunk with more ids uses a bitset, which is not larger.
+constexpr size_t MAX_ARRAY_SIZE = 4096;
+
+constexpr size_t BITSET_WORDS = (1 << CHUNK_BITS) / 64;
+
+// Larger ids would make the table of chunks too large.
+constexpr uint64_t MAX_CHUNK_ID = uint64_t(1) << 36;
+
+// ____________________________________________________________________________
+template <typename T>
+void writeVector(std::ostream& out, const std::vector<T>& values) {
+  const uint64_t size = values.size();
+  out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  out.write(reinterpret_cast<const char*>(values.data()),
+            size * sizeof(T));
+}
+
+// ____________________________________________________________________________
+uint64_t remainingBytes(std::istream& in) {
+  const std::streampos position = in.tellg();
+  if (position < 0) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  in.seekg(0, std::ios::end);
+  const std::streampos end = in.tellg();
+  in.seekg(position);
+  return end > position ? end - position : 0;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+bool readVector(std::istream& in, std::vector<T>* values,
+                uint64_t* bytesLeft) {
+  uint64_t size = 0;
+  in.read(reinterpret_cast<char*>(&size), sizeof(size));
+  // Don't allocate more than the rest of the stream can fill.
+  if (!in || *bytesLeft < sizeof(size) ||
+      size > (*bytesLeft - sizeof(size)) / sizeof(T)) {
+    return false;
+  }
+  *bytesLeft -= sizeof(size) + size * sizeof(T);
+  values->resize(size);
+  in.read(reinterpret_cast<char*>(values->data()), size * sizeof(T));
+  return static_cast<bool>(in);
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+void IdBitmap::insert(const uint64_t id) {
+  if (id >= MAX_CHUNK_ID) {
+    const auto position = std::lower_bound(_largeIds.begin(),
+                                           _largeIds.end(), id);
+    if (position == _largeIds.end() || *position != id) {
+      _largeIds.insert(position, id);
+      ++_size;
+    }
+    return;
+  }
+  const uint64_t chunkIndex = id >> CHUNK_BITS;
+  const uint16_t low = id & ((1 << CHUNK_BITS) - 1);
+  if (chunkIndex >= _chunks.size()) {
+    _chunks.resize(chunkIndex + 1);
+  }
+  Chunk& chunk = _chunks[chunkIndex];
+
+  if (!chunk.bits.empty()) {
+    const uint64_t bit = uint64_t(1) << (low % 64);
+    if (!(chunk.bits[low / 64] & bit)) {
+      chunk.bits[low / 64] |= bit;
+      ++_size;
+    }
+    return;
+  }
+
+  const auto position = std::lower_bound(chunk.array.begin(),
+                                         chunk.array.end(), low);
+  if (position != chunk.array.end() && *position == low) {
+    return;
+  }
+  chunk.array.insert(position, low);
+  ++_size;
+
+  // Convert to a bitset.
+  if (chunk.array.size() > MAX_ARRAY_SIZE) {
+    chunk.bits.assign(BITSET_WORDS, 0);
+    for (const auto value : chunk.array) {
+      chunk.bits[value / 64] |= uint64_t(1) << (value % 64);
+    }
+    std::vector<uint16_t>().swap(chunk.array);
+  }
+}
+
+// ____________________________________________________________________________
+bool IdBitmap::contains(const uint64_t id) const {
+  if (id >= MAX_CHUNK_ID) {
+    return std::binary_search(_largeIds.begin(), _largeIds.end(), id);
+  }
+  const uint64_t chunkIndex = id >> CHUNK_BITS;
+  if (chunkIndex >= _chunks.size()) {
+    return false;
+  }
+  const uint16_t low = id & ((1 << CHUNK_BITS) - 1);
+  const Chunk& chunk = _chunks[chunkIndex];
+  if (!chunk.bits.empty()) {
+    return chunk.bits[low / 64] & (uint64_t(1) << (low % 64));
+  }
+  return std::binary_search(chunk.array.begin(), chunk.array.end(), low);
+}
+
+// ____________________________________________________________________________
+uint64_t IdBitmap::size() const {
+  return _size;
+}
+
+// ____________________________________________________________________________
+bool IdBitmap::empty() const {
+  return _size == 0;
+}
+
+// ____________________________________________________________________________
+void IdBitmap::clear() {
+  std::vector<Chunk>().swap(_chunks);
+  std::vector<uint64_t>().swap(_largeIds);
+  _size = 0;
+}
+
+// ____________________________________________________________________________
+uint64_t IdBitmap::byteSize() const {
+  uint64_t bytes = _chunks.capacity() * sizeof(Chunk) +
+                   _largeIds.capacity() * sizeof(uint64_t);
+  for (const auto& chunk : _chunks) {
+    bytes += chunk.array.capacity() * sizeof(uint16_t) +
+             chunk.bits.capacity() * sizeof(uint64_t);
+  }
+  return bytes;
+}
+
+// ____________________________________________________________________________
+void IdBitmap::write(std::ostream& out) const {
+  // Each chunk as its array and its bitset, one of them is empty.
+  const uint64_t chunks = _chunks.size();
+  out.write(reinterpret_cast<const char*>(&chunks), sizeof(chunks));
+  for (const auto& chunk : _chunks) {
+    writeVector(out, chunk.array);
+    writeVector(out, chunk.bits);
+  }
+  writeVector(out, _largeIds);
+}
+
+// ____________________________________________________________________________
+bool IdBitmap::read(std::istream& in) {
+  clear();
+  uint64_t bytesLeft = remainingBytes(in);
+  uint64_t chunks = 0;
+  in.read(reinterpret_cast<char*>(&chunks), sizeof(chunks));
+  // Each chunk takes at least the sizes of its array and bitset.
+  if (!in || chunks > (MAX_CHUNK_ID >> CHUNK_BITS) ||
+      chunks > bytesLeft / (2 * sizeof(uint64_t))) {
+    return false;
+  }
+  bytesLeft -= sizeof(chunks);
+  _chunks.resize(chunks);
+  for (auto& chunk : _chunks) {
+    if (!readVector(in, &chunk.array, &bytesLeft) ||
+        !readVector(in, &chunk.bits, &bytesLeft) ||
+        (!chunk.bits.empty() && chunk.bits.size() != BITSET_WORDS)) {
+      clear();
+      return false;
+    }
+    _size += chunk.array.size();
+    for (const auto word : chunk.bits) {
+      _size += std::popcount(word);
+    }
+  }
+  if (!readVector(in, &_largeIds, &bytesLeft)) {
+    clear();
+    return false;
+  }
+  _size += _largeIds.size();
+  return true;
+}
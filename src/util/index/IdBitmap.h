@@ -0,0 +1,78 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_UTIL_INDEX_IDBITMAP_H_
+#define SRC_UTIL_INDEX_IDBITMAP_H_
+
+#include <vector>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace util {
+namespace index {
+
+/*
+ * Compressed set of OSM ids, similar to a roaring bitmap.
+ * The ids are split into chunks of 2^16 ids by their upper bits. A chunk
+ * holds its few ids as a sorted array of the lower 16 bits and turns into
+ * a dense bitset of 8KB once it has more than 4096 ids. So an id costs at
+ * most 2 bytes, and a lookup is a table access plus a search over at most
+ * 4096 entries or a single bit test.
+ * Ids beyond the range of OSM ids (e.g. negative ids of unsaved objects)
+ * are kept in a plain sorted list instead.
+ */
+class IdBitmap {
+ public:
+  // Add an id to the set.
+  void insert(const uint64_t id);
+
+  // Add all ids in [first, last) to the set.
+  template <typename Iterator>
+  void insert(Iterator first, const Iterator last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  // Whether the id is in the set.
+  bool contains(const uint64_t id) const;
+
+  // The number of ids in the set.
+  uint64_t size() const;
+
+  bool empty() const;
+
+  // Remove all ids.
+  void clear();
+
+  // The memory used by the set in bytes.
+  uint64_t byteSize() const;
+
+  // Write the set to a binary stream, in host byte order.
+  void write(std::ostream& out) const;
+
+  // Replace the set by one written with write. Return false if the
+  // stream ends too early or holds more ids than it has bytes left.
+  bool read(std::istream& in);
+
+ private:
+  // The ids of one chunk, either as sorted array or as bitset.
+  struct Chunk {
+    std::vector<uint16_t> array;
+    std::vector<uint64_t> bits;
+  };
+
+  // The chunks by the upper bits of the ids. Chunks without ids are empty.
+  std::vector<Chunk> _chunks;
+
+  // Sorted ids that are too large for the chunks.
+  std::vector<uint64_t> _largeIds;
+
+  uint64_t _size = 0;
+};
+
+}  // namespace index
+}  // namespace util
+
+#endif  // SRC_UTIL_INDEX_IDBITMAP_H_
@@ -0,0 +1,40 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "util/index/NodeIds.h"
+
+using util::index::NodeIds;
+
+// ____________________________________________________________________________
+void util::index::sortUnique(NodeIds& nodeIds) {
+  // Bytes that are the same for all ids don't need to be sorted.
+  uint64_t differentBits = 0;
+  for (const auto id : nodeIds) {
+    differentBits |= id ^ nodeIds.front();
+  }
+
+  // Least significant byte first, each pass is a stable counting sort.
+  NodeIds buffer(nodeIds.size());
+  for (uint32_t shift = 0; shift < 64; shift += 8) {
+    if (!((differentBits >> shift) & 0xff)) {
+      continue;
+    }
+    std::array<size_t, 257> offsets{};
+    for (const auto id : nodeIds) {
+      ++offsets[((id >> shift) & 0xff) + 1];
+    }
+    for (size_t i = 1; i < offsets.size(); ++i) {
+      offsets[i] += offsets[i - 1];
+    }
+    for (const auto id : nodeIds) {
+      buffer[offsets[(id >> shift) & 0xff]++] = id;
+    }
+    nodeIds.swap(buffer);
+  }
+
+  nodeIds.erase(std::unique(nodeIds.begin(), nodeIds.end()), nodeIds.end());
+}
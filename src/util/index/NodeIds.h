@@ -0,0 +1,24 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_UTIL_INDEX_NODEIDS_H_
+#define SRC_UTIL_INDEX_NODEIDS_H_
+
+#include <vector>
+#include <cstdint>
+
+namespace util {
+namespace index {
+
+// A sorted list of unique node ids.
+using NodeIds = std::vector<uint64_t>;
+
+// Sort the node ids with a radix sort and remove duplicates.
+// Only the bytes in which the ids differ are sorted, i.e. about five
+// passes over the ids for OSM node ids.
+void sortUnique(NodeIds& nodeIds);
+
+}  // namespace index
+}  // namespace util
+
+#endif  // SRC_UTIL_INDEX_NODEIDS_H_
@@ -1,76 +1,245 @@
 // Copyright 2022, Urs Spiegelhalter
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
-#include <math.h>
-#include <ctime>
-#include <utility>
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
 #include <vector>
+#include "global/Constants.h"
 #include "util/osm/Node.h"
+#include "util/index/NodeIds.h"
 #include "util/index/NodeIndex.h"
 
+using global::INVALID_ELEV;
 using util::osm::Node;
+using util::index::Slot;
+using util::index::SlotPaths;
 using util::index::NodeIndex;
+using util::index::NodeIds;
+
+namespace {
+
+// Coordinates are stored in units of 1e-7 degrees, as osmium does.
+constexpr double COORDINATE_PRECISION = 10000000;
+
+// The id of the node that missing ids are resolved to.
+constexpr uint64_t MISSING_ID = std::numeric_limits<uint64_t>::max();
+
+}  // namespace
 
 // ____________________________________________________________________________
 NodeIndex::NodeIndex(const uint64_t nodeCount) {
-  _nodeIndex.reserve(nodeCount);
+  _ids.reserve(nodeCount);
+  _lons.reserve(nodeCount);
+  _lats.reserve(nodeCount);
+  _elevations.reserve(nodeCount);
+}
+
+// ____________________________________________________________________________
+int32_t NodeIndex::toFixed(const double coordinate) {
+  return static_cast<int32_t>(std::lround(coordinate * COORDINATE_PRECISION));
+}
+
+// ____________________________________________________________________________
+double NodeIndex::fromFixed(const int32_t coordinate) {
+  return coordinate / COORDINATE_PRECISION;
+}
+
+// ____________________________________________________________________________
+void NodeIndex::append(const uint64_t id, const int32_t lon,
+                       const int32_t lat, const int16_t elevation) {
+  _ids.push_back(id);
+  _lons.push_back(lon);
+  _lats.push_back(lat);
+  _elevations.push_back(elevation);
 }
 
 // ____________________________________________________________________________
 void NodeIndex::setNode(const uint64_t id, const double lon,
                         const double lat, const int16_t elevation) {
-  _nodeIndex.emplace_back(id, lon, lat, elevation);
+  append(id, toFixed(lon), toFixed(lat), elevation);
+}
+
+// ____________________________________________________________________________
+void NodeIndex::setNodeFixed(const uint64_t id, const int32_t lon,
+                             const int32_t lat, const int16_t elevation) {
+  append(id, lon, lat, elevation);
 }
 
 // ____________________________________________________________________________
 void NodeIndex::updateElevation(const uint64_t id, const int16_t elevation) {
   const uint64_t index = binarySearchNodeIndex(id);
-  _nodeIndex[index].elevation = elevation;
+  _elevations[index] = elevation;
 }
 
 // ____________________________________________________________________________
-const Node& NodeIndex::getNode(const uint64_t id) const {
+Node NodeIndex::getNode(const uint64_t id) const {
   const uint64_t index = binarySearchNodeIndex(id);
-  return _nodeIndex[index];
+  return Node(_ids[index], fromFixed(_lons[index]), fromFixed(_lats[index]),
+              _elevations[index]);
 }
 
 // ____________________________________________________________________________
-uint64_t NodeIndex::binarySearchNodeIndex(const uint64_t id) const {
-  // Binary search.
-  uint64_t index = 0;
-  uint64_t left = 0;
-  uint64_t right = _nodeIndex.size();
-  while (left <= right) {
-    uint64_t m = floor((left + right) / 2);
-    if (_nodeIndex[m].id < id) {
-      left = m + 1;
-    } else if (
-      _nodeIndex[m].id > id) {
-      right = m - 1;
-    } else {
-      index = m;
-      break;
+std::vector<SlotPaths> NodeIndex::resolve(
+    const std::vector<std::vector<std::vector<uint64_t>>>& routes) {
+  // The id of each node along the routes with its position in the routes.
+  std::vector<std::pair<uint64_t, uint64_t>> ids;
+  std::vector<SlotPaths> slots(routes.size());
+  for (size_t route = 0; route < routes.size(); ++route) {
+    slots[route].resize(routes[route].size());
+    for (size_t path = 0; path < routes[route].size(); ++path) {
+      slots[route][path].resize(routes[route][path].size());
+      for (const auto id : routes[route][path]) {
+        ids.emplace_back(id, ids.size());
+      }
     }
   }
-  return index;
+  std::sort(ids.begin(), ids.end());
+
+  // Join the sorted ids with the sorted index.
+  std::vector<Slot> flatSlots(ids.size());
+  size_t node = 0;
+  for (const auto& [id, position] : ids) {
+    while (node < _ids.size() && _ids[node] < id) {
+      ++node;
+    }
+    if (node < _ids.size() && _ids[node] == id) {
+      flatSlots[position] = node;
+      continue;
+    }
+    // The largest id keeps the index sorted.
+    if (_ids.empty() || _ids.back() != MISSING_ID) {
+      append(MISSING_ID, 0, 0, INVALID_ELEV);
+    }
+    flatSlots[position] = _ids.size() - 1;
+  }
+
+  // Back into the shape of the routes.
+  auto slot = flatSlots.begin();
+  for (auto& routeSlots : slots) {
+    for (auto& pathSlots : routeSlots) {
+      std::copy(slot, slot + pathSlots.size(), pathSlots.begin());
+      slot += pathSlots.size();
+    }
+  }
+  return slots;
+}
+
+// ____________________________________________________________________________
+SlotPaths NodeIndex::resolve(const std::vector<std::vector<uint64_t>>& paths) {
+  const std::vector<std::vector<std::vector<uint64_t>>> routes{ paths };
+  return std::move(resolve(routes).front());
+}
+
+// ____________________________________________________________________________
+double NodeIndex::lon(const Slot slot) const {
+  return fromFixed(_lons[slot]);
+}
+
+// ____________________________________________________________________________
+double NodeIndex::lat(const Slot slot) const {
+  return fromFixed(_lats[slot]);
+}
+
+// ____________________________________________________________________________
+int16_t NodeIndex::elevation(const Slot slot) const {
+  return _elevations[slot];
+}
+
+// ____________________________________________________________________________
+void NodeIndex::setElevation(const Slot slot, const int16_t elevation) {
+  // The node of missing ids keeps its invalid elevation.
+  if (_ids[slot] == MISSING_ID) {
+    return;
+  }
+  _elevations[slot] = elevation;
+}
+
+// ____________________________________________________________________________
+uint64_t NodeIndex::binarySearchNodeIndex(const uint64_t id) const {
+  // Only the id array is searched. A missing id returns index 0.
+  const auto it = std::lower_bound(_ids.begin(), _ids.end(), id);
+  if (it == _ids.end() || *it != id) {
+    return 0;
+  }
+  return it - _ids.begin();
 }
 
 // ____________________________________________________________________________
 void NodeIndex::sort() {
-  // Sort the vector by node ID.
-  std::sort(_nodeIndex.begin(), _nodeIndex.end(),
-            [](const Node& i, const Node& j) {
-              return i.id <= j.id;
-            });
+  // The nodes of sorted OSM files are already added in order.
+  if (!std::is_sorted(_ids.begin(), _ids.end())) {
+    // Sort the positions by node id, then move all arrays into that order.
+    std::vector<Slot> order(_ids.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [this](const Slot i, const Slot j) {
+                       return _ids[i] < _ids[j];
+                     });
+    NodeIndex sorted(_ids.size());
+    for (const auto i : order) {
+      sorted.append(_ids[i], _lons[i], _lats[i], _elevations[i]);
+    }
+    *this = std::move(sorted);
+  }
 
-  // Remove duplicates.
-  _nodeIndex.erase(std::unique(_nodeIndex.begin(), _nodeIndex.end()),
-                   _nodeIndex.end());
+  // Remove duplicates, keeping the first node of each id.
+  size_t count = 0;
+  for (size_t i = 0; i < _ids.size(); ++i) {
+    if (count > 0 && _ids[count - 1] == _ids[i]) {
+      continue;
+    }
+    _ids[count] = _ids[i];
+    _lons[count] = _lons[i];
+    _lats[count] = _lats[i];
+    _elevations[count] = _elevations[i];
+    ++count;
+  }
+  _ids.resize(count);
+  _lons.resize(count);
+  _lats.resize(count);
+  _elevations.resize(count);
 }
 
 // ____________________________________________________________________________
 void NodeIndex::clear() {
-  _nodeIndex.clear();
+  _ids.clear();
+  _lons.clear();
+  _lats.clear();
+  _elevations.clear();
+}
+
+// ____________________________________________________________________________
+NodeIndex NodeIndex::subset(const NodeIds& nodeIds) const {
+  // Both the ids and the index are sorted, walk through them together.
+  NodeIndex nodeIndex(nodeIds.size());
+  size_t node = 0;
+  for (const auto id : nodeIds) {
+    while (node < _ids.size() && _ids[node] < id) {
+      ++node;
+    }
+    if (node == _ids.size()) {
+      break;
+    }
+    if (_ids[node] == id) {
+      nodeIndex.append(id, _lons[node], _lats[node], _elevations[node]);
+    }
+  }
+  return nodeIndex;
+}
+
+// ____________________________________________________________________________
+size_t NodeIndex::size() const {
+  return _ids.size();
+}
+
+// ____________________________________________________________________________
+uint64_t NodeIndex::byteSize() const {
+  return _ids.capacity() * sizeof(uint64_t) +
+         _lons.capacity() * sizeof(int32_t) +
+         _lats.capacity() * sizeof(int32_t) +
+         _elevations.capacity() * sizeof(int16_t);
 }
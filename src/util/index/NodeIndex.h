@@ -7,15 +7,26 @@
 #include <vector>
 #include <cstdint>
 #include "util/osm/Node.h"
+#include "util/index/NodeIds.h"
 
 namespace util {
 namespace index {
 
 using util::osm::Node;
 
+// The position of a node in a sorted node index.
+using Slot = uint32_t;
+
+// Route paths given by the slots of their nodes instead of the node ids.
+using SlotPaths = std::vector<std::vector<Slot>>;
+
 /*
  * Sparse index that maps node ids to the nodes location and elevation.
- */ 
+ * The nodes are stored as structure of arrays: the sorted ids, the
+ * coordinates in fixed point (the precision of osmium) and the elevations,
+ * which takes 18 instead of 32 bytes per node. A search only touches the
+ * id array, the correction loops only the coordinate and elevation arrays.
+ */
 class NodeIndex {
  public:
   explicit NodeIndex(const uint64_t nodeCount);
@@ -24,11 +35,33 @@ class NodeIndex {
   void setNode(const uint64_t id, const double lon,
                const double lat, const int16_t elevation);
 
+  // Add a node with coordinates in units of 1e-7 degrees.
+  void setNodeFixed(const uint64_t id, const int32_t lon, const int32_t lat,
+                    const int16_t elevation);
+
   // Update the elevation of the node.
   void updateElevation(const uint64_t id, const int16_t elevation);
 
-  // Get the node to access its information.
-  const Node& getNode(const uint64_t id) const;
+  // Get a copy of the node to access its information.
+  Node getNode(const uint64_t id) const;
+
+  // Resolve the node ids of all route paths to the slots of their nodes
+  // with a single sorted join, such that the nodes can then be accessed
+  // without any search. Ids without a node in the index get the slot of
+  // a node without location and elevation. The index must be sorted.
+  std::vector<SlotPaths> resolve(
+      const std::vector<std::vector<std::vector<uint64_t>>>& routes);
+
+  // Resolve the node ids of the paths of a single route.
+  SlotPaths resolve(const std::vector<std::vector<uint64_t>>& paths);
+
+  // Access the nodes by their slot.
+  double lon(const Slot slot) const;
+  double lat(const Slot slot) const;
+  int16_t elevation(const Slot slot) const;
+
+  // Update the elevation of the node at the slot.
+  void setElevation(const Slot slot, const int16_t elevation);
 
   // After all nodes have been added, sort the index by node id for
   // fast lookup with binary search.
@@ -37,10 +70,34 @@ class NodeIndex {
   // Clear the node index to free memory.
   void clear();
 
+  // Copy the nodes with the given ids into a new sorted index, without
+  // reading the OSM file again. The index must be sorted.
+  NodeIndex subset(const NodeIds& nodeIds) const;
+
+  // The number of nodes in the index.
+  size_t size() const;
+
+  // The memory used by the index in bytes.
+  uint64_t byteSize() const;
+
  private:
-  // The index is saved as a vector that will be sorted
-  // by node id for fast lookup.
-  std::vector<Node> _nodeIndex;
+  // Convert a coordinate from and to fixed point.
+  static int32_t toFixed(const double coordinate);
+  static double fromFixed(const int32_t coordinate);
+
+  // Append a node to the arrays.
+  void append(const uint64_t id, const int32_t lon, const int32_t lat,
+              const int16_t elevation);
+
+  // The node ids, which will be sorted for fast lookup.
+  std::vector<uint64_t> _ids;
+
+  // The coordinates in units of 1e-7 degrees, in the order of the ids.
+  std::vector<int32_t> _lons;
+  std::vector<int32_t> _lats;
+
+  // The elevations, in the order of the ids.
+  std::vector<int16_t> _elevations;
 
   // Perform binary search to retrieve
   // the node's index in the vector.
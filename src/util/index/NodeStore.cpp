@@ -0,0 +1,271 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "util/index/NodeIds.h"
+#include "util/index/NodeIndex.h"
+#include "util/index/NodeStore.h"
+
+using util::index::NodeIds;
+using util::index::NodeIndex;
+using util::index::NodeStore;
+
+namespace {
+
+// A node of the sparse layout.
+struct SparseNode {
+  uint64_t id;
+  int32_t lon;
+  int32_t lat;
+  int16_t elevation;
+} __attribute__((packed));
+
+// A node of the dense layout, at the position given by its id.
+struct DenseNode {
+  int32_t lon;
+  int32_t lat;
+  int16_t elevation;
+} __attribute__((packed));
+
+// The sparse file first has room for this many nodes, then doubles.
+constexpr uint64_t INITIAL_CAPACITY = 65536;
+
+// ____________________________________________________________________________
+uint64_t denseNodesBytes(const uint64_t ids) {
+  // The presence bits follow the nodes, aligned to 8 bytes.
+  return (ids * sizeof(DenseNode) + 7) / 8 * 8;
+}
+
+// ____________________________________________________________________________
+uint64_t denseBytes(const uint64_t ids) {
+  return denseNodesBytes(ids) + (ids + 63) / 64 * sizeof(uint64_t);
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+NodeStore::NodeStore(const std::string& file) :
+                     _file(file), _fd(-1), _data(nullptr), _bytes(0),
+                     _capacity(0), _size(0), _valid(true), _dense(false),
+                     _minId(0), _maxId(0) {
+  _valid = grow(INITIAL_CAPACITY);
+}
+
+// ____________________________________________________________________________
+NodeStore::~NodeStore() {
+  unmap();
+}
+
+// ____________________________________________________________________________
+char* NodeStore::map(const std::string& file, const uint64_t bytes,
+                     int* fd) const {
+  *fd = open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (*fd < 0) {
+    return nullptr;
+  }
+  // The file lives on as long as it is open.
+  unlink(file.c_str());
+  // Allocate the blocks up front: a store to a page of a sparse file
+  // raises SIGBUS once the disk is full, instead of failing here.
+  void* data = MAP_FAILED;
+  if (ftruncate(*fd, bytes) == 0 && posix_fallocate(*fd, 0, bytes) == 0) {
+    data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
+  }
+  if (data == MAP_FAILED) {
+    close(*fd);
+    *fd = -1;
+    return nullptr;
+  }
+  return static_cast<char*>(data);
+}
+
+// ____________________________________________________________________________
+bool NodeStore::grow(const uint64_t capacity) {
+  const uint64_t bytes = capacity * sizeof(SparseNode);
+  if (!_data) {
+    _data = map(_file, bytes, &_fd);
+  } else {
+    void* data = MAP_FAILED;
+    if (ftruncate(_fd, bytes) == 0 &&
+        posix_fallocate(_fd, 0, bytes) == 0) {
+      data = mremap(_data, _bytes, bytes, MREMAP_MAYMOVE);
+    }
+    if (data == MAP_FAILED) {
+      unmap();
+      return false;
+    }
+    _data = static_cast<char*>(data);
+  }
+  if (!_data) {
+    return false;
+  }
+  _bytes = bytes;
+  _capacity = capacity;
+  return true;
+}
+
+// ____________________________________________________________________________
+void NodeStore::unmap() {
+  if (_data) {
+    munmap(_data, _bytes);
+    _data = nullptr;
+    _bytes = 0;
+  }
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+// ____________________________________________________________________________
+void NodeStore::append(const uint64_t id, const int32_t lon,
+                       const int32_t lat, const int16_t elevation) {
+  if (!_valid) {
+    return;
+  }
+  if (_size > 0 && id <= _maxId) {
+    // Not sorted, the nodes have to be read from the OSM file.
+    _valid = false;
+    unmap();
+    return;
+  }
+  if (_size == _capacity && !grow(_capacity * 2)) {
+    _valid = false;
+    return;
+  }
+  const SparseNode node{ id, lon, lat, elevation };
+  std::memcpy(_data + _size * sizeof(SparseNode), &node, sizeof(node));
+  if (_size == 0) {
+    _minId = id;
+  }
+  _maxId = id;
+  ++_size;
+}
+
+// ____________________________________________________________________________
+void NodeStore::finish() {
+  if (!_valid || _size == 0) {
+    return;
+  }
+  const uint64_t ids = _maxId - _minId + 1;
+  if (denseBytes(ids) >= _size * sizeof(SparseNode)) {
+    // Stay sparse, but give back the room not needed.
+    if (_size < _capacity && !grow(_size)) {
+      _valid = false;
+    }
+    return;
+  }
+  int fd;
+  char* data = map(_file + ".dense", denseBytes(ids), &fd);
+  if (!data) {
+    // Not enough disk space for both layouts, stay sparse.
+    return;
+  }
+  uint64_t* present = reinterpret_cast<uint64_t*>(data +
+                                                   denseNodesBytes(ids));
+  for (uint64_t i = 0; i < _size; ++i) {
+    SparseNode node;
+    std::memcpy(&node, _data + i * sizeof(SparseNode), sizeof(node));
+    const uint64_t index = node.id - _minId;
+    const DenseNode denseNode{ node.lon, node.lat, node.elevation };
+    std::memcpy(data + index * sizeof(DenseNode), &denseNode,
+                sizeof(denseNode));
+    present[index / 64] |= uint64_t(1) << (index % 64);
+  }
+  unmap();
+  _fd = fd;
+  _data = data;
+  _bytes = denseBytes(ids);
+  _dense = true;
+}
+
+// ____________________________________________________________________________
+bool NodeStore::valid() const {
+  return _valid;
+}
+
+// ____________________________________________________________________________
+bool NodeStore::dense() const {
+  return _dense;
+}
+
+// ____________________________________________________________________________
+uint64_t NodeStore::size() const {
+  return _size;
+}
+
+// ____________________________________________________________________________
+uint64_t NodeStore::byteSize() const {
+  return _bytes;
+}
+
+// ____________________________________________________________________________
+NodeIndex NodeStore::nodeIndex(const NodeIds& nodeIds) const {
+  NodeIndex nodeIndex(nodeIds.size());
+  if (!_valid || _size == 0) {
+    return nodeIndex;
+  }
+  if (_dense) {
+    const uint64_t ids = _maxId - _minId + 1;
+    const uint64_t* present = reinterpret_cast<const uint64_t*>(
+        _data + denseNodesBytes(ids));
+    for (const auto id : nodeIds) {
+      if (id < _minId || id > _maxId) {
+        continue;
+      }
+      const uint64_t index = id - _minId;
+      if (!(present[index / 64] >> (index % 64) & 1)) {
+        continue;
+      }
+      DenseNode node;
+      std::memcpy(&node, _data + index * sizeof(DenseNode), sizeof(node));
+      nodeIndex.setNodeFixed(id, node.lon, node.lat, node.elevation);
+    }
+    return nodeIndex;
+  }
+
+  // Both are sorted. Gallop ahead from the last position, such that few
+  // needed ids only touch few pages and many are read sequentially.
+  auto idAt = [this](const uint64_t i) {
+    uint64_t id;
+    std::memcpy(&id, _data + i * sizeof(SparseNode), sizeof(id));
+    return id;
+  };
+  uint64_t position = 0;
+  for (const auto id : nodeIds) {
+    uint64_t step = 1;
+    uint64_t low = position;
+    uint64_t high = position;
+    while (high < _size && idAt(high) < id) {
+      low = high + 1;
+      high = position + step;
+      step *= 2;
+    }
+    if (high > _size) {
+      high = _size;
+    }
+    while (low < high) {
+      const uint64_t middle = low + (high - low) / 2;
+      if (idAt(middle) < id) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    position = low;
+    if (position == _size) {
+      break;
+    }
+    SparseNode node;
+    std::memcpy(&node, _data + position * sizeof(SparseNode), sizeof(node));
+    if (node.id == id) {
+      nodeIndex.setNodeFixed(id, node.lon, node.lat, node.elevation);
+    }
+  }
+  return nodeIndex;
+}
@@ -0,0 +1,97 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_UTIL_INDEX_NODESTORE_H_
+#define SRC_UTIL_INDEX_NODESTORE_H_
+
+#include <cstdint>
+#include <string>
+#include "util/index/NodeIds.h"
+#include "util/index/NodeIndex.h"
+
+namespace util {
+namespace index {
+
+/*
+ * Disk backed store of the location and elevation of all nodes of an OSM
+ * file, filled once while the file is read anyway. Later passes build
+ * their node index from the store, without decoding the nodes of the
+ * file again.
+ * The nodes are appended in the order of their ids to a sparse layout of
+ * (id, lon, lat, elevation) records. If the ids are dense enough, such
+ * as for the planet, the store is converted to a dense layout afterwards,
+ * indexed by the id itself with a bit for each present node.
+ * Both layouts are memory mapped files, which are removed right after
+ * creation, such that the operating system can page them out and they
+ * disappear together with the store. Their disk blocks are allocated
+ * before they are mapped. If a file can't be created or allocated or the
+ * nodes are not sorted by id, the store is not valid and the nodes have
+ * to be read from the OSM file.
+ */
+class NodeStore {
+ public:
+  explicit NodeStore(const std::string& file);
+
+  ~NodeStore();
+
+  NodeStore(const NodeStore&) = delete;
+  NodeStore& operator=(const NodeStore&) = delete;
+
+  // Append a node with coordinates in units of 1e-7 degrees. The ids
+  // must be ascending.
+  void append(const uint64_t id, const int32_t lon, const int32_t lat,
+              const int16_t elevation);
+
+  // After all nodes were appended, switch to the smaller layout.
+  void finish();
+
+  // Whether the store holds all appended nodes.
+  bool valid() const;
+
+  // Whether the dense layout is used.
+  bool dense() const;
+
+  // The number of nodes in the store.
+  uint64_t size() const;
+
+  // The size of the mapped files in bytes.
+  uint64_t byteSize() const;
+
+  // Build a node index of the nodes with the given sorted ids. Ids
+  // without a node are left out. Only if valid() is true.
+  NodeIndex nodeIndex(const NodeIds& nodeIds) const;
+
+ private:
+  // Map a file of the given size, removed right away. Return nullptr
+  // if the file can't be created.
+  char* map(const std::string& file, const uint64_t bytes, int* fd) const;
+
+  // Grow the sparse file to the given number of records.
+  bool grow(const uint64_t capacity);
+
+  // Unmap and close the current file.
+  void unmap();
+
+  const std::string _file;
+
+  // The mapped file and its size in bytes.
+  int _fd;
+  char* _data;
+  uint64_t _bytes;
+
+  // The number of records the sparse file has room for.
+  uint64_t _capacity;
+
+  uint64_t _size;
+  bool _valid;
+  bool _dense;
+
+  // The smallest and largest id in the store.
+  uint64_t _minId;
+  uint64_t _maxId;
+};
+
+}  // namespace index
+}  // namespace util
+
+#endif  // SRC_UTIL_INDEX_NODESTORE_H_
@@ -0,0 +1,206 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <sys/resource.h>
+#include <time.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>  // NOLINT(build/c++11)
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "util/metrics/Metrics.h"
+
+using util::metrics::Metrics;
+using util::metrics::Phase;
+using util::metrics::PhaseMetrics;
+
+namespace {
+
+// Roughly the start of the program, as the library is initialized
+// before main.
+const auto programStart = std::chrono::steady_clock::now();
+
+// ____________________________________________________________________________
+std::string escape(const std::string& value) {
+  std::string escaped;
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+// ____________________________________________________________________________
+void writeCounters(std::ostream& out,
+                   const std::map<std::string, uint64_t>& counters,
+                   const double seconds, const std::string& indent) {
+  out << "{";
+  bool first = true;
+  for (const auto& [name, value] : counters) {
+    out << (first ? "\n" : ",\n") << indent << "  \"" << escape(name)
+        << "\": " << value;
+    // Throughput of the phase.
+    if (seconds > 0) {
+      out << ",\n" << indent << "  \"" << escape(name) << "PerSecond\": "
+          << value / seconds;
+    }
+    first = false;
+  }
+  out << (first ? "}" : "\n" + indent + "}");
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+double util::metrics::wallSeconds() {
+  const std::chrono::duration<double> seconds =
+    std::chrono::steady_clock::now() - programStart;
+  return seconds.count();
+}
+
+// ____________________________________________________________________________
+double util::metrics::cpuSeconds() {
+  // CPU time of all threads of the process.
+  timespec time;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// ____________________________________________________________________________
+uint64_t util::metrics::peakRssBytes() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  // Linux reports kilobytes.
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+}
+
+// ____________________________________________________________________________
+uint64_t util::metrics::fileBytes(const std::string& file) {
+  std::error_code error;
+  const auto bytes = std::filesystem::file_size(file, error);
+  return error ? 0 : bytes;
+}
+
+// ____________________________________________________________________________
+Metrics& Metrics::get() {
+  static Metrics metrics;
+  return metrics;
+}
+
+// ____________________________________________________________________________
+void Metrics::add(const std::string& counter, const uint64_t value) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _counters[counter] += value;
+}
+
+// ____________________________________________________________________________
+void Metrics::addSeconds(const std::string& duration, const double seconds) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _durations[duration] += seconds;
+}
+
+// ____________________________________________________________________________
+void Metrics::addPhase(const PhaseMetrics& phase) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _phases.push_back(phase);
+}
+
+// ____________________________________________________________________________
+uint64_t Metrics::getCounter(const std::string& counter) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  const auto it = _counters.find(counter);
+  return it == _counters.end() ? 0 : it->second;
+}
+
+// ____________________________________________________________________________
+std::vector<PhaseMetrics> Metrics::getPhases() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _phases;
+}
+
+// ____________________________________________________________________________
+void Metrics::clear() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _phases.clear();
+  _counters.clear();
+  _durations.clear();
+}
+
+// ____________________________________________________________________________
+void Metrics::writeJson(const std::string& file,
+                        const std::string& program) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::ofstream out(file);
+  if (!out) {
+    throw std::runtime_error("Could not write the metrics to " + file);
+  }
+  out << std::fixed << std::setprecision(6);
+  out << "{\n";
+  out << "  \"program\": \"" << escape(program) << "\",\n";
+  out << "  \"wallSeconds\": " << wallSeconds() << ",\n";
+  out << "  \"cpuSeconds\": " << cpuSeconds() << ",\n";
+  out << "  \"peakRssBytes\": " << peakRssBytes() << ",\n";
+  out << "  \"phases\": [";
+  for (size_t i = 0; i < _phases.size(); ++i) {
+    const auto& phase = _phases[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\n";
+    out << "      \"name\": \"" << escape(phase.name) << "\",\n";
+    out << "      \"wallSeconds\": " << phase.wallSeconds << ",\n";
+    out << "      \"cpuSeconds\": " << phase.cpuSeconds << ",\n";
+    out << "      \"peakRssBytes\": " << phase.peakRssBytes << ",\n";
+    out << "      \"counters\": ";
+    writeCounters(out, phase.counters, phase.wallSeconds, "      ");
+    out << "\n    }";
+  }
+  out << (_phases.empty() ? "],\n" : "\n  ],\n");
+  out << "  \"counters\": ";
+  writeCounters(out, _counters, 0, "  ");
+  out << ",\n";
+  out << "  \"durations\": {";
+  bool first = true;
+  for (const auto& [name, seconds] : _durations) {
+    out << (first ? "\n" : ",\n") << "    \"" << escape(name)
+        << "\": " << seconds;
+    first = false;
+  }
+  out << (first ? "}\n" : "\n  }\n");
+  out << "}\n";
+  if (!out) {
+    throw std::runtime_error("Could not write the metrics to " + file);
+  }
+}
+
+// ____________________________________________________________________________
+Phase::Phase(const std::string& name) :
+    _wallStart(wallSeconds()), _cpuStart(cpuSeconds()), _ended(false) {
+  _metrics.name = name;
+}
+
+// ____________________________________________________________________________
+Phase::~Phase() {
+  end();
+}
+
+// ____________________________________________________________________________
+void Phase::add(const std::string& counter, const uint64_t value) {
+  _metrics.counters[counter] += value;
+}
+
+// ____________________________________________________________________________
+double Phase::end() {
+  if (!_ended) {
+    _metrics.wallSeconds = wallSeconds() - _wallStart;
+    _metrics.cpuSeconds = cpuSeconds() - _cpuStart;
+    _metrics.peakRssBytes = peakRssBytes();
+    Metrics::get().addPhase(_metrics);
+    _ended = true;
+  }
+  return _metrics.wallSeconds;
+}
@@ -0,0 +1,114 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_UTIL_METRICS_METRICS_H_
+#define SRC_UTIL_METRICS_METRICS_H_
+
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <vector>
+
+namespace util {
+namespace metrics {
+
+// Wall and CPU time of the process so far in seconds.
+double wallSeconds();
+double cpuSeconds();
+
+// Peak resident set size of the process so far in bytes.
+uint64_t peakRssBytes();
+
+// Size of the given file in bytes, 0 if it doesn't exist.
+uint64_t fileBytes(const std::string& file);
+
+/*
+ * Metrics of a finished phase: the wall and CPU time it took, the peak
+ * resident set size at its end and counters like the number of processed
+ * nodes or the bytes read and written.
+ */
+struct PhaseMetrics {
+  std::string name;
+  double wallSeconds;
+  double cpuSeconds;
+  uint64_t peakRssBytes;
+  std::map<std::string, uint64_t> counters;
+};
+
+/*
+ * Collects the metrics of all phases of a program run and counters not
+ * bound to a phase, like the number of NASADEM files loaded. All metrics
+ * can be written to a JSON file, such that performance can be tracked
+ * across releases and input sizes. Thread safe.
+ */
+class Metrics {
+ public:
+  // The metrics of this program run.
+  static Metrics& get();
+
+  // Add to a counter not bound to a phase.
+  void add(const std::string& counter, const uint64_t value);
+
+  // Add to a duration in seconds not bound to a phase.
+  void addSeconds(const std::string& duration, const double seconds);
+
+  // Record a finished phase.
+  void addPhase(const PhaseMetrics& phase);
+
+  uint64_t getCounter(const std::string& counter) const;
+
+  std::vector<PhaseMetrics> getPhases() const;
+
+  // Write all metrics as JSON. Throughputs are derived from the counters of
+  // each phase and its wall time.
+  void writeJson(const std::string& file, const std::string& program) const;
+
+  // Forget all metrics recorded so far.
+  void clear();
+
+ private:
+  Metrics() = default;
+
+  mutable std::mutex _mutex;
+
+  std::vector<PhaseMetrics> _phases;
+
+  std::map<std::string, uint64_t> _counters;
+
+  std::map<std::string, double> _durations;
+};
+
+/*
+ * Measures a phase from construction until end() is called or the phase
+ * goes out of scope, and records it in the metrics of the program run.
+ */
+class Phase {
+ public:
+  explicit Phase(const std::string& name);
+
+  ~Phase();
+
+  Phase(const Phase&) = delete;
+  Phase& operator=(const Phase&) = delete;
+
+  // Add to a counter of this phase, e.g. the number of processed nodes.
+  void add(const std::string& counter, const uint64_t value);
+
+  // End the phase and return its wall time in seconds.
+  double end();
+
+ private:
+  PhaseMetrics _metrics;
+
+  double _wallStart;
+
+  double _cpuStart;
+
+  bool _ended;
+};
+
+}  // namespace metrics
+}  // namespace util
+
+#endif  // SRC_UTIL_METRICS_METRICS_H_
@@ -2,12 +2,16 @@
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
 #include <math.h>
+#include <algorithm>
 #include <osmium/osm.hpp>
 #include "util/osm/OsmStats.h"
 #include "util/osm/GetOsmStats.h"
 
 using util::osm::GetOsmStats;
 using util::osm::OsmStats;
+using util::osm::tileIndex;
+using util::osm::TILES_LON;
+using util::osm::TILES_LAT;
 
 // ____________________________________________________________________________
 GetOsmStats::GetOsmStats() {
@@ -22,6 +26,8 @@ GetOsmStats::GetOsmStats() {
   _minLat = 90.0;
   _maxLon = -180.0;
   _maxLat = -90.0;
+
+  _tileNodeCounts.assign(TILES_LON * TILES_LAT, 0);
 }
 
 // ____________________________________________________________________________
@@ -38,12 +44,15 @@ OsmStats GetOsmStats::getOsmStats() {
   osmStats.relationCount = _relationCount;
   osmStats.min = _min;
   osmStats.max = _max;
+  osmStats.tileNodeCounts = _tileNodeCounts;
 
   return osmStats;
 }
 
 // ____________________________________________________________________________
 void GetOsmStats::node(const osmium::Node& node) {
+  // Deleted nodes of an OsmChange file have no location.
+  if (!node.visible()) { return; }
   ++_nodeCount;
   if (node.id() < _min) { _min = node.id(); }
   if (node.id() > _max) { _max = node.id(); }
@@ -56,6 +65,14 @@ void GetOsmStats::node(const osmium::Node& node) {
   if (lat < _minLat) { _minLat = lat; }
   if (lon > _maxLon) { _maxLon = lon; }
   if (lat > _maxLat) { _maxLat = lat; }
+
+  // Count the node for its tile. Nodes on the east or north edge of
+  // the earth belong to the last tile.
+  const int16_t tileLon = std::min(static_cast<int16_t>(floor(lon)),
+                                   static_cast<int16_t>(179));
+  const int16_t tileLat = std::min(static_cast<int16_t>(floor(lat)),
+                                   static_cast<int16_t>(89));
+  ++_tileNodeCounts[tileIndex(tileLon, tileLat)];
 }
 
 // ____________________________________________________________________________
@@ -5,6 +5,7 @@
 #define SRC_UTIL_OSM_GETOSMSTATS_H_
 
 #include <cstdint>
+#include <vector>
 #include "parser/OsmHandler.h"
 #include "util/osm/OsmStats.h"
 
@@ -45,6 +46,9 @@ class GetOsmStats : public OsmHandler {
   double _minLat;
   double _maxLon;
   double _maxLat;
+
+  // The number of nodes in each 1 degree tile.
+  std::vector<uint64_t> _tileNodeCounts;
 };
 
 }  // namespace osm
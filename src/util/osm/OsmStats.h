@@ -5,10 +5,22 @@
 #define SRC_UTIL_OSM_OSMSTATS_H_
 
 #include <cstdint>
+#include <cstddef>
+#include <vector>
 
 namespace util {
 namespace osm {
 
+// Number of 1 degree tiles in longitude and latitude direction.
+static const uint16_t TILES_LON = 360;
+static const uint16_t TILES_LAT = 180;
+
+// Index of the 1 degree tile with the given bottom-left corner
+// in the node histogram.
+inline size_t tileIndex(const int16_t lon, const int16_t lat) {
+  return static_cast<size_t>(lat + 90) * TILES_LON + (lon + 180);
+}
+
 struct OsmStats {
   int16_t minLon;
   int16_t minLat;
@@ -19,6 +31,9 @@ struct OsmStats {
   uint64_t relationCount;
   uint64_t min;
   uint64_t max;
+  // Number of nodes in each 1 degree tile, see tileIndex().
+  // Empty if no histogram was collected.
+  std::vector<uint64_t> tileNodeCounts;
 };
 
 }  // namespace osm
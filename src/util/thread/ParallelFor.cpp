@@ -0,0 +1,68 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+#include "util/thread/ParallelFor.h"
+
+// ____________________________________________________________________________
+void util::thread::parallelFor(
+    const uint64_t count, const uint16_t threads,
+    const std::function<void(uint64_t, uint16_t)>& work) {
+  // No more threads than items.
+  const uint16_t threadCount =
+      std::min<uint64_t>(std::max<uint16_t>(threads, 1), count);
+  if (threadCount <= 1) {
+    for (uint64_t i = 0; i < count; ++i) {
+      work(i, 0);
+    }
+    return;
+  }
+
+  // Small batches keep the threads busy until the end, while taking a
+  // batch is rare enough to not be contended.
+  const uint64_t batch = std::max<uint64_t>(1, count / (threadCount * 16));
+  std::atomic<uint64_t> next = 0;
+  std::mutex mutex;
+  std::exception_ptr error = nullptr;
+
+  auto worker = [&](const uint16_t thread) {
+    try {
+      while (true) {
+        const uint64_t first = next.fetch_add(batch);
+        if (first >= count) {
+          return;
+        }
+        const uint64_t last = std::min(first + batch, count);
+        for (uint64_t i = first; i < last; ++i) {
+          work(i, thread);
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next = count;
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threadCount - 1);
+  for (uint16_t thread = 1; thread < threadCount; ++thread) {
+    workers.emplace_back(worker, thread);
+  }
+  worker(0);
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
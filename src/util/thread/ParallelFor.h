@@ -0,0 +1,26 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_UTIL_THREAD_PARALLELFOR_H_
+#define SRC_UTIL_THREAD_PARALLELFOR_H_
+
+#include <cstdint>
+#include <functional>
+
+namespace util {
+namespace thread {
+
+// Call work(i, thread) for each i in [0, count) on the given number of
+// threads. The threads take the next few items whenever they are done, so
+// a thread with cheap items takes over the items others didn't get to.
+// Each thread has its own number in [0, threads) to access per-thread data.
+// With a single thread, the work is done on the calling thread in order.
+// If any work throws, no further work is started and the first exception
+// is rethrown when all threads are done.
+void parallelFor(const uint64_t count, const uint16_t threads,
+                 const std::function<void(uint64_t, uint16_t)>& work);
+
+}  // namespace thread
+}  // namespace util
+
+#endif  // SRC_UTIL_THREAD_PARALLELFOR_H_
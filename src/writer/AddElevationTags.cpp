@@ -1,7 +1,11 @@
 // Copyright 2022, Urs Spiegelhalter
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
+#include <array>
+#include <charconv>
+#include <cstring>
 #include <string>
+#include <vector>
 #include <osmium/memory/buffer.hpp>
 #include <osmium/osm/node.hpp>
 #include "util/index/ElevationIndex.h"
@@ -11,6 +15,8 @@
 using writer::AddElevationTags;
 using global::INVALID_ELEV;
 using global::DEFAULT_ELE_TAG;
+using global::MIN_ELEV_EARTH;
+using global::MAX_ELEV_EARTH;
 using util::index::ElevationIndex;
 
 // ____________________________________________________________________________
@@ -18,39 +24,91 @@ AddElevationTags::AddElevationTags(
     osmium::memory::Buffer& buffer,
     ElevationIndex* elevationIndex,
     const std::string& elevationTag,
-    const bool overwrite) :
-    m_buffer(buffer),
+    const bool overwrite,
+    const bool changesOnly) :
+    _buffer(&buffer),
     _elevationIndex(elevationIndex),
     _elevationTag(elevationTag),
-    _overwrite(overwrite) {}
+    _overwrite(overwrite),
+    _changesOnly(changesOnly) {}
+
+// ____________________________________________________________________________
+void AddElevationTags::setBuffer(osmium::memory::Buffer& buffer) {
+  _buffer = &buffer;
+}
+
+// ____________________________________________________________________________
+const char* AddElevationTags::elevationString(const int16_t elevation,
+                                              char (&chars)[8]) {
+  // All elevations on earth, each one in 8 characters.
+  static const std::vector<std::array<char, 8>> table = [] {
+    std::vector<std::array<char, 8>> table(MAX_ELEV_EARTH - MIN_ELEV_EARTH + 1);
+    for (int32_t i = 0; i < static_cast<int32_t>(table.size()); ++i) {
+      auto& entry = table[i];
+      const auto result = std::to_chars(entry.data(),
+                                        entry.data() + entry.size() - 1,
+                                        i + MIN_ELEV_EARTH);
+      *result.ptr = '\0';
+    }
+    return table;
+  }();
+
+  if (elevation >= MIN_ELEV_EARTH && elevation <= MAX_ELEV_EARTH) {
+    return table[elevation - MIN_ELEV_EARTH].data();
+  }
+  const auto result = std::to_chars(chars, chars + sizeof(chars) - 1,
+                                    elevation);
+  *result.ptr = '\0';
+  return chars;
+}
 
 // ____________________________________________________________________________
 void AddElevationTags::node(const osmium::Node& node) {
+  const int16_t elevation = _elevationIndex->getElevation(node.id());
+  if (_changesOnly && !changesNode(node, elevation)) {
+    return;
+  }
   {
-    osmium::builder::NodeBuilder builder{m_buffer};
+    osmium::builder::NodeBuilder builder{*_buffer};
     // Copy common object attributes over to the new node.
     copy_attributes(builder, node);
+    // A changed node is a new version of the node.
+    if (_changesOnly) {
+      builder.set_version(node.version() + 1);
+    }
 
     // Copy the location over to the new node.
     builder.set_location(node.location());
 
-    const std::string elevation =
-      std::to_string(_elevationIndex->getElevation(node.id()));
-
     if (!_overwrite) {
       buildTagsAddElevation(node, builder, elevation);
     } else {
       buildTagsUpdateElevation(node, builder, elevation);
     }
   }
-  m_buffer.commit();
+  _buffer->commit();
+}
+
+// ____________________________________________________________________________
+bool AddElevationTags::changesNode(const osmium::Node& node,
+                                   const int16_t elevation) const {
+  if (elevation == INVALID_ELEV) {
+    return false;
+  }
+  if (!_overwrite) {
+    return !node.tags().has_key(DEFAULT_ELE_TAG);
+  }
+  // The tag is only updated if the value differs.
+  const char* value = node.tags()[_elevationTag.c_str()];
+  char chars[8];
+  return !value || std::strcmp(value, elevationString(elevation, chars));
 }
 
 // ____________________________________________________________________________
 void AddElevationTags::buildTagsAddElevation(
     const osmium::Node& node,
     osmium::builder::NodeBuilder& builder,
-    const std::string& elevation) {
+    const int16_t elevation) {
   // Copy the existing tags and check if the default
   // elevation tag ("ele") was present.
   bool defaultTagPresent = false;
@@ -63,8 +121,9 @@ void AddElevationTags::buildTagsAddElevation(
   }
   // Add the elevation tag if the elevation is valid and the
   // default elevation tag was not present before.
-  if (elevation != std::to_string(INVALID_ELEV) && !defaultTagPresent) {
-    tagBuilder.add_tag(_elevationTag, elevation);
+  if (elevation != INVALID_ELEV && !defaultTagPresent) {
+    tagBuilder.add_tag(_elevationTag.c_str(),
+                       elevationString(elevation, _elevationChars));
   }
 }
 
@@ -72,7 +131,7 @@ void AddElevationTags::buildTagsAddElevation(
 void AddElevationTags::buildTagsUpdateElevation(
     const osmium::Node& node,
     osmium::builder::NodeBuilder& builder,
-    const std::string& elevation) {
+    const int16_t elevation) {
   // Copy the existing tags excluding the elevation tag.
   bool elevationTagPresent = false;
   osmium::builder::TagListBuilder tagBuilder{builder};
@@ -84,35 +143,25 @@ void AddElevationTags::buildTagsUpdateElevation(
     }
   }
   // Add the elevation tag with the updated elevation if valid.
-  if (elevation != std::to_string(INVALID_ELEV)) {
-    tagBuilder.add_tag(_elevationTag, elevation);
+  if (elevation != INVALID_ELEV) {
+    tagBuilder.add_tag(_elevationTag.c_str(),
+                       elevationString(elevation, _elevationChars));
   } else if (elevationTagPresent) {
-    tagBuilder.add_tag(_elevationTag, node.tags()[_elevationTag.c_str()]);
+    tagBuilder.add_tag(_elevationTag.c_str(),
+                       node.tags()[_elevationTag.c_str()]);
   }
 }
 
 // ____________________________________________________________________________
 void AddElevationTags::way(const osmium::Way& way) {
-  {
-    osmium::builder::WayBuilder builder{m_buffer};
-    copy_attributes(builder, way);
-    builder.add_item(way.tags());
-
-    // Copy the node list over to the new way.
-    builder.add_item(way.nodes());
-  }
-  m_buffer.commit();
+  // Ways are not changed, copy the item as it is.
+  _buffer->add_item(way);
+  _buffer->commit();
 }
 
 // ____________________________________________________________________________
 void AddElevationTags::relation(const osmium::Relation& relation) {
-  {
-    osmium::builder::RelationBuilder builder{m_buffer};
-    copy_attributes(builder, relation);
-    builder.add_item(relation.tags());
-
-    // Copy the relation member list over to the new way.
-    builder.add_item(relation.members());
-  }
-  m_buffer.commit();
+  // Relations are not changed, copy the item as it is.
+  _buffer->add_item(relation);
+  _buffer->commit();
 }
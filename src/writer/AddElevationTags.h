@@ -4,6 +4,7 @@
 #ifndef SRC_WRITER_ADDELEVATIONTAGS_H_
 #define SRC_WRITER_ADDELEVATIONTAGS_H_
 
+#include <cstdint>
 #include <string>
 #include <osmium/builder/osm_object_builder.hpp>
 #include <osmium/handler.hpp>
@@ -15,33 +16,52 @@ using util::index::ElevationIndex;
 
 // The functions in this class will be called for each object in the input
 // and will write a (changed) copy of those objects to the given buffer.
+// Writing a node doesn't allocate any memory besides the buffer itself.
+// With changesOnly, only nodes whose elevation tag is added or updated are
+// written, with their version increased by one, as needed for an
+// OsmChange file.
 class AddElevationTags : public osmium::handler::Handler {
  public:
   // Constructor. New data will be added to the given buffer.
   explicit AddElevationTags(osmium::memory::Buffer& buffer,
                             ElevationIndex* elevationIndex,
                             const std::string& elevationTag,
-                            const bool overwrite);
+                            const bool overwrite,
+                            const bool changesOnly = false);
+
+  // Add new data to another buffer from now on.
+  void setBuffer(osmium::memory::Buffer& buffer);
 
   // The node handler is called for each node in the input data.
   void node(const osmium::Node& node);
 
+  // Whether writing the node with the given elevation adds or updates
+  // its elevation tag.
+  bool changesNode(const osmium::Node& node, const int16_t elevation) const;
+
   void buildTagsAddElevation(const osmium::Node& node,
                              osmium::builder::NodeBuilder& builder,
-                             const std::string& elevation);
+                             const int16_t elevation);
 
   void buildTagsUpdateElevation(const osmium::Node& node,
                                 osmium::builder::NodeBuilder& builder,
-                                const std::string& elevation);
+                                const int16_t elevation);
 
   // The way handler is called for each way in the input data.
+  // The way is copied to the buffer unchanged.
   void way(const osmium::Way& way);
 
   // The relation handler is called for each relation in the input data.
+  // The relation is copied to the buffer unchanged.
   void relation(const osmium::Relation& relation);
 
+  // Get the elevation as a string. Elevations on earth are looked up in
+  // a table built once, others are written into the given characters.
+  static const char* elevationString(const int16_t elevation,
+                                     char (&chars)[8]);
+
  private:
-  osmium::memory::Buffer& m_buffer;
+  osmium::memory::Buffer* _buffer;
 
   ElevationIndex* _elevationIndex;
 
@@ -49,6 +69,11 @@ class AddElevationTags : public osmium::handler::Handler {
 
   const bool _overwrite;
 
+  const bool _changesOnly;
+
+  // Holds the string of an elevation not on earth.
+  char _elevationChars[8];
+
   // Copy attributes common to all OSM objects (nodes, ways, and relations).
   template <typename T>
   void copy_attributes(T& builder, const osmium::OSMObject& object) {
@@ -59,7 +84,8 @@ class AddElevationTags : public osmium::handler::Handler {
       .set_changeset(object.changeset())
       .set_timestamp(object.timestamp())
       .set_uid(object.uid())
-      .set_user(object.user());
+      .set_user(object.user())
+      .set_visible(object.visible());
   }
 };
 
@@ -6,6 +6,8 @@
 #include <ctime>
 #include <osmium/io/any_input.hpp>
 #include <osmium/io/any_output.hpp>
+#include <osmium/memory/item.hpp>
+#include <osmium/osm/tag.hpp>
 #include <osmium/visitor.hpp>
 #include <osmium/util/progress_bar.hpp>
 #include "util/index/ElevationIndex.h"
@@ -47,6 +49,11 @@ void OsmAddElevationWriter::write() {
     };
   // Initialize progress bar, enable it only if STDERR is a TTY.
   osmium::ProgressBar progress{reader.file_size(), osmium::isatty(2)};
+  // The handler adds the changed nodes and the unchanged ways and
+  // relations to the current output buffer.
+  osmium::memory::Buffer output_buffer;
+  AddElevationTags handler{output_buffer, _elevationIndex,
+                           _elevationTag, _overwrite};
   // Read in buffers with OSM objects until there are no more.
   uint64_t count = 0;
   while (osmium::memory::Buffer input_buffer = reader.read()) {
@@ -55,18 +62,22 @@ void OsmAddElevationWriter::write() {
     if (count % 10000 == 0) {
       progress.update(reader.offset());
     }
-    // Create an empty buffer with the same size as the input buffer.
-    // We'll copy the changed data into output buffer, the changes
-    // are small, so the output buffer needs to be about the same size.
-    // In case it has to be bigger, we allow it to grow automatically
-    // by adding the auto_grow::yes parameter.
-    osmium::memory::Buffer output_buffer{
-      input_buffer.committed(), osmium::memory::Buffer::auto_grow::yes
+    // Only nodes are changed, so buffers without nodes
+    // can be written out as they are.
+    const uint64_t nodes = countNodes(input_buffer);
+    if (nodes == 0) {
+      writer(std::move(input_buffer));
+      continue;
+    }
+    // Create an empty buffer large enough for the input buffer plus an
+    // elevation tag for each node, so it never has to grow while adding
+    // nodes. The writer takes ownership of the buffer, so a new one is
+    // needed for each input buffer.
+    output_buffer = osmium::memory::Buffer{
+      input_buffer.committed() + nodes * bytesPerElevationTag(),
+      osmium::memory::Buffer::auto_grow::yes
       };
-    // Construct a handler as defined above and feed the input buffer
-    // to it.
-    AddElevationTags handler{output_buffer, _elevationIndex,
-                             _elevationTag, _overwrite};
+    handler.setBuffer(output_buffer);
     osmium::apply(input_buffer, handler);
 
     // Write out the contents of the output buffer.
@@ -83,3 +94,21 @@ void OsmAddElevationWriter::write() {
   std::cout << timeDiff;
   std::cout << " seconds." << "\n" << std::endl;
 }
+
+// ____________________________________________________________________________
+uint64_t OsmAddElevationWriter::countNodes(
+    const osmium::memory::Buffer& buffer) {
+  uint64_t nodes = 0;
+  for (const auto& item : buffer) {
+    nodes += item.type() == osmium::item_type::node;
+  }
+  return nodes;
+}
+
+// ____________________________________________________________________________
+size_t OsmAddElevationWriter::bytesPerElevationTag() const {
+  // A tag list (if the node had no tags before), the key and the
+  // elevation with at most 6 characters, each string null terminated.
+  const size_t bytes = sizeof(osmium::TagList) + _elevationTag.size() + 8;
+  return osmium::memory::padded_length(bytes);
+}
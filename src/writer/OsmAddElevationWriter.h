@@ -4,7 +4,9 @@
 #ifndef SRC_WRITER_OSMADDELEVATIONWRITER_H_
 #define SRC_WRITER_OSMADDELEVATIONWRITER_H_
 
+#include <cstdint>
 #include <string>
+#include <osmium/memory/buffer.hpp>
 #include "util/index/ElevationIndex.h"
 
 namespace writer {
@@ -22,6 +24,12 @@ class OsmAddElevationWriter {
   void write();
 
  private:
+  // Count the nodes in the buffer.
+  static uint64_t countNodes(const osmium::memory::Buffer& buffer);
+
+  // The maximum number of bytes adding the elevation tag to a node needs.
+  size_t bytesPerElevationTag() const;
+
   const std::string& _inFile;
 
   const std::string& _outFile;
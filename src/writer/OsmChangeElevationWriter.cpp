@@ -0,0 +1,102 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <string>
+#include <utility>
+#include <ctime>
+#include <osmium/io/any_input.hpp>
+#include <osmium/io/any_output.hpp>
+#include <osmium/memory/item.hpp>
+#include <osmium/visitor.hpp>
+#include <osmium/util/progress_bar.hpp>
+#include "util/index/ElevationIndex.h"
+#include "writer/AddElevationTags.h"
+#include "writer/OsmChangeElevationWriter.h"
+
+using util::index::ElevationIndex;
+using writer::AddElevationTags;
+using writer::OsmChangeElevationWriter;
+
+// ____________________________________________________________________________
+OsmChangeElevationWriter::OsmChangeElevationWriter(
+    const std::string& inFile,
+    const std::string& outFile,
+    ElevationIndex* elevationIndex,
+    const std::string& elevationTag,
+    const bool overwrite) :
+    _inFile(inFile),
+    _outFile(outFile),
+    _elevationIndex(elevationIndex),
+    _elevationTag(elevationTag),
+    _overwrite(overwrite) {
+}
+
+// ____________________________________________________________________________
+std::string OsmChangeElevationWriter::changeFormat(
+    const std::string& outFile) {
+  for (const std::string format : { "osc", "osc.gz", "osc.bz2" }) {
+    if (outFile.ends_with("." + format)) {
+      return format;
+    }
+  }
+  return "osc.gz";
+}
+
+// ____________________________________________________________________________
+uint64_t OsmChangeElevationWriter::write() {
+  time_t start, end;
+  start = time(&start);
+  std::cout << "\nWriting the changed nodes to the OsmChange file ";
+  std::cout << _outFile << std::endl;
+  // Only nodes can change, ways and relations are not even read.
+  osmium::io::Reader reader{_inFile, osmium::osm_entity_bits::node};
+
+  osmium::io::Header header = reader.header();
+  header.set("generator", "osmium_add_elevation_tags");
+
+  osmium::io::Writer writer {
+    osmium::io::File{_outFile, changeFormat(_outFile)}, header
+    };
+  // Initialize progress bar, enable it only if STDERR is a TTY.
+  osmium::ProgressBar progress{reader.file_size(), osmium::isatty(2)};
+  // The handler only adds the changed nodes to the output buffer. It only
+  // grows as far as nodes change.
+  osmium::memory::Buffer output_buffer{
+    1024 * 1024, osmium::memory::Buffer::auto_grow::yes
+    };
+  AddElevationTags handler{output_buffer, _elevationIndex,
+                           _elevationTag, _overwrite, true};
+  uint64_t count = 0;
+  uint64_t changed = 0;
+  while (osmium::memory::Buffer input_buffer = reader.read()) {
+    ++count;
+    // No need to update for every single entity.
+    if (count % 10000 == 0) {
+      progress.update(reader.offset());
+    }
+    osmium::apply(input_buffer, handler);
+
+    if (output_buffer.committed() > 0) {
+      for (const auto& item : output_buffer) {
+        changed += item.type() == osmium::item_type::node;
+      }
+      // The writer takes ownership of the buffer, so only then a new one
+      // is needed. Otherwise the empty buffer is used again.
+      writer(std::move(output_buffer));
+      output_buffer = osmium::memory::Buffer{
+        1024 * 1024, osmium::memory::Buffer::auto_grow::yes
+        };
+    }
+  }
+  // Progress bar is done.
+  progress.done();
+  writer.close();
+  reader.close();
+
+  end = time(&end);
+  double timeDiff = difftime(end, start);
+  std::cout << "Done, writing " << changed << " changed nodes took ";
+  std::cout << timeDiff;
+  std::cout << " seconds." << "\n" << std::endl;
+  return changed;
+}
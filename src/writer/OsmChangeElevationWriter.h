@@ -0,0 +1,51 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#ifndef SRC_WRITER_OSMCHANGEELEVATIONWRITER_H_
+#define SRC_WRITER_OSMCHANGEELEVATIONWRITER_H_
+
+#include <cstdint>
+#include <string>
+#include "util/index/ElevationIndex.h"
+
+namespace writer {
+
+using util::index::ElevationIndex;
+
+/*
+ * Write an OsmChange file that only contains the nodes whose elevation
+ * tag is added or updated. Only the nodes of the input file are read, so
+ * the size of the output and the time needed to write it depend on the
+ * number of changed nodes instead of the size of the input file.
+ * Unless the output file name ends with .osc, .osc.gz or .osc.bz2, the
+ * file is written as gzip compressed OsmChange file.
+ */
+class OsmChangeElevationWriter {
+ public:
+  OsmChangeElevationWriter(const std::string& inFile,
+                           const std::string& outFile,
+                           ElevationIndex* elevationIndex,
+                           const std::string& elevationTag,
+                           const bool overwrite);
+
+  // Write the changed nodes and return how many there are.
+  uint64_t write();
+
+  // The osmium format string for the given output file name.
+  static std::string changeFormat(const std::string& outFile);
+
+ private:
+  const std::string& _inFile;
+
+  const std::string& _outFile;
+
+  ElevationIndex* _elevationIndex;
+
+  const std::string& _elevationTag;
+
+  const bool _overwrite;
+};
+
+}  // namespace writer
+
+#endif  // SRC_WRITER_OSMCHANGEELEVATIONWRITER_H_
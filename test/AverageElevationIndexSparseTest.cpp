@@ -3,6 +3,7 @@
 
 #include <gtest/gtest.h>
 #include <cstdint>
+#include <sstream>
 #include "global/Constants.h"
 #include "util/index/AverageElevationIndexSparse.h"
 
@@ -176,3 +177,84 @@ TEST(AverageElevationIndexSparseTest, floats) {
   ASSERT_EQ(1, averageElevationIndexSparse.getElevation(1));
   ASSERT_EQ(2, averageElevationIndexSparse.getElevation(2));
 }
+
+// ____________________________________________________________________________
+TEST(AverageElevationIndexSparseTest, weights) {
+  AverageElevationIndexSparse averageElevationIndexSparse(5, 5);
+
+  // A weight of 3 counts like three elevations.
+  averageElevationIndexSparse.setElevation(1, (float)10, 3);
+  averageElevationIndexSparse.setElevation(1, (float)50, 1);
+  averageElevationIndexSparse.setElevation(2, (float)10, 0);
+  averageElevationIndexSparse.setElevation(3, (float)30, 2);
+  averageElevationIndexSparse.setElevationTunnelOrBridge(3, (float)5);
+
+  averageElevationIndexSparse.process();
+  ASSERT_EQ(20, averageElevationIndexSparse.getElevation(1));
+  ASSERT_EQ(INVALID_ELEV, averageElevationIndexSparse.getElevation(2));
+  ASSERT_EQ(5, averageElevationIndexSparse.getElevation(3));
+
+  averageElevationIndexSparse.setElevation(1, (int16_t)60);
+
+  averageElevationIndexSparse.process();
+  ASSERT_EQ(28, averageElevationIndexSparse.getElevation(1));
+}
+
+// ____________________________________________________________________________
+TEST(AverageElevationIndexSparseTest, append) {
+  AverageElevationIndexSparse averageElevationIndexSparse(5, 5);
+  averageElevationIndexSparse.setElevation(1, (int16_t)10);
+  averageElevationIndexSparse.process();
+
+  // Buffers of two threads.
+  AverageElevationIndexSparse buffer1(0, 5);
+  AverageElevationIndexSparse buffer2(0, 5);
+  buffer1.setElevation(1, (int16_t)20);
+  buffer1.setElevation(3, (int16_t)30);
+  buffer2.setElevation(3, (int16_t)40);
+  buffer2.setElevationTunnelOrBridge(4, (float)5);
+  buffer1.setElevation(4, (int16_t)50);
+
+  averageElevationIndexSparse.append(buffer1);
+  averageElevationIndexSparse.append(buffer2);
+  averageElevationIndexSparse.process();
+  ASSERT_EQ(15, averageElevationIndexSparse.getElevation(1));
+  ASSERT_EQ(INVALID_ELEV, averageElevationIndexSparse.getElevation(2));
+  ASSERT_EQ(35, averageElevationIndexSparse.getElevation(3));
+  ASSERT_EQ(5, averageElevationIndexSparse.getElevation(4));
+}
+
+// ____________________________________________________________________________
+TEST(AverageElevationIndexSparseTest, writeAndRead) {
+  AverageElevationIndexSparse averageElevationIndexSparse(5, 5);
+  averageElevationIndexSparse.setElevation(1, (int16_t)10);
+  averageElevationIndexSparse.setElevation(1, (int16_t)20);
+  averageElevationIndexSparse.setElevationTunnelOrBridge(3, (float)30);
+  averageElevationIndexSparse.process();
+  std::stringstream stream;
+  averageElevationIndexSparse.write(stream);
+
+  AverageElevationIndexSparse readIndex(0, 5);
+  ASSERT_TRUE(readIndex.read(stream));
+  ASSERT_EQ(15, readIndex.getElevation(1));
+  ASSERT_EQ(INVALID_ELEV, readIndex.getElevation(2));
+  ASSERT_EQ(30, readIndex.getElevation(3));
+
+  // The sums and counts go on, the tunnel/bridge stays locked.
+  readIndex.setElevation(1, (int16_t)45);
+  readIndex.setElevation(3, (int16_t)60);
+  readIndex.process();
+  ASSERT_EQ(25, readIndex.getElevation(1));
+  ASSERT_EQ(30, readIndex.getElevation(3));
+
+  std::stringstream truncated(stream.str().substr(0, 20));
+  ASSERT_FALSE(readIndex.read(truncated));
+  ASSERT_EQ(25, readIndex.getElevation(1));
+
+  // A corrupt size larger than the stream is not allocated.
+  std::stringstream corrupt;
+  const uint64_t size = uint64_t(1) << 60;
+  corrupt.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  ASSERT_FALSE(readIndex.read(corrupt));
+  ASSERT_EQ(25, readIndex.getElevation(1));
+}
@@ -0,0 +1,102 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include "util/index/IdBitmap.h"
+#include "util/index/AverageElevationIndexSparse.h"
+#include "correctosmelevation/osm/Checkpoint.h"
+
+using util::index::IdBitmap;
+using util::index::AverageElevationIndexSparse;
+using correctosmelevation::osm::Checkpoint;
+using correctosmelevation::osm::CorrectionStage;
+
+// ____________________________________________________________________________
+TEST(CheckpointTest, writeAndRead) {
+  const std::string file = "checkpointTest.checkpoint";
+  Checkpoint checkpoint(file, "testMap.osm", "ele", 3600);
+  ASSERT_FALSE(checkpoint.due());
+
+  IdBitmap correctedWayIds;
+  correctedWayIds.insert(7);
+  correctedWayIds.insert(100000);
+  AverageElevationIndexSparse elevationIndex(4, 10);
+  elevationIndex.setElevation(3, (int16_t)30);
+  elevationIndex.setElevation(3, (int16_t)40);
+  elevationIndex.process();
+  ASSERT_TRUE(checkpoint.write(CorrectionStage::WAYS, 42, correctedWayIds,
+                               elevationIndex));
+
+  CorrectionStage stage = CorrectionStage::RELATIONS;
+  uint64_t next = 0;
+  IdBitmap readWayIds;
+  AverageElevationIndexSparse readIndex(0, 10);
+  ASSERT_TRUE(Checkpoint(file, "testMap.osm", "ele", 0).read(
+      &stage, &next, &readWayIds, &readIndex));
+  ASSERT_EQ(CorrectionStage::WAYS, stage);
+  ASSERT_EQ((uint64_t)42, next);
+  ASSERT_EQ((uint64_t)2, readWayIds.size());
+  ASSERT_TRUE(readWayIds.contains(100000));
+  ASSERT_EQ(35, readIndex.getElevation(3));
+
+  checkpoint.remove();
+  ASSERT_FALSE(checkpoint.read(&stage, &next, &readWayIds, &readIndex));
+}
+
+// ____________________________________________________________________________
+TEST(CheckpointTest, otherInput) {
+  const std::string file = "checkpointTestOther.checkpoint";
+  Checkpoint checkpoint(file, "testMap.osm", "ele", 0);
+  ASSERT_TRUE(checkpoint.due());
+  IdBitmap correctedWayIds;
+  AverageElevationIndexSparse elevationIndex(0, 10);
+  elevationIndex.process();
+  ASSERT_TRUE(checkpoint.write(CorrectionStage::RELATIONS, 5,
+                               correctedWayIds, elevationIndex));
+
+  // Another tag or input file doesn't use the checkpoint.
+  CorrectionStage stage = CorrectionStage::WAYS;
+  uint64_t next = 0;
+  ASSERT_FALSE(Checkpoint(file, "testMap.osm", "height", 0).read(
+      &stage, &next, &correctedWayIds, &elevationIndex));
+  ASSERT_FALSE(Checkpoint(file, "doesNotExist.osm", "ele", 0).read(
+      &stage, &next, &correctedWayIds, &elevationIndex));
+  ASSERT_EQ(CorrectionStage::WAYS, stage);
+  ASSERT_EQ((uint64_t)0, next);
+
+  // A checkpoint of the input that is cut off.
+  std::ifstream in(file, std::ios::binary);
+  const std::string content((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+  std::ofstream(file, std::ios::binary) << content.substr(0,
+                                                          content.size() - 1);
+  ASSERT_THROW(checkpoint.read(&stage, &next, &correctedWayIds,
+                               &elevationIndex),
+               std::runtime_error);
+  ASSERT_EQ(CorrectionStage::WAYS, stage);
+  ASSERT_EQ((uint64_t)0, next);
+
+  // A checkpoint with a corrupt number of chunks of the way ids, which
+  // follow the magic, the key, the stage and the next range.
+  uint64_t keySize = 0;
+  content.copy(reinterpret_cast<char*>(&keySize), sizeof(keySize), 8);
+  std::string corrupt = content;
+  const uint64_t chunks = uint64_t(1) << 20;
+  corrupt.replace(8 + sizeof(keySize) + keySize + 1 + sizeof(next),
+                  sizeof(chunks), reinterpret_cast<const char*>(&chunks),
+                  sizeof(chunks));
+  std::ofstream(file, std::ios::binary) << corrupt;
+  correctedWayIds.insert(3);
+  ASSERT_THROW(checkpoint.read(&stage, &next, &correctedWayIds,
+                               &elevationIndex),
+               std::runtime_error);
+  ASSERT_EQ(CorrectionStage::WAYS, stage);
+  ASSERT_TRUE(correctedWayIds.contains(3));
+  checkpoint.remove();
+}
@@ -2,10 +2,15 @@
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
 #include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
 #include <gtest/gtest.h>
 #include "global/Constants.h"
+#include "util/metrics/Metrics.h"
 #include "correctosmelevation/osm/CorrectElevation.h"
 
+using util::metrics::Metrics;
 using global::INVALID_ELEV;
 using global::DEFAULT_ELE_TAG;
 using correctosmelevation::osm::CorrectElevation;
@@ -201,3 +206,97 @@ TEST(CORRECTELEVATIONTEST, correct) {
   ASSERT_EQ(559, correctElevation.getElevation(180));
   ASSERT_EQ(566, correctElevation.getElevation(181));
 }
+
+// ____________________________________________________________________________
+TEST(CORRECTELEVATIONTEST, correctOnThreads) {
+  CorrectElevation correctElevation("./testMap.osm", "./tmp.osm",
+                                    DEFAULT_ELE_TAG, 1000, 1000);
+  correctElevation.initialize();
+  correctElevation.correctRoutes();
+
+  CorrectElevation correctElevationThreads("./testMap.osm", "./tmp.osm",
+                                           DEFAULT_ELE_TAG, 1000, 1000, 4);
+  correctElevationThreads.initialize();
+  correctElevationThreads.correctRoutes();
+
+  // The same elevations as on a single thread.
+  for (uint64_t id = 1; id <= 181; ++id) {
+    ASSERT_EQ(correctElevation.getElevation(id),
+              correctElevationThreads.getElevation(id));
+  }
+}
+
+// ____________________________________________________________________________
+TEST(CORRECTELEVATIONTEST, correctWithMemoryLimit) {
+  Metrics::get().clear();
+  CorrectElevation correctElevation("./testMap.osm", "./tmp.osm",
+                                    DEFAULT_ELE_TAG, 1000, 1000, 1, 1024);
+  correctElevation.initialize();
+  correctElevation.correctRoutes();
+
+  std::map<std::string, std::map<std::string, uint64_t>> counters;
+  for (const auto& phase : Metrics::get().getPhases()) {
+    counters[phase.name] = phase.counters;
+  }
+  // Hardly anything fits, so the relations are read in several passes and
+  // each way is a range of its own.
+  ASSERT_LT((uint64_t)1, counters["correctRelations"]["passes"]);
+  ASSERT_GE(counters["statistics"]["routeRelations"],
+            counters["correctRelations"]["passes"]);
+  ASSERT_LT((uint64_t)0, counters["correctWays"]["routes"]);
+  ASSERT_EQ(counters["correctWays"]["routes"],
+            counters["correctWays"]["ranges"]);
+}
+
+// ____________________________________________________________________________
+TEST(CORRECTELEVATIONTEST, resume) {
+  CorrectElevation correctElevation("./testMap.osm", "./tmp.osm",
+                                    DEFAULT_ELE_TAG, 1000, 1000);
+  correctElevation.initialize();
+  correctElevation.correctRoutes();
+
+  // A run killed after the relations, with a checkpoint of them.
+  std::remove("./tmp.osm.checkpoint");
+  CorrectElevation killed("./testMap.osm", "./tmp.osm",
+                          DEFAULT_ELE_TAG, 1000, 1000);
+  killed.initialize();
+  killed.setCheckpointInterval(0);
+  ASSERT_FALSE(killed.resume());
+  const uint64_t maxRelations = 1000;
+  killed.correctRouteRelationsInRanges(maxRelations, 1000);
+
+  // The resumed run only corrects the ways.
+  Metrics::get().clear();
+  CorrectElevation resumed("./testMap.osm", "./tmp.osm",
+                           DEFAULT_ELE_TAG, 1000, 1000);
+  resumed.initialize();
+  resumed.setCheckpointInterval(0);
+  ASSERT_TRUE(resumed.resume());
+  resumed.correctRoutes();
+  std::map<std::string, std::map<std::string, uint64_t>> counters;
+  for (const auto& phase : Metrics::get().getPhases()) {
+    counters[phase.name] = phase.counters;
+  }
+  ASSERT_EQ((uint64_t)0, counters["correctRelations"]["ranges"]);
+  ASSERT_LT((uint64_t)0, counters["correctWays"]["ranges"]);
+  for (uint64_t id = 1; id <= 181; ++id) {
+    ASSERT_EQ(correctElevation.getElevation(id), resumed.getElevation(id));
+  }
+
+  // Resuming the complete run skips all ranges.
+  Metrics::get().clear();
+  CorrectElevation complete("./testMap.osm", "./tmp.osm",
+                            DEFAULT_ELE_TAG, 1000, 1000);
+  complete.initialize();
+  ASSERT_TRUE(complete.resume());
+  complete.correctRoutes();
+  counters.clear();
+  for (const auto& phase : Metrics::get().getPhases()) {
+    counters[phase.name] = phase.counters;
+  }
+  ASSERT_EQ((uint64_t)0, counters["correctWays"]["ranges"]);
+  for (uint64_t id = 1; id <= 181; ++id) {
+    ASSERT_EQ(correctElevation.getElevation(id), complete.getElevation(id));
+  }
+  std::remove("./tmp.osm.checkpoint");
+}
@@ -33,7 +33,9 @@ TEST(CORRECTRIVERTEST, oneStreamRiverNoCorrections) {
 
   AverageElevationIndexSparse elevationIndex(5, 5);
 
-  CorrectRiver correctRiver(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectRiver correctRiver(nodeIds, slots, nodeCounts, nodeIndex,
+                            elevationIndex);
 
   correctRiver.buildElevations();
   correctRiver.buildRiverNodes();
@@ -72,7 +74,9 @@ TEST(CORRECTRIVERTEST, oneStreamRiverWithCorrections) {
 
   AverageElevationIndexSparse elevationIndex(5, 5);
 
-  CorrectRiver correctRiver(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectRiver correctRiver(nodeIds, slots, nodeCounts, nodeIndex,
+                            elevationIndex);
 
   correctRiver.buildElevations();
   correctRiver.buildRiverNodes();
@@ -115,7 +119,9 @@ TEST(CORRECTRIVERTEST, twoStreamRiverNoCorrections) {
 
   AverageElevationIndexSparse elevationIndex(10, 10);
 
-  CorrectRiver correctRiver(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectRiver correctRiver(nodeIds, slots, nodeCounts, nodeIndex,
+                            elevationIndex);
 
   correctRiver.buildElevations();
   correctRiver.buildRiverNodes();
@@ -155,7 +161,9 @@ TEST(CORRECTRIVERTEST, twoStreamRiverWithCorrections) {
 
   AverageElevationIndexSparse elevationIndex(10, 10);
 
-  CorrectRiver correctRiver(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectRiver correctRiver(nodeIds, slots, nodeCounts, nodeIndex,
+                            elevationIndex);
 
   correctRiver.buildElevations();
   correctRiver.buildRiverNodes();
@@ -194,7 +202,9 @@ TEST(CORRECTRIVERTEST, oneStreamRiverWithSideStream) {
 
   AverageElevationIndexSparse elevationIndex(10, 10);
 
-  CorrectRiver correctRiver(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectRiver correctRiver(nodeIds, slots, nodeCounts, nodeIndex,
+                            elevationIndex);
 
   correctRiver.buildElevations();
   correctRiver.buildRiverNodes();
@@ -233,7 +243,9 @@ TEST(CORRECTRIVERTEST, twoStreamRiverWithConnection) {
 
   AverageElevationIndexSparse elevationIndex(10, 10);
 
-  CorrectRiver correctRiver(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectRiver correctRiver(nodeIds, slots, nodeCounts, nodeIndex,
+                            elevationIndex);
 
   correctRiver.buildElevations();
   correctRiver.buildRiverNodes();
@@ -281,7 +293,9 @@ TEST(CORRECTRIVERTEST, complexRiverwithInterconnects) {
 
   AverageElevationIndexSparse elevationIndex(16, 16);
 
-  CorrectRiver correctRiver(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectRiver correctRiver(nodeIds, slots, nodeCounts, nodeIndex,
+                            elevationIndex);
 
   correctRiver.buildElevations();
   correctRiver.buildRiverNodes();
@@ -336,7 +350,9 @@ TEST(CORRECTRIVERTEST, invalidElevation) {
 
   AverageElevationIndexSparse elevationIndex(16, 16);
 
-  CorrectRiver correctRiver(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectRiver correctRiver(nodeIds, slots, nodeCounts, nodeIndex,
+                            elevationIndex);
 
   correctRiver.buildElevations();
   correctRiver.buildRiverNodes();
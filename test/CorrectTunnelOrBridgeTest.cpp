@@ -41,7 +41,9 @@ TEST(CORRECTTUNNELORBRIDGETEST, estimateUnknownSectionFlat) {
 
   AverageElevationIndexSparse elevationIndex(11, 11);
 
-  CorrectTunnelOrBridge tunnel(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectTunnelOrBridge tunnel(nodeIds, slots, nodeCounts, nodeIndex,
+                               elevationIndex);
 
   tunnel.buildCoords();
   tunnel.buildElevations();
@@ -99,7 +101,9 @@ TEST(CORRECTTUNNELORBRIDGETEST, estimateUnknownSectionSlope) {
 
   AverageElevationIndexSparse elevationIndex(11, 11);
 
-  CorrectTunnelOrBridge tunnel(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectTunnelOrBridge tunnel(nodeIds, slots, nodeCounts, nodeIndex,
+                               elevationIndex);
 
   tunnel.buildCoords();
   tunnel.buildElevations();
@@ -157,7 +161,9 @@ TEST(CORRECTTUNNELORBRIDGETEST, estimateUnknownSectionEndpointRotated) {
 
   AverageElevationIndexSparse elevationIndex(11, 11);
 
-  CorrectTunnelOrBridge tunnel(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectTunnelOrBridge tunnel(nodeIds, slots, nodeCounts, nodeIndex,
+                               elevationIndex);
 
   tunnel.buildCoords();
   tunnel.buildElevations();
@@ -215,7 +221,9 @@ TEST(CORRECTTUNNELORBRIDGETEST, estimateUnknownSectionNonStraight) {
 
   AverageElevationIndexSparse elevationIndex(11, 11);
 
-  CorrectTunnelOrBridge tunnel(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectTunnelOrBridge tunnel(nodeIds, slots, nodeCounts, nodeIndex,
+                               elevationIndex);
 
   tunnel.buildCoords();
   tunnel.buildElevations();
@@ -273,7 +281,9 @@ TEST(CORRECTTUNNELORBRIDGETEST, estimateUnknownSectionSlopeInvalidInTunnel) {
 
   AverageElevationIndexSparse elevationIndex(11, 11);
 
-  CorrectTunnelOrBridge tunnel(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectTunnelOrBridge tunnel(nodeIds, slots, nodeCounts, nodeIndex,
+                               elevationIndex);
 
   tunnel.buildCoords();
   tunnel.buildElevations();
@@ -332,7 +342,9 @@ TEST(CORRECTTUNNELORBRIDGETEST,
 
   AverageElevationIndexSparse elevationIndex(11, 11);
 
-  CorrectTunnelOrBridge tunnel(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  CorrectTunnelOrBridge tunnel(nodeIds, slots, nodeCounts, nodeIndex,
+                               elevationIndex);
 
   tunnel.buildCoords();
   tunnel.buildElevations();
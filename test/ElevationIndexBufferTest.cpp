@@ -0,0 +1,85 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "global/Constants.h"
+#include "util/index/ElevationIndexSparse.h"
+#include "util/index/ElevationIndexDense.h"
+#include "util/index/ElevationIndexBuffer.h"
+
+using global::INVALID_ELEV;
+using util::index::ElevationIndexSparse;
+using util::index::ElevationIndexDense;
+using util::index::ElevationIndexBuffer;
+
+// ____________________________________________________________________________
+TEST(ElevationIndexBufferTest, writeOnProcessAndDestruction) {
+  ElevationIndexSparse elevationIndex(3, 3);
+  std::mutex mutex;
+  {
+    ElevationIndexBuffer buffer(elevationIndex, mutex);
+    buffer.setElevation(1, 50);
+    buffer.setElevation(2, INVALID_ELEV);
+
+    // Nothing written yet.
+    elevationIndex.process();
+    ASSERT_EQ(INVALID_ELEV, elevationIndex.getElevation(1));
+
+    buffer.process();
+    elevationIndex.process();
+    ASSERT_EQ(50, elevationIndex.getElevation(1));
+    ASSERT_EQ(INVALID_ELEV, elevationIndex.getElevation(2));
+
+    buffer.setElevation(3, -935);
+  }
+  elevationIndex.process();
+  ASSERT_EQ(50, elevationIndex.getElevation(1));
+  ASSERT_EQ(INVALID_ELEV, elevationIndex.getElevation(2));
+  ASSERT_EQ(-935, elevationIndex.getElevation(3));
+}
+
+// ____________________________________________________________________________
+TEST(ElevationIndexBufferTest, writeWhenFull) {
+  ElevationIndexSparse elevationIndex(3, 3);
+  std::mutex mutex;
+  ElevationIndexBuffer buffer(elevationIndex, mutex, 2);
+  buffer.setElevation(1, 10);
+  buffer.setElevation(2, 20);
+  buffer.setElevation(3, 30);
+
+  // The first two were written as soon as the buffer was full.
+  elevationIndex.process();
+  ASSERT_EQ(10, elevationIndex.getElevation(1));
+  ASSERT_EQ(20, elevationIndex.getElevation(2));
+  ASSERT_EQ(INVALID_ELEV, elevationIndex.getElevation(3));
+}
+
+// ____________________________________________________________________________
+TEST(ElevationIndexBufferTest, concurrentThreads) {
+  // The dense index packs the elevations of neighboring node IDs into
+  // the same bytes, so unguarded concurrent writes would corrupt it.
+  const uint64_t max = 40000;
+  ElevationIndexDense elevationIndex(max, max);
+  std::mutex mutex;
+
+  std::vector<std::thread> threads;
+  for (uint64_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      ElevationIndexBuffer buffer(elevationIndex, mutex, 1000);
+      for (uint64_t id = 1 + t; id <= max; id += 4) {
+        buffer.setElevation(id, id % 8000);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (uint64_t id = 1; id <= max; ++id) {
+    ASSERT_EQ(static_cast<int16_t>(id % 8000),
+              elevationIndex.getElevation(id));
+  }
+}
@@ -0,0 +1,155 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "global/Constants.h"
+#include "util/index/ElevationIndexSparse.h"
+#include "util/index/ElevationIndexDense.h"
+#include "sidecar/ElevationSidecar.h"
+#include "sidecar/ElevationSidecarReader.h"
+#include "sidecar/ElevationSidecarWriter.h"
+#include "sidecar/OutputFormat.h"
+
+using global::INVALID_ELEV;
+using util::index::ElevationIndexSparse;
+using util::index::ElevationIndexDense;
+using sidecar::ElevationSidecarReader;
+using sidecar::ElevationSidecarWriter;
+using sidecar::OutputFormat;
+using sidecar::encodeVarint;
+using sidecar::encodeZigzag;
+using sidecar::decodeZigzag;
+
+// ____________________________________________________________________________
+TEST(ElevationSidecarTest, varintAndZigzag) {
+  uint8_t bytes[10];
+  ASSERT_EQ(1, encodeVarint(0, bytes));
+  ASSERT_EQ(0, bytes[0]);
+  ASSERT_EQ(1, encodeVarint(127, bytes));
+  ASSERT_EQ(2, encodeVarint(128, bytes));
+  ASSERT_EQ(0x80, bytes[0]);
+  ASSERT_EQ(0x01, bytes[1]);
+  ASSERT_EQ(10, encodeVarint(UINT64_MAX, bytes));
+
+  ASSERT_EQ((uint64_t)0, encodeZigzag(0));
+  ASSERT_EQ((uint64_t)1, encodeZigzag(-1));
+  ASSERT_EQ((uint64_t)2, encodeZigzag(1));
+  for (int64_t value : { 0, 1, -1, 8848, -1000, -8848 }) {
+    ASSERT_EQ(value, decodeZigzag(encodeZigzag(value)));
+  }
+}
+
+// ____________________________________________________________________________
+TEST(ElevationSidecarTest, writeAndReadBinary) {
+  ElevationIndexSparse elevationIndex(5, 1000000000000);
+  elevationIndex.setElevation(1000000000000, 12);
+  elevationIndex.setElevation(5, -400);
+  elevationIndex.setElevation(3, INVALID_ELEV);
+  elevationIndex.setElevation(7, 8848);
+  elevationIndex.setElevation(2, 100);
+  elevationIndex.process();
+
+  const std::string file = "sidecarTest.ele";
+  ElevationSidecarWriter writer(file, &elevationIndex, OutputFormat::BINARY);
+  ASSERT_EQ((uint64_t)4, writer.write());
+
+  ElevationSidecarReader reader(file);
+  ASSERT_EQ((uint64_t)4, reader.getCount());
+  uint64_t id;
+  int16_t elevation;
+  ASSERT_TRUE(reader.next(&id, &elevation));
+  ASSERT_EQ((uint64_t)2, id);
+  ASSERT_EQ(100, elevation);
+  ASSERT_TRUE(reader.next(&id, &elevation));
+  ASSERT_EQ((uint64_t)5, id);
+  ASSERT_EQ(-400, elevation);
+  ASSERT_TRUE(reader.next(&id, &elevation));
+  ASSERT_EQ((uint64_t)7, id);
+  ASSERT_EQ(8848, elevation);
+  ASSERT_TRUE(reader.next(&id, &elevation));
+  ASSERT_EQ((uint64_t)1000000000000, id);
+  ASSERT_EQ(12, elevation);
+  ASSERT_FALSE(reader.next(&id, &elevation));
+  std::remove(file.c_str());
+}
+
+// ____________________________________________________________________________
+TEST(ElevationSidecarTest, writeAndReadBinaryDense) {
+  const uint64_t max = 100000;
+  ElevationIndexDense elevationIndex(max, max);
+  for (uint64_t id = 1; id <= max; id += 3) {
+    elevationIndex.setElevation(id, id % 9000 - 500);
+  }
+  elevationIndex.process();
+
+  const std::string file = "sidecarTestDense.ele";
+  ElevationSidecarWriter writer(file, &elevationIndex, OutputFormat::BINARY);
+  writer.write();
+
+  ElevationSidecarReader reader(file);
+  uint64_t id;
+  int16_t elevation;
+  uint64_t expectedId = 1;
+  while (reader.next(&id, &elevation)) {
+    ASSERT_EQ(expectedId, id);
+    ASSERT_EQ(static_cast<int16_t>(id % 9000 - 500), elevation);
+    expectedId += 3;
+  }
+  ASSERT_EQ(max / 3 + 1, reader.getCount());
+
+  // Small differences of ID and elevation only need a few bytes each.
+  std::ifstream in(file, std::ios::binary | std::ios::ate);
+  ASSERT_LT(static_cast<uint64_t>(in.tellg()), 16 + reader.getCount() * 4);
+  std::remove(file.c_str());
+}
+
+// ____________________________________________________________________________
+TEST(ElevationSidecarTest, writeCsv) {
+  ElevationIndexSparse elevationIndex(3, 10);
+  elevationIndex.setElevation(10, -5);
+  elevationIndex.setElevation(4, 321);
+  elevationIndex.process();
+
+  const std::string file = "sidecarTest.csv";
+  ElevationSidecarWriter writer(file, &elevationIndex, OutputFormat::CSV);
+  ASSERT_EQ((uint64_t)2, writer.write());
+
+  std::ifstream in(file);
+  std::stringstream content;
+  content << in.rdbuf();
+  ASSERT_EQ("id,elevation\n4,321\n10,-5\n", content.str());
+
+  // Not readable as binary sidecar file.
+  ASSERT_THROW(ElevationSidecarReader reader(file), std::runtime_error);
+  std::remove(file.c_str());
+}
+
+// ____________________________________________________________________________
+TEST(ElevationSidecarTest, readInvalid) {
+  ASSERT_THROW(ElevationSidecarReader reader("doesNotExist.ele"),
+               std::runtime_error);
+
+  // The header promises more nodes than there are.
+  const std::string file = "sidecarTestTruncated.ele";
+  {
+    std::ofstream out(file, std::ios::binary);
+    out.write(sidecar::SIDECAR_MAGIC, 8);
+    const char count[8] = { 2, 0, 0, 0, 0, 0, 0, 0 };
+    out.write(count, 8);
+    const char node[2] = { 1, 2 };
+    out.write(node, 2);
+  }
+  ElevationSidecarReader reader(file);
+  uint64_t id;
+  int16_t elevation;
+  ASSERT_TRUE(reader.next(&id, &elevation));
+  ASSERT_EQ((uint64_t)1, id);
+  ASSERT_EQ(1, elevation);
+  ASSERT_THROW(reader.next(&id, &elevation), std::runtime_error);
+  std::remove(file.c_str());
+}
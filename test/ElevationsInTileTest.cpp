@@ -8,9 +8,11 @@
 #include <osmium/builder/osm_object_builder.hpp>
 #include "util/index/ElevationIndexSparse.h"
 #include "osmelevation/elevation/GeoElevation.h"
+#include "osmelevation/elevation/Interpolation.h"
 #include "osmelevation/osm/OsmNodesHandler.h"
 
 using osmelevation::elevation::GeoElevation;
+using osmelevation::elevation::Interpolation;
 using osmelevation::osm::OsmNodesHandler;
 using util::index::ElevationIndexSparse;
 using GeoTile = std::tuple<int16_t, int16_t, int16_t, int16_t>;
@@ -41,7 +43,8 @@ TEST(ElevationsInTileTest, node) {
   osmium::Node& node = builder.object();
 
   for (const auto& tile : tiles) {
-    OsmNodesHandler handler(elevationIndex, geoElevation, tile);
+    OsmNodesHandler<Interpolation::IDW> handler(elevationIndex, geoElevation,
+                                                tile);
 
     setNode(node, 1, 0, 0);  // tile 1
     handler.node(node);
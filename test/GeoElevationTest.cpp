@@ -5,9 +5,14 @@
 #include "util/geo/Point.h"
 #include "global/Constants.h"
 #include "osmelevation/elevation/GeoElevation.h"
+#include "osmelevation/elevation/Interpolation.h"
 
 using osmelevation::elevation::GeoElevation;
+using osmelevation::elevation::Interpolation;
+using osmelevation::elevation::NasademFile;
 using Coordinate = util::geo::Point<double>;
+using CoordInt = util::geo::Point<int16_t>;
+using Cell = util::geo::Point<uint16_t>;
 using global::INVALID_ELEV;
 
 // The NASADEM file (n47e007) used for these tests has a sample size of 3601.
@@ -64,11 +69,33 @@ TEST(GeoElevationTest, getInterpolatedElevationTwoFiles) {
   // With accessing the right-most cell at the second row, the NASADEM file
   // N47E008 will be requested to access the second-left-most cell at the second row.
   // Since this cell is the only one with the elevation of 300 meters,
-  // the result should be more than 100 meters.
-  ASSERT_EQ(122, geoElevation.getInterpolatedElevation(Coordinate(7.99999,
+  // the result should be more than 100 meters. The diagonal cells are
+  // in N47E008 as well and have an elevation of 100 meters.
+  ASSERT_EQ(119, geoElevation.getInterpolatedElevation(Coordinate(7.99999,
                                                                   47.9996)));
 }
 
+// ____________________________________________________________________________
+TEST(GeoElevationTest, getHaloedNasademFile) {
+  GeoElevation geoElevation("./");
+
+  const NasademFile& file = geoElevation.getHaloedNasademFile(CoordInt(7, 47));
+  ASSERT_TRUE(file.isHaloed());
+
+  // The halo to the right is filled from N47E008, all other
+  // neighboring files don't exist.
+  const int16_t* cell = file.getHaloedCell(Cell(3600, 1));
+  const int32_t stride = file.getStride();
+  ASSERT_EQ(300, cell[1]);
+  ASSERT_EQ(100, cell[1 - stride]);
+  ASSERT_EQ(100, cell[1 + stride]);
+  ASSERT_EQ(INVALID_ELEV, file.getHaloedCell(Cell(0, 0))[-1]);
+  ASSERT_EQ(INVALID_ELEV, file.getHaloedCell(Cell(5, 0))[-stride]);
+
+  // The neighboring file is loaded, but not haloed itself.
+  ASSERT_FALSE(geoElevation.getNasademFile(CoordInt(8, 47)).isHaloed());
+}
+
 // ____________________________________________________________________________
 TEST(GeoElevationTest, getInterpolatedElevationInvalid) {
   GeoElevation geoElevation("./");
@@ -91,3 +118,56 @@ TEST(GeoElevationTest, getInterpolatedElevationInvalidNoElevationHole) {
   ASSERT_EQ(100,
             geoElevation.getInterpolatedElevation(Coordinate(10.5, 10.4991)));
 }
+
+// ____________________________________________________________________________
+TEST(GeoElevationTest, getBilinearElevation) {
+  GeoElevation geoElevation("./");
+
+  // Exactly on the center of the cell with 300 meters.
+  ASSERT_EQ(300, geoElevation.getBilinearElevation(Coordinate(7.5, 47.5)));
+
+  // In a region where the elevation is 100 meters everywhere.
+  ASSERT_EQ(100, geoElevation.getBilinearElevation(Coordinate(7.1243,
+                                                              47.32521)));
+
+  // Moving to the right, the elevation decreases linearly
+  // until the center of the next cell is reached.
+  ASSERT_EQ(282, geoElevation.getBilinearElevation(Coordinate(7.500025,
+                                                              47.5)));
+  ASSERT_EQ(264, geoElevation.getBilinearElevation(Coordinate(7.50005,
+                                                              47.5)));
+  ASSERT_EQ(200, geoElevation.getBilinearElevation(Coordinate(7.5 + 1.0 / 7200,
+                                                              47.5)));
+  ASSERT_EQ(100, geoElevation.getBilinearElevation(Coordinate(7.5003,
+                                                              47.5)));
+
+  // The right and bottom edge of a NASADEM file are covered
+  // by the file itself.
+  ASSERT_EQ(100, geoElevation.getBilinearElevation(Coordinate(7.99999,
+                                                              47.0)));
+}
+
+// ____________________________________________________________________________
+TEST(GeoElevationTest, getBilinearElevationInvalid) {
+  GeoElevation geoElevation("./");
+
+  ASSERT_EQ(INVALID_ELEV,
+            geoElevation.getBilinearElevation(Coordinate(500.6356, 245.2435)));
+  ASSERT_EQ(INVALID_ELEV,
+            geoElevation.getBilinearElevation(Coordinate(10.5, 10.5)));
+  ASSERT_EQ(100,
+            geoElevation.getBilinearElevation(Coordinate(10.5, 10.4991)));
+}
+
+// ____________________________________________________________________________
+TEST(GeoElevationTest, getKernelElevation) {
+  GeoElevation geoElevation("./");
+  const Coordinate coord(7.50005, 47.5);
+
+  ASSERT_EQ(geoElevation.getElevation(coord),
+            geoElevation.getKernelElevation<Interpolation::NEAREST>(coord));
+  ASSERT_EQ(geoElevation.getBilinearElevation(coord),
+            geoElevation.getKernelElevation<Interpolation::BILINEAR>(coord));
+  ASSERT_EQ(geoElevation.getInterpolatedElevation(coord),
+            geoElevation.getKernelElevation<Interpolation::IDW>(coord));
+}
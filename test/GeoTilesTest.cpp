@@ -7,7 +7,11 @@
 #include "osmelevation/osm/GeoBoundaries.h"
 
 using osmelevation::osm::GeoBoundaries;
+using osmelevation::osm::GeoBoundary;
 using util::osm::OsmStats;
+using util::osm::tileIndex;
+using util::osm::TILES_LON;
+using util::osm::TILES_LAT;
 
 // ____________________________________________________________________________
 TEST(GeoTilesTest, constructSectionsOneTile) {
@@ -127,3 +131,106 @@ TEST(GeoTilesTest, constructSectionsNoTile) {
 
   ASSERT_EQ((size_t)0, tiles.size());
 }
+
+// ____________________________________________________________________________
+TEST(GeoTilesTest, planBoundariesWithoutHistogram) {
+  OsmStats osmStats;
+  osmStats.minLon = -29;
+  osmStats.minLat = -21;
+  osmStats.maxLon = 20;
+  osmStats.maxLat = 10;
+
+  GeoBoundaries geoTiles(20, osmStats);
+  ASSERT_EQ(geoTiles.buildBoundaries(), geoTiles.planBoundaries());
+}
+
+// ____________________________________________________________________________
+TEST(GeoTilesTest, planBoundariesSkipEmptyTiles) {
+  OsmStats osmStats;
+  osmStats.minLon = -30;
+  osmStats.minLat = -20;
+  osmStats.maxLon = 30;
+  osmStats.maxLat = 20;
+  osmStats.tileNodeCounts.assign(TILES_LON * TILES_LAT, 0);
+
+  // Two islands far away from each other.
+  osmStats.tileNodeCounts[tileIndex(-25, -15)] = 100;
+  osmStats.tileNodeCounts[tileIndex(-24, -15)] = 5;
+  osmStats.tileNodeCounts[tileIndex(20, 10)] = 1;
+
+  // Both islands need 12 + 9 NASADEM files, which is more than a
+  // quadratic tile of side length 2 needs.
+  GeoBoundaries geoTiles(2, osmStats);
+  const auto tiles = geoTiles.planBoundaries();
+
+  ASSERT_EQ((size_t)2, tiles.size());
+  ASSERT_EQ(-25, std::get<0>(tiles[0]));
+  ASSERT_EQ(-15, std::get<1>(tiles[0]));
+  ASSERT_EQ(-23, std::get<2>(tiles[0]));
+  ASSERT_EQ(-14, std::get<3>(tiles[0]));
+
+  ASSERT_EQ(20, std::get<0>(tiles[1]));
+  ASSERT_EQ(10, std::get<1>(tiles[1]));
+  ASSERT_EQ(21, std::get<2>(tiles[1]));
+  ASSERT_EQ(11, std::get<3>(tiles[1]));
+
+  // With side length 3 they fit into one boundary and a single pass.
+  GeoBoundaries geoTilesLarge(3, osmStats);
+  const auto tilesLarge = geoTilesLarge.planBoundaries();
+  ASSERT_EQ((size_t)1, tilesLarge.size());
+  ASSERT_EQ(GeoBoundary(-25, -15, 21, 11), tilesLarge[0]);
+}
+
+// ____________________________________________________________________________
+TEST(GeoTilesTest, planBoundariesFitIntoMemory) {
+  OsmStats osmStats;
+  osmStats.minLon = 0;
+  osmStats.minLat = 0;
+  osmStats.maxLon = 10;
+  osmStats.maxLat = 10;
+  osmStats.tileNodeCounts.assign(TILES_LON * TILES_LAT, 0);
+  for (int16_t lon = 0; lon < 10; ++lon) {
+    for (int16_t lat = 0; lat < 10; ++lat) {
+      osmStats.tileNodeCounts[tileIndex(lon, lat)] = 1;
+    }
+  }
+
+  // Each boundary may need (2 + 2)^2 NASADEM files, so at most 2x2 tiles.
+  GeoBoundaries geoTiles(2, osmStats);
+  const auto tiles = geoTiles.planBoundaries();
+
+  ASSERT_EQ((size_t)25, tiles.size());
+  uint32_t area = 0;
+  for (const auto& [minLon, minLat, maxLon, maxLat] : tiles) {
+    ASSERT_LE((maxLon - minLon + 2) * (maxLat - minLat + 2), 16);
+    area += (maxLon - minLon) * (maxLat - minLat);
+  }
+  ASSERT_EQ((uint32_t)100, area);
+}
+
+// ____________________________________________________________________________
+TEST(GeoTilesTest, planBoundariesSparseTilesShareBoundary) {
+  OsmStats osmStats;
+  osmStats.minLon = 0;
+  osmStats.minLat = 0;
+  osmStats.maxLon = 10;
+  osmStats.maxLat = 10;
+  osmStats.tileNodeCounts.assign(TILES_LON * TILES_LAT, 0);
+
+  // The corners only need 4 * 4 NASADEM files, even though the
+  // bounding box is much larger than a quadratic tile.
+  osmStats.tileNodeCounts[tileIndex(0, 0)] = 1;
+  osmStats.tileNodeCounts[tileIndex(9, 0)] = 1;
+  osmStats.tileNodeCounts[tileIndex(0, 9)] = 1;
+  osmStats.tileNodeCounts[tileIndex(9, 9)] = 1;
+
+  GeoBoundaries geoTiles(4, osmStats);
+  const auto tiles = geoTiles.planBoundaries();
+
+  ASSERT_EQ((size_t)1, tiles.size());
+  ASSERT_EQ(GeoBoundary(0, 0, 10, 10), tiles[0]);
+
+  // With less memory, each corner gets its own boundary.
+  GeoBoundaries geoTilesSmall(1, osmStats);
+  ASSERT_EQ((size_t)4, geoTilesSmall.planBoundaries().size());
+}
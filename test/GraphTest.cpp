@@ -2,6 +2,10 @@
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
 #include "util/graph/Graph.h"
 
 using util::graph::Graph;
@@ -411,3 +415,242 @@ TEST(GraphTest, pathRiver) {
   unfinishedPath = g.getUnfinishedPath();
   ASSERT_EQ((size_t)0, unfinishedPath.size());
 }
+
+// ____________________________________________________________________________
+TEST(GraphTest, longRoute) {
+  // A long two-way route with sparse node ids and a branch at every
+  // hundredth node.
+  Graph g(100000);
+  const uint64_t length = 50000;
+  for (uint64_t i = 0; i < length; ++i) {
+    g.addEdge(1000 + i * 7, 1000 + (i + 1) * 7, 5000000 + i, true);
+    g.addEdge(1000 + (i + 1) * 7, 1000 + i * 7, 5000000 + i, true);
+    if (i % 100 == 50) {
+      g.addEdge(1000 + i * 7, 900000000 + i, 9000000 + i, false);
+    }
+  }
+  g.findStartpoints();
+  ASSERT_EQ((uint64_t)1000, g.getStartpoint());
+
+  const auto path = g.traverseGraph(1000, unfinishedPathEmpty, true, false);
+  ASSERT_EQ((size_t)length, path.size());
+  ASSERT_EQ((uint64_t)1000 + length * 7, path.back().first);
+  ASSERT_EQ((uint64_t)5000000 + length - 1, path.back().second);
+
+  // Each branch is left over as unfinished path up to the branching node.
+  auto unfinishedPath = g.getUnfinishedPath();
+  ASSERT_EQ((size_t)50, unfinishedPath.size());
+  const auto branch = g.traverseGraph(unfinishedPath.back().first,
+                                      unfinishedPath, false, false);
+  ASSERT_EQ((size_t)1, branch.size());
+  ASSERT_EQ((uint64_t)900000050, branch[0].first);
+  uint64_t branches = 1;
+  while (!(unfinishedPath = g.getUnfinishedPath()).empty()) {
+    ++branches;
+  }
+  ASSERT_EQ((uint64_t)length / 100, branches);
+}
+
+// ____________________________________________________________________________
+TEST(GraphTest, addEdgeAfterBuild) {
+  // The edges are kept in the compressed rows only once built.
+  Graph g;
+  g.addEdge(1, 2, 100, false);
+  g.addEdge(2, 3, 101, true);
+  g.addEdge(3, 2, 101, true);
+  g.findStartpoints();
+  auto graph = g.getGraph();
+  ASSERT_EQ((size_t)3, graph.size());
+  ASSERT_EQ((uint64_t)3, graph[2][0].pointsTo);
+  ASSERT_EQ((uint64_t)101, graph[3][0].edgeId);
+
+  // Adding an edge builds the graph again, with all edges.
+  g.addEdge(2, 4, 102, false);
+  graph = g.getGraph();
+  ASSERT_EQ((size_t)2, graph[2].size());
+  ASSERT_EQ((uint64_t)4, graph[2][1].pointsTo);
+  g.findStartpoints();
+  ASSERT_EQ((uint64_t)1, g.getStartpoint());
+  const auto path = g.traverseGraph(1, unfinishedPathEmpty, true, false);
+  ASSERT_EQ((size_t)2, path.size());
+  ASSERT_EQ((uint64_t)3, path[1].first);
+  std::vector<std::pair<uint64_t, uint64_t>> continued;
+  ASSERT_TRUE(g.continueUnfinishedPath(false, &continued));
+  ASSERT_EQ((uint64_t)4, continued.back().first);
+  ASSERT_TRUE(g.allEdgesUsed());
+}
+
+// ____________________________________________________________________________
+TEST(GraphTest, continueUnfinishedPath) {
+  // A two-way route with a one-way branch at each of its inner nodes.
+  Graph g(20);
+  for (uint64_t i = 1; i < 5; ++i) {
+    g.addEdge(i, i + 1, 100 + i, true);
+    g.addEdge(i + 1, i, 100 + i, true);
+  }
+  for (uint64_t i = 2; i < 5; ++i) {
+    g.addEdge(i, 10 + i, 200 + i, false);
+  }
+  g.findStartpoints();
+  ASSERT_FALSE(g.allEdgesUsed());
+  const auto path = g.traverseGraph(1, unfinishedPathEmpty, true, false);
+  ASSERT_EQ((size_t)4, path.size());
+  ASSERT_FALSE(g.allEdgesUsed());
+
+  // The unfinished path continued by the branch.
+  std::vector<std::pair<uint64_t, uint64_t>> continued;
+  for (uint64_t i = 2; i < 5; ++i) {
+    ASSERT_TRUE(g.continueUnfinishedPath(false, &continued));
+    ASSERT_EQ((size_t)i, continued.size());
+    for (uint64_t j = 0; j + 1 < i; ++j) {
+      ASSERT_EQ(path[j], continued[j]);
+    }
+    ASSERT_EQ((uint64_t)10 + i, continued.back().first);
+    ASSERT_EQ((uint64_t)200 + i, continued.back().second);
+  }
+  ASSERT_TRUE(g.allEdgesUsed());
+  ASSERT_FALSE(g.continueUnfinishedPath(false, &continued));
+  ASSERT_TRUE(continued.empty());
+}
+
+// ____________________________________________________________________________
+TEST(GraphTest, manyStartpoints) {
+  // More startpoints than the paths used to be limited to: a star of
+  // one-way edges into the center, each of them its own path.
+  Graph g(1000);
+  const uint64_t rays = 1000;
+  for (uint64_t i = 0; i < rays; ++i) {
+    g.addEdge(10 + i, 1, 100 + i, false);
+  }
+  g.findStartpoints();
+  uint64_t paths = 0;
+  for (uint64_t start = g.getStartpoint(); start != 0 && !g.allEdgesUsed();
+       start = g.getStartpoint()) {
+    const auto path = g.traverseGraph(start, unfinishedPathEmpty, true,
+                                      false);
+    ASSERT_EQ((size_t)1, path.size());
+    ++paths;
+  }
+  ASSERT_EQ(rays, paths);
+  ASSERT_TRUE(g.allEdgesUsed());
+}
+
+namespace {
+
+using Path = std::vector<std::pair<uint64_t, uint64_t>>;
+
+// A random graph of up to 13 nodes and 20 edges, some of them two-way.
+Graph randomGraph(std::mt19937_64& random) {
+  const uint64_t nodes = 2 + random() % 12;
+  const uint64_t edges = 1 + random() % 20;
+  Graph g(edges);
+  for (uint64_t i = 0; i < edges; ++i) {
+    const uint64_t v1 = 1 + random() % nodes;
+    const uint64_t v2 = 1 + random() % nodes;
+    const bool twoWay = random() % 2 == 0;
+    if (v1 == v2) { continue; }
+    g.addEdge(v1, v2, 100 + i, twoWay);
+    if (twoWay) { g.addEdge(v2, v1, 100 + i, true); }
+  }
+  return g;
+}
+
+// The paths from all startpoints, traversed like the route relations do.
+std::vector<Path> pathsFromStartpoints(Graph& g, const bool river,
+                                       const bool untilAllEdgesUsed) {
+  std::vector<Path> paths;
+  g.findStartpoints();
+  for (uint64_t start = g.getStartpoint();
+       start != 0 && !(untilAllEdgesUsed && g.allEdgesUsed());
+       start = g.getStartpoint()) {
+    const auto path = g.traverseGraph(start, unfinishedPathEmpty, true,
+                                      river);
+    if (!path.empty()) { paths.push_back(path); }
+  }
+  return paths;
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+TEST(GraphTest, continueUnfinishedPathLikeTraverseGraph) {
+  // Continuing the unfinished paths in place and stopping once all edges
+  // are used gives the same paths as copying the unfinished paths and
+  // traversing from their last node until none is left.
+  std::mt19937_64 random(49);
+  for (uint64_t i = 0; i < 20000; ++i) {
+    const uint64_t seed = random();
+    const bool river = random() % 4 == 0;
+    std::mt19937_64 graphRandom(seed);
+    Graph copied = randomGraph(graphRandom);
+    graphRandom.seed(seed);
+    Graph inPlace = randomGraph(graphRandom);
+
+    std::vector<Path> copiedPaths = pathsFromStartpoints(copied, river,
+                                                         false);
+    for (auto unfinished = copied.getUnfinishedPath(); !unfinished.empty();
+         unfinished = copied.getUnfinishedPath()) {
+      const auto rest = copied.traverseGraph(unfinished.back().first,
+                                             unfinished, false, river);
+      if (!rest.empty()) {
+        unfinished.insert(unfinished.end(), rest.begin(), rest.end());
+        copiedPaths.push_back(unfinished);
+      }
+    }
+
+    std::vector<Path> inPlacePaths = pathsFromStartpoints(inPlace, river,
+                                                          true);
+    Path path;
+    while (!inPlace.allEdgesUsed() &&
+           inPlace.continueUnfinishedPath(river, &path)) {
+      if (!path.empty()) { inPlacePaths.push_back(path); }
+    }
+    ASSERT_EQ(copiedPaths, inPlacePaths) << "graph " << i;
+  }
+}
+
+// ____________________________________________________________________________
+TEST(GraphTest, workBudget) {
+  // A one-way route with a one-way branch at each of its inner nodes,
+  // each branch continues the whole prefix of the route.
+  const uint64_t length = 1000;
+  auto build = [length](Graph* g) {
+    // The last of the unused edges is taken, so the route goes on.
+    for (uint64_t i = 1; i < length; ++i) {
+      if (i > 1) { g->addEdge(i, length + i, length + i, false); }
+      g->addEdge(i, i + 1, i, false);
+    }
+    g->findStartpoints();
+  };
+  auto paths = [](Graph* g) {
+    uint64_t count = 0;
+    for (uint64_t start = g->getStartpoint();
+         start != 0 && !g->allEdgesUsed() && g->workLeft();
+         start = g->getStartpoint()) {
+      count += !g->traverseGraph(start, unfinishedPathEmpty, true,
+                                 false).empty();
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> path;
+    while (!g->allEdgesUsed() && g->workLeft() &&
+           g->continueUnfinishedPath(false, &path)) {
+      count += !path.empty();
+    }
+    return count;
+  };
+
+  Graph unlimited;
+  build(&unlimited);
+  ASSERT_EQ(length - 1, paths(&unlimited));
+  ASSERT_TRUE(unlimited.allEdgesUsed());
+  ASSERT_TRUE(unlimited.workLeft());
+
+  // The prefixes take quadratic work, the budget stops after a few paths.
+  Graph limited;
+  limited.setWorkBudget(20 * length);
+  build(&limited);
+  const uint64_t limitedPaths = paths(&limited);
+  ASSERT_LT((uint64_t)1, limitedPaths);
+  ASSERT_GT(length / 4, limitedPaths);
+  ASSERT_FALSE(limited.allEdgesUsed());
+  ASSERT_FALSE(limited.workLeft());
+}
@@ -0,0 +1,96 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <sstream>
+#include <vector>
+#include "util/index/IdBitmap.h"
+
+using util::index::IdBitmap;
+
+// ____________________________________________________________________________
+TEST(IdBitmapTest, insertAndContains) {
+  IdBitmap ids;
+  ASSERT_TRUE(ids.empty());
+  ASSERT_FALSE(ids.contains(5));
+
+  const std::vector<uint64_t> values = { 5, 1, 65536, 65535, 1000000000 };
+  ids.insert(values.begin(), values.end());
+  ids.insert(5);
+  ASSERT_EQ((uint64_t)5, ids.size());
+  for (const auto id : values) {
+    ASSERT_TRUE(ids.contains(id));
+  }
+  ASSERT_FALSE(ids.contains(0));
+  ASSERT_FALSE(ids.contains(65537));
+  ASSERT_FALSE(ids.contains(2000000000));
+
+  // Negative ids of unsaved objects.
+  ids.insert(static_cast<uint64_t>(-3));
+  ASSERT_TRUE(ids.contains(static_cast<uint64_t>(-3)));
+  ASSERT_FALSE(ids.contains(static_cast<uint64_t>(-4)));
+  ASSERT_EQ((uint64_t)6, ids.size());
+
+  ids.clear();
+  ASSERT_TRUE(ids.empty());
+  ASSERT_FALSE(ids.contains(5));
+}
+
+// ____________________________________________________________________________
+TEST(IdBitmapTest, denseChunks) {
+  // Many ids in few chunks turn the chunks into bitsets.
+  IdBitmap ids;
+  std::set<uint64_t> expected;
+  std::mt19937_64 random(7);
+  for (size_t i = 0; i < 50000; ++i) {
+    const uint64_t id = 300000000 + random() % 200000;
+    ids.insert(id);
+    expected.insert(id);
+  }
+  ASSERT_EQ(expected.size(), ids.size());
+  for (uint64_t id = 299990000; id < 300210000; ++id) {
+    ASSERT_EQ(expected.contains(id), ids.contains(id));
+  }
+  // Far less than the about 40 bytes per id of a std::set.
+  ASSERT_LT(ids.byteSize(), ids.size() * 16);
+}
+
+// ____________________________________________________________________________
+TEST(IdBitmapTest, writeAndRead) {
+  IdBitmap ids;
+  for (uint64_t id = 0; id < 10000; id += 2) {
+    ids.insert(id);
+  }
+  ids.insert(1000000000);
+  ids.insert(static_cast<uint64_t>(-3));
+  std::stringstream stream;
+  ids.write(stream);
+
+  IdBitmap readIds;
+  readIds.insert(1);
+  ASSERT_TRUE(readIds.read(stream));
+  ASSERT_EQ(ids.size(), readIds.size());
+  for (uint64_t id = 0; id < 10001; ++id) {
+    ASSERT_EQ(ids.contains(id), readIds.contains(id));
+  }
+  ASSERT_TRUE(readIds.contains(1000000000));
+  ASSERT_TRUE(readIds.contains(static_cast<uint64_t>(-3)));
+
+  // A truncated stream leaves an empty set.
+  std::stringstream truncated(stream.str().substr(0, 100));
+  ASSERT_FALSE(readIds.read(truncated));
+  ASSERT_TRUE(readIds.empty());
+
+  // A corrupt size larger than the stream is not allocated.
+  std::stringstream corrupt;
+  const uint64_t chunks = 1;
+  const uint64_t arraySize = uint64_t(1) << 61;
+  corrupt.write(reinterpret_cast<const char*>(&chunks), sizeof(chunks));
+  corrupt.write(reinterpret_cast<const char*>(&arraySize),
+                sizeof(arraySize));
+  ASSERT_FALSE(readIds.read(corrupt));
+  ASSERT_TRUE(readIds.empty());
+}
@@ -0,0 +1,100 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "util/metrics/Metrics.h"
+
+using util::metrics::Metrics;
+using util::metrics::Phase;
+using util::metrics::fileBytes;
+using util::metrics::peakRssBytes;
+
+// ____________________________________________________________________________
+TEST(MetricsTest, phase) {
+  Metrics::get().clear();
+  {
+    Phase phase("first");
+    phase.add("nodes", 10);
+    phase.add("nodes", 5);
+    // Busy for a moment, so some CPU time is used.
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < 10000000; ++i) { sum = sum + i; }
+    ASSERT_GT(phase.end(), 0.0);
+    // Ending twice doesn't record the phase twice.
+    phase.end();
+  }
+  { Phase phase("second"); }
+
+  const auto phases = Metrics::get().getPhases();
+  ASSERT_EQ((size_t)2, phases.size());
+  ASSERT_EQ("first", phases[0].name);
+  ASSERT_EQ((uint64_t)15, phases[0].counters.at("nodes"));
+  ASSERT_GT(phases[0].wallSeconds, 0.0);
+  ASSERT_GT(phases[0].cpuSeconds, 0.0);
+  ASSERT_GT(phases[0].peakRssBytes, (uint64_t)0);
+  ASSERT_EQ("second", phases[1].name);
+  ASSERT_TRUE(phases[1].counters.empty());
+  ASSERT_GT(peakRssBytes(), (uint64_t)0);
+}
+
+// ____________________________________________________________________________
+TEST(MetricsTest, counters) {
+  Metrics::get().clear();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([] {
+      for (int i = 0; i < 1000; ++i) {
+        Metrics::get().add("loads", 1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ((uint64_t)4000, Metrics::get().getCounter("loads"));
+  ASSERT_EQ((uint64_t)0, Metrics::get().getCounter("unknown"));
+}
+
+// ____________________________________________________________________________
+TEST(MetricsTest, writeJson) {
+  Metrics::get().clear();
+  {
+    Phase phase("statistics");
+    phase.add("nodes", 179);
+    phase.add("bytesRead", 37851);
+  }
+  Metrics::get().add("nasademFilesLoaded", 2);
+  Metrics::get().addSeconds("indexSortSeconds", 0.5);
+  Metrics::get().addSeconds("indexSortSeconds", 0.25);
+
+  const std::string file = "metricsTest.json";
+  Metrics::get().writeJson(file, "osmelevation");
+  std::ifstream in(file);
+  std::stringstream content;
+  content << in.rdbuf();
+  const std::string json = content.str();
+
+  ASSERT_NE(std::string::npos, json.find("\"program\": \"osmelevation\""));
+  ASSERT_NE(std::string::npos, json.find("\"name\": \"statistics\""));
+  ASSERT_NE(std::string::npos, json.find("\"nodes\": 179,"));
+  ASSERT_NE(std::string::npos, json.find("\"nodesPerSecond\": "));
+  ASSERT_NE(std::string::npos, json.find("\"bytesRead\": 37851,"));
+  ASSERT_NE(std::string::npos, json.find("\"nasademFilesLoaded\": 2"));
+  ASSERT_NE(std::string::npos,
+            json.find("\"indexSortSeconds\": 0.750000"));
+  ASSERT_NE(std::string::npos, json.find("\"peakRssBytes\": "));
+  ASSERT_EQ('}', json[json.size() - 2]);
+
+  ASSERT_EQ(json.size(), fileBytes(file));
+  ASSERT_EQ((uint64_t)0, fileBytes("doesNotExist.json"));
+  std::remove(file.c_str());
+
+  ASSERT_THROW(Metrics::get().writeJson("doesNotExist/metrics.json", "x"),
+               std::runtime_error);
+}
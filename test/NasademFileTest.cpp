@@ -11,6 +11,7 @@ using global::INVALID_ELEV;
 using CoordInt = util::geo::Point<int16_t>;
 using Coordinate = util::geo::Point<double>;
 using Cell = util::geo::Point<uint16_t>;
+using util::geo::Point;
 
 // [0     -1  -2000, 3,     4,
 //  5,    6,  20000, 8932, -9,
@@ -195,3 +196,45 @@ TEST(NasademFileTest, getElevationFromCoord) {
 
   ASSERT_EQ(13, file.getElevationFromCoord(Coordinate(995.7, 95.5)));
 }
+
+// ____________________________________________________________________________
+TEST(NasademFileTest, copyHaloFrom) {
+  NasademFile file("./", CoordInt(995, 95));
+  NasademFile other("./", CoordInt(995, 95));
+  const int32_t stride = file.getStride();
+  ASSERT_EQ(7, stride);
+  ASSERT_FALSE(file.isHaloed());
+
+  // Before copying, the halo is invalid.
+  ASSERT_EQ(INVALID_ELEV, file.getHaloedCell(Cell(4, 2))[1]);
+
+  // The file to the right overlaps in the column 0, so the halo
+  // gets its column 1.
+  file.copyHaloFrom(other, Point<int16_t>(1, 0));
+  ASSERT_EQ(-1, file.getHaloedCell(Cell(4, 0))[1]);
+  ASSERT_EQ(6, file.getHaloedCell(Cell(4, 1))[1]);
+  ASSERT_EQ(16, file.getHaloedCell(Cell(4, 3))[1]);
+  ASSERT_EQ(INVALID_ELEV, file.getHaloedCell(Cell(4, 0))[1 - stride]);
+
+  // The file on top overlaps in the bottom row, so the halo gets
+  // the second to last row.
+  file.copyHaloFrom(other, Point<int16_t>(0, -1));
+  ASSERT_EQ(15, file.getHaloedCell(Cell(0, 0))[-stride]);
+  ASSERT_EQ(19, file.getHaloedCell(Cell(4, 0))[-stride]);
+
+  // Diagonal to the bottom left.
+  file.copyHaloFrom(other, Point<int16_t>(-1, 1));
+  ASSERT_EQ(8932, file.getHaloedCell(Cell(0, 4))[stride - 1]);
+
+  // The cells themselves are untouched.
+  ASSERT_EQ(4, file.getElevationFromCell(Cell(4, 0)));
+  ASSERT_EQ(20, file.getElevationFromCell(Cell(0, 4)));
+
+  // A file without data leaves the halo invalid.
+  NasademFile invalid("./", CoordInt(1, 2));
+  file.copyHaloFrom(invalid, Point<int16_t>(-1, 0));
+  ASSERT_EQ(INVALID_ELEV, file.getHaloedCell(Cell(0, 2))[-1]);
+
+  file.setHaloed();
+  ASSERT_TRUE(file.isHaloed());
+}
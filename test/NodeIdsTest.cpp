@@ -0,0 +1,116 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "global/Constants.h"
+#include "util/index/NodeIds.h"
+#include "util/index/NodeIndex.h"
+
+using util::index::NodeIds;
+using util::index::NodeIndex;
+using util::index::Slot;
+using util::index::SlotPaths;
+using util::index::sortUnique;
+
+// ____________________________________________________________________________
+TEST(NodeIdsTest, sortUnique) {
+  NodeIds empty;
+  sortUnique(empty);
+  ASSERT_TRUE(empty.empty());
+
+  NodeIds ids = { 7, 3, 3, 1, 256, 7, 65536, 2, 1 };
+  sortUnique(ids);
+  ASSERT_EQ(NodeIds({ 1, 2, 3, 7, 256, 65536 }), ids);
+
+  // Same result as a comparison sort on many large ids.
+  std::mt19937_64 random(42);
+  ids.clear();
+  for (size_t i = 0; i < 100000; ++i) {
+    ids.push_back(random() % 10000000000);
+  }
+  ids.push_back(UINT64_MAX);
+  NodeIds expected = ids;
+  std::sort(expected.begin(), expected.end());
+  expected.erase(std::unique(expected.begin(), expected.end()),
+                 expected.end());
+  sortUnique(ids);
+  ASSERT_EQ(expected, ids);
+}
+
+// ____________________________________________________________________________
+TEST(NodeIdsTest, subset) {
+  NodeIndex nodeIndex(5);
+  for (const uint64_t id : { 9, 3, 7, 1, 5 }) {
+    nodeIndex.setNode(id, id, id, id);
+  }
+  nodeIndex.sort();
+
+  const NodeIndex subset = nodeIndex.subset({ 0, 1, 2, 7, 9, 11 });
+  ASSERT_EQ((size_t)3, subset.size());
+  ASSERT_EQ(1, subset.getNode(1).elevation);
+  ASSERT_EQ(7, subset.getNode(7).elevation);
+  ASSERT_EQ(9.0, subset.getNode(9).lon);
+}
+
+// ____________________________________________________________________________
+TEST(NodeIdsTest, resolve) {
+  NodeIndex nodeIndex(4);
+  for (const uint64_t id : { 9, 3, 7, 1 }) {
+    nodeIndex.setNode(id, id, id + 40, id);
+  }
+  nodeIndex.sort();
+
+  const auto slots = nodeIndex.resolve(
+      std::vector<std::vector<std::vector<uint64_t>>>{
+        { { 7, 1 }, { 1, 9 } }, { { 4, 3, 9 } } });
+  ASSERT_EQ((size_t)2, slots.size());
+  ASSERT_EQ(SlotPaths({ { 2, 0 }, { 0, 3 } }), slots[0]);
+  ASSERT_EQ(3.0, nodeIndex.lon(slots[1][0][1]));
+  ASSERT_EQ(49.0, nodeIndex.lat(slots[1][0][2]));
+
+  // A missing id is resolved to a node without elevation, which is
+  // never updated.
+  const Slot missing = slots[1][0][0];
+  ASSERT_EQ(global::INVALID_ELEV, nodeIndex.elevation(missing));
+  nodeIndex.setElevation(missing, 12);
+  ASSERT_EQ(global::INVALID_ELEV, nodeIndex.elevation(missing));
+  nodeIndex.setElevation(slots[0][0][0], 12);
+  ASSERT_EQ(12, nodeIndex.getNode(7).elevation);
+
+  // The missing node is only added once.
+  const auto single = nodeIndex.resolve(
+      std::vector<std::vector<uint64_t>>{ { 2, 9 } });
+  ASSERT_EQ(missing, single[0][0]);
+  ASSERT_EQ((Slot)3, single[0][1]);
+}
+
+// ____________________________________________________________________________
+TEST(NodeIdsTest, unsortedIndex) {
+  NodeIndex nodeIndex(6);
+  nodeIndex.setNode(8, 7.4474468, 46.9479739, 540);
+  nodeIndex.setNode(2, -0.1, -51.5, 11);
+  nodeIndex.setNode(5, 180, -90, 3);
+  nodeIndex.setNode(2, 1, 1, 12);
+  nodeIndex.setNode(1, 0, 0, 1);
+  nodeIndex.setNode(8, 1, 1, 2);
+  nodeIndex.sort();
+
+  // Duplicates keep the node added first.
+  ASSERT_EQ((size_t)4, nodeIndex.size());
+  ASSERT_EQ(11, nodeIndex.getNode(2).elevation);
+  ASSERT_EQ(540, nodeIndex.getNode(8).elevation);
+
+  // Coordinates keep the precision of osmium.
+  ASSERT_NEAR(7.4474468, nodeIndex.getNode(8).lon, 1e-9);
+  ASSERT_NEAR(46.9479739, nodeIndex.getNode(8).lat, 1e-9);
+  ASSERT_NEAR(-51.5, nodeIndex.getNode(2).lat, 1e-9);
+  ASSERT_EQ(180.0, nodeIndex.getNode(5).lon);
+  ASSERT_EQ(-90.0, nodeIndex.getNode(5).lat);
+
+  // 18 bytes per reserved node.
+  ASSERT_EQ((uint64_t)6 * 18, nodeIndex.byteSize());
+}
@@ -0,0 +1,111 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include "global/Constants.h"
+#include "util/index/NodeIds.h"
+#include "util/index/NodeIndex.h"
+#include "util/index/NodeStore.h"
+
+using global::INVALID_ELEV;
+using util::index::NodeIds;
+using util::index::NodeIndex;
+using util::index::NodeStore;
+
+// ____________________________________________________________________________
+TEST(NodeStoreTest, sparse) {
+  NodeStore store("nodeStoreTestSparse.nodes");
+  // The file is removed right away.
+  ASSERT_FALSE(std::filesystem::exists("nodeStoreTestSparse.nodes"));
+  store.append(3, 74474468, 469479739, 540);
+  store.append(1000000, -1000000, -515000000, INVALID_ELEV);
+  store.append(5000000000, 1800000000, -900000000, 12);
+  store.finish();
+  ASSERT_TRUE(store.valid());
+  ASSERT_FALSE(store.dense());
+  ASSERT_EQ((uint64_t)3, store.size());
+
+  const NodeIndex nodeIndex = store.nodeIndex({ 1, 3, 999999, 5000000000,
+                                                5000000001 });
+  ASSERT_EQ((size_t)2, nodeIndex.size());
+  ASSERT_EQ(540, nodeIndex.getNode(3).elevation);
+  ASSERT_NEAR(7.4474468, nodeIndex.getNode(3).lon, 1e-9);
+  ASSERT_NEAR(46.9479739, nodeIndex.getNode(3).lat, 1e-9);
+  ASSERT_EQ(180.0, nodeIndex.getNode(5000000000).lon);
+  ASSERT_EQ(12, nodeIndex.getNode(5000000000).elevation);
+
+  ASSERT_EQ(INVALID_ELEV, store.nodeIndex({ 1000000 }).getNode(1000000)
+                                                     .elevation);
+  ASSERT_EQ((size_t)0, store.nodeIndex({}).size());
+}
+
+// ____________________________________________________________________________
+TEST(NodeStoreTest, dense) {
+  // More nodes than fit into the file at first, with few gaps.
+  NodeStore store("nodeStoreTestDense.nodes");
+  for (uint64_t id = 10; id < 200000; ++id) {
+    if (id % 7 != 0) {
+      store.append(id, id, -static_cast<int32_t>(id), id % 1000);
+    }
+  }
+  store.finish();
+  ASSERT_TRUE(store.valid());
+  ASSERT_TRUE(store.dense());
+  ASSERT_LT(store.byteSize(), store.size() * 18);
+
+  NodeIds ids;
+  for (uint64_t id = 0; id < 210000; id += 3) {
+    ids.push_back(id);
+  }
+  const NodeIndex nodeIndex = store.nodeIndex(ids);
+  uint64_t count = 0;
+  for (const auto id : ids) {
+    if (id >= 10 && id < 200000 && id % 7 != 0) {
+      ++count;
+      ASSERT_EQ(static_cast<int16_t>(id % 1000),
+                nodeIndex.getNode(id).elevation);
+      ASSERT_NEAR(id / 1e7, nodeIndex.getNode(id).lon, 1e-9);
+      ASSERT_NEAR(-(id / 1e7), nodeIndex.getNode(id).lat, 1e-9);
+    }
+  }
+  ASSERT_EQ(count, nodeIndex.size());
+}
+
+// ____________________________________________________________________________
+TEST(NodeStoreTest, sparseGallop) {
+  // Every 100th node of many, looked up sparsely and densely.
+  NodeStore store("nodeStoreTestGallop.nodes");
+  for (uint64_t id = 1; id <= 100000; ++id) {
+    store.append(id * 100, 0, 0, id % 100);
+  }
+  store.finish();
+  ASSERT_FALSE(store.dense());
+
+  const NodeIndex few = store.nodeIndex({ 100, 150, 5000000, 9999900 });
+  ASSERT_EQ((size_t)3, few.size());
+  ASSERT_EQ(0, few.getNode(5000000).elevation);
+
+  NodeIds ids;
+  for (uint64_t id = 50; id <= 10000000; id += 50) {
+    ids.push_back(id);
+  }
+  ASSERT_EQ((size_t)100000, store.nodeIndex(ids).size());
+}
+
+// ____________________________________________________________________________
+TEST(NodeStoreTest, unsorted) {
+  NodeStore store("nodeStoreTestUnsorted.nodes");
+  store.append(5, 0, 0, 1);
+  store.append(3, 0, 0, 1);
+  store.append(7, 0, 0, 1);
+  store.finish();
+  ASSERT_FALSE(store.valid());
+  ASSERT_EQ((size_t)0, store.nodeIndex({ 5 }).size());
+
+  NodeStore empty("nodeStoreTestEmpty.nodes");
+  empty.finish();
+  ASSERT_TRUE(empty.valid());
+  ASSERT_EQ((size_t)0, empty.nodeIndex({ 5 }).size());
+}
@@ -0,0 +1,98 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <osmium/io/any_input.hpp>
+#include <osmium/osm/node.hpp>
+#include "global/Constants.h"
+#include "util/index/ElevationIndexSparse.h"
+#include "writer/OsmChangeElevationWriter.h"
+
+using global::INVALID_ELEV;
+using util::index::ElevationIndexSparse;
+using writer::OsmChangeElevationWriter;
+
+struct ChangedNode {
+  uint64_t id;
+  uint32_t version;
+  std::string elevation;
+};
+
+// ____________________________________________________________________________
+std::vector<ChangedNode> readChangedNodes(const std::string& file) {
+  std::vector<ChangedNode> nodes;
+  osmium::io::Reader reader{file};
+  while (osmium::memory::Buffer buffer = reader.read()) {
+    for (const auto& node : buffer.select<osmium::Node>()) {
+      nodes.push_back({ node.positive_id(), node.version(),
+                        node.tags().get_value_by_key("ele", "") });
+    }
+  }
+  reader.close();
+  return nodes;
+}
+
+// ____________________________________________________________________________
+TEST(OsmChangeElevationWriterTest, changeFormat) {
+  ASSERT_EQ("osc", OsmChangeElevationWriter::changeFormat("out.osc"));
+  ASSERT_EQ("osc.gz", OsmChangeElevationWriter::changeFormat("out.osc.gz"));
+  ASSERT_EQ("osc.bz2", OsmChangeElevationWriter::changeFormat("out.osc.bz2"));
+  ASSERT_EQ("osc.gz", OsmChangeElevationWriter::changeFormat("out"));
+  ASSERT_EQ("osc.gz", OsmChangeElevationWriter::changeFormat("out.osm"));
+}
+
+// ____________________________________________________________________________
+TEST(OsmChangeElevationWriterTest, onlyAddedElevations) {
+  // Node 1 already has an elevation tag, nodes 121, 122 and 149 don't.
+  ElevationIndexSparse elevationIndex(4, 149);
+  elevationIndex.setElevation(1, 105);
+  elevationIndex.setElevation(121, 250);
+  elevationIndex.setElevation(122, INVALID_ELEV);
+  elevationIndex.setElevation(149, -3);
+  elevationIndex.process();
+
+  const std::string inFile = "testMap.osm";
+  const std::string outFile = "testMapAdded.osc";
+  const std::string tag = "ele";
+  OsmChangeElevationWriter writer(inFile, outFile, &elevationIndex, tag,
+                                  false);
+  ASSERT_EQ((uint64_t)2, writer.write());
+
+  const auto nodes = readChangedNodes(outFile);
+  ASSERT_EQ((size_t)2, nodes.size());
+  ASSERT_EQ((uint64_t)121, nodes[0].id);
+  ASSERT_EQ((uint32_t)2, nodes[0].version);
+  ASSERT_EQ("250", nodes[0].elevation);
+  ASSERT_EQ((uint64_t)149, nodes[1].id);
+  ASSERT_EQ((uint32_t)2, nodes[1].version);
+  ASSERT_EQ("-3", nodes[1].elevation);
+  std::remove(outFile.c_str());
+}
+
+// ____________________________________________________________________________
+TEST(OsmChangeElevationWriterTest, onlyUpdatedElevations) {
+  // Node 1 has the elevation tag 100 and node 2 the tag 101.
+  ElevationIndexSparse elevationIndex(3, 121);
+  elevationIndex.setElevation(1, 105);
+  elevationIndex.setElevation(2, 101);
+  elevationIndex.setElevation(121, 250);
+  elevationIndex.process();
+
+  const std::string inFile = "testMap.osm";
+  const std::string outFile = "testMapUpdated.osc";
+  const std::string tag = "ele";
+  OsmChangeElevationWriter writer(inFile, outFile, &elevationIndex, tag,
+                                  true);
+  ASSERT_EQ((uint64_t)2, writer.write());
+
+  const auto nodes = readChangedNodes(outFile);
+  ASSERT_EQ((size_t)2, nodes.size());
+  ASSERT_EQ((uint64_t)1, nodes[0].id);
+  ASSERT_EQ("105", nodes[0].elevation);
+  ASSERT_EQ((uint64_t)121, nodes[1].id);
+  ASSERT_EQ("250", nodes[1].elevation);
+  std::remove(outFile.c_str());
+}
@@ -0,0 +1,58 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "util/thread/ParallelFor.h"
+
+using util::thread::parallelFor;
+
+// ____________________________________________________________________________
+TEST(ParallelForTest, eachItemOnce) {
+  for (const uint16_t threads : { 1, 2, 7 }) {
+    std::vector<std::atomic<uint32_t>> visits(1000);
+    std::vector<std::atomic<uint32_t>> perThread(threads);
+    parallelFor(visits.size(), threads, [&](uint64_t i, uint16_t thread) {
+      ASSERT_LT(thread, threads);
+      ++visits[i];
+      ++perThread[thread];
+    });
+    for (const auto& count : visits) {
+      ASSERT_EQ((uint32_t)1, count);
+    }
+    uint32_t total = 0;
+    for (const auto& count : perThread) {
+      total += count;
+    }
+    ASSERT_EQ((uint32_t)1000, total);
+  }
+
+  // No items, no work.
+  parallelFor(0, 4, [](uint64_t, uint16_t) { FAIL(); });
+}
+
+// ____________________________________________________________________________
+TEST(ParallelForTest, singleThreadInOrder) {
+  std::vector<uint64_t> order;
+  parallelFor(5, 1, [&](uint64_t i, uint16_t thread) {
+    ASSERT_EQ(0, thread);
+    order.push_back(i);
+  });
+  ASSERT_EQ(std::vector<uint64_t>({ 0, 1, 2, 3, 4 }), order);
+}
+
+// ____________________________________________________________________________
+TEST(ParallelForTest, rethrow) {
+  std::atomic<uint32_t> started = 0;
+  ASSERT_THROW(parallelFor(100000, 4, [&](uint64_t i, uint16_t) {
+    ++started;
+    if (i == 10) {
+      throw std::runtime_error("failed");
+    }
+  }), std::runtime_error);
+  // Not all work was started after the failure.
+  ASSERT_LT(started, (uint32_t)100000);
+}
@@ -0,0 +1,118 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "osmelevation/elevation/Interpolation.h"
+#include "osmelevation/osm/PartitionScheduler.h"
+#include "util/index/ElevationIndexSparse.h"
+#include "util/osm/OsmStats.h"
+
+using osmelevation::elevation::Interpolation;
+using osmelevation::osm::PartitionScheduler;
+using util::index::ElevationIndexSparse;
+using util::osm::OsmStats;
+
+// Keeps track of the footprints of the work running at the same time.
+struct Tracker {
+  std::mutex mutex;
+  uint32_t inMemory = 0;
+  uint32_t maxInMemory = 0;
+  uint16_t running = 0;
+  uint16_t maxRunning = 0;
+  std::vector<size_t> started;
+
+  void start(const size_t i, const uint32_t footprint) {
+    std::lock_guard<std::mutex> lock(mutex);
+    inMemory += footprint;
+    ++running;
+    maxInMemory = std::max(maxInMemory, inMemory);
+    maxRunning = std::max(maxRunning, running);
+    started.push_back(i);
+  }
+
+  void end(const uint32_t footprint) {
+    std::lock_guard<std::mutex> lock(mutex);
+    inMemory -= footprint;
+    --running;
+  }
+};
+
+// ____________________________________________________________________________
+TEST(PartitionSchedulerTest, scheduleWithinMemory) {
+  ElevationIndexSparse elevationIndex(1, 1);
+  OsmStats osmStats;
+  const std::string file;
+  PartitionScheduler scheduler(elevationIndex, osmStats, file, file,
+                               Interpolation::IDW, 10, 4);
+
+  const std::vector<uint32_t> footprints = { 4, 4, 4, 2, 6, 10, 1, 1, 3 };
+  Tracker tracker;
+  std::atomic<uint32_t> done = 0;
+  scheduler.schedule(footprints, [&](size_t i) {
+    tracker.start(i, footprints[i]);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    tracker.end(footprints[i]);
+    ++done;
+  });
+
+  ASSERT_EQ(footprints.size(), done);
+  ASSERT_LE(tracker.maxInMemory, (uint32_t)10);
+  ASSERT_LE(tracker.maxRunning, 4);
+  // Some of the work did run at the same time.
+  ASSERT_GT(tracker.maxRunning, 1);
+  // Each work was started exactly once.
+  std::sort(tracker.started.begin(), tracker.started.end());
+  for (size_t i = 0; i < footprints.size(); ++i) {
+    ASSERT_EQ(i, tracker.started[i]);
+  }
+}
+
+// ____________________________________________________________________________
+TEST(PartitionSchedulerTest, scheduleTooLarge) {
+  ElevationIndexSparse elevationIndex(1, 1);
+  OsmStats osmStats;
+  const std::string file;
+  PartitionScheduler scheduler(elevationIndex, osmStats, file, file,
+                               Interpolation::IDW, 5, 3);
+
+  // A footprint larger than the memory still runs, but alone.
+  const std::vector<uint32_t> footprints = { 1, 8, 1, 1 };
+  Tracker tracker;
+  scheduler.schedule(footprints, [&](size_t i) {
+    tracker.start(i, footprints[i]);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    tracker.end(footprints[i]);
+  });
+
+  ASSERT_EQ((size_t)4, tracker.started.size());
+  ASSERT_EQ((uint32_t)8, tracker.maxInMemory);
+}
+
+// ____________________________________________________________________________
+TEST(PartitionSchedulerTest, scheduleRethrows) {
+  ElevationIndexSparse elevationIndex(1, 1);
+  OsmStats osmStats;
+  const std::string file;
+  PartitionScheduler scheduler(elevationIndex, osmStats, file, file,
+                               Interpolation::IDW, 1, 2);
+
+  const std::vector<uint32_t> footprints = { 1, 1, 1, 1 };
+  std::atomic<uint32_t> done = 0;
+  ASSERT_THROW(scheduler.schedule(footprints, [&](size_t i) {
+    if (i == 1) {
+      throw std::runtime_error("Partition failed.");
+    }
+    ++done;
+  }), std::runtime_error);
+  // Only one footprint fits at a time, so nothing after the failed
+  // one is started.
+  ASSERT_EQ((uint32_t)1, done);
+}
@@ -0,0 +1,235 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <osmium/osm/entity_bits.hpp>
+#include "parser/PbfBlockIndex.h"
+#include "parser/PbfBlockInput.h"
+
+using parser::PbfBlockIndex;
+using parser::PbfBlockInput;
+using parser::PBF_SORTED_FEATURE;
+
+// ____________________________________________________________________________
+std::string varint(uint64_t value) {
+  std::string bytes;
+  while (value >= 0x80) {
+    bytes += static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  bytes += static_cast<char>(value);
+  return bytes;
+}
+
+// ____________________________________________________________________________
+std::string bytesField(const uint32_t field, const std::string& value) {
+  return varint(field << 3 | 2) + varint(value.size()) + value;
+}
+
+// ____________________________________________________________________________
+std::string varintField(const uint32_t field, const uint64_t value) {
+  return varint(field << 3) + varint(value);
+}
+
+// ____________________________________________________________________________
+std::string blob(const std::string& type, const std::string& content) {
+  // Compress the content with zlib.
+  std::string compressed(compressBound(content.size()), '\0');
+  uLongf size = compressed.size();
+  compress(reinterpret_cast<Bytef*>(compressed.data()), &size,
+           reinterpret_cast<const Bytef*>(content.data()), content.size());
+  compressed.resize(size);
+  const std::string data = varintField(2, content.size()) +
+                           bytesField(3, compressed);
+  const std::string header = bytesField(1, type) +
+                             varintField(3, data.size());
+  std::string bytes(4, '\0');
+  bytes[2] = static_cast<char>(header.size() >> 8);
+  bytes[3] = static_cast<char>(header.size() & 0xff);
+  return bytes + header + data;
+}
+
+// ____________________________________________________________________________
+std::string headerBlob(const bool sorted) {
+  std::string headerBlock = bytesField(4, "OsmSchema-V0.6") +
+                            bytesField(4, "DenseNodes");
+  if (sorted) {
+    headerBlock += bytesField(5, PBF_SORTED_FEATURE);
+  }
+  return blob("OSMHeader", headerBlock);
+}
+
+// ____________________________________________________________________________
+std::string dataBlob(const std::vector<uint32_t>& groupFields) {
+  // A string table followed by primitive groups with one entity each.
+  std::string primitiveBlock = bytesField(1, bytesField(1, ""));
+  for (const auto groupField : groupFields) {
+    primitiveBlock += bytesField(2, bytesField(groupField,
+                                               varintField(1, 42)));
+  }
+  return blob("OSMData", primitiveBlock);
+}
+
+// ____________________________________________________________________________
+std::string dataBlob(const uint32_t groupField) {
+  return dataBlob(std::vector<uint32_t>{ groupField });
+}
+
+// ____________________________________________________________________________
+void writeFile(const std::string& file, const std::vector<std::string>& blobs,
+               std::vector<uint64_t>* offsets) {
+  std::ofstream out(file, std::ios::binary);
+  uint64_t offset = 0;
+  for (const auto& blob : blobs) {
+    offsets->push_back(offset);
+    out << blob;
+    offset += blob.size();
+  }
+  offsets->push_back(offset);
+}
+
+// ____________________________________________________________________________
+std::string readFile(const std::string& file) {
+  std::ifstream in(file, std::ios::binary);
+  std::stringstream content;
+  content << in.rdbuf();
+  return content.str();
+}
+
+// ____________________________________________________________________________
+TEST(PbfBlockIndexTest, sortedFile) {
+  // Dense nodes, nodes, ways and relations in blocks 1 to 7.
+  const std::string file = "pbfBlockIndexTest.osm.pbf";
+  std::vector<uint64_t> offsets;
+  writeFile(file, { headerBlob(true), dataBlob(2), dataBlob(2), dataBlob(1),
+                    dataBlob(3), dataBlob(3), dataBlob(3), dataBlob(4) },
+            &offsets);
+
+  PbfBlockIndex index(file);
+  ASSERT_TRUE(index.valid());
+  ASSERT_EQ((size_t)7, index.blockCount());
+  ASSERT_EQ(offsets[1], index.headerSize());
+
+  auto range = index.range(osmium::osm_entity_bits::node);
+  ASSERT_EQ(offsets[1], range.first);
+  ASSERT_EQ(offsets[4], range.second);
+  range = index.range(osmium::osm_entity_bits::way);
+  ASSERT_EQ(offsets[4], range.first);
+  ASSERT_EQ(offsets[7], range.second);
+  range = index.range(osmium::osm_entity_bits::relation);
+  ASSERT_EQ(offsets[7], range.first);
+  ASSERT_EQ(offsets[8], range.second);
+  range = index.range(osmium::osm_entity_bits::way |
+                      osmium::osm_entity_bits::relation);
+  ASSERT_EQ(offsets[4], range.first);
+  ASSERT_EQ(offsets[8], range.second);
+  range = index.range(osmium::osm_entity_bits::nwr);
+  ASSERT_EQ(offsets[1], range.first);
+  ASSERT_EQ(offsets[8], range.second);
+  std::remove(file.c_str());
+}
+
+// ____________________________________________________________________________
+TEST(PbfBlockIndexTest, missingTypes) {
+  // No ways at all.
+  const std::string file = "pbfBlockIndexTestNoWays.osm.pbf";
+  std::vector<uint64_t> offsets;
+  writeFile(file, { headerBlob(true), dataBlob(2), dataBlob(4) }, &offsets);
+
+  PbfBlockIndex index(file);
+  ASSERT_TRUE(index.valid());
+  auto range = index.range(osmium::osm_entity_bits::way);
+  ASSERT_EQ(range.first, range.second);
+  range = index.range(osmium::osm_entity_bits::relation);
+  ASSERT_EQ(offsets[2], range.first);
+  ASSERT_EQ(offsets[3], range.second);
+  std::remove(file.c_str());
+}
+
+// ____________________________________________________________________________
+TEST(PbfBlockIndexTest, mixedBlocks) {
+  // Blocks with nodes and ways, ways and relations, and without entities.
+  const std::string file = "pbfBlockIndexTestMixed.osm.pbf";
+  std::vector<uint64_t> offsets;
+  const std::string empty = dataBlob(std::vector<uint32_t>());
+  writeFile(file, { headerBlob(true), empty, dataBlob(2),
+                    dataBlob({ 2, 3 }), dataBlob(3), empty, dataBlob(3),
+                    dataBlob({ 3, 4 }), dataBlob(4), empty },
+            &offsets);
+
+  PbfBlockIndex index(file);
+  ASSERT_TRUE(index.valid());
+  ASSERT_EQ((size_t)9, index.blockCount());
+  auto range = index.range(osmium::osm_entity_bits::node);
+  ASSERT_EQ(offsets[1], range.first);
+  ASSERT_EQ(offsets[4], range.second);
+  range = index.range(osmium::osm_entity_bits::way);
+  ASSERT_EQ(offsets[3], range.first);
+  ASSERT_EQ(offsets[8], range.second);
+  range = index.range(osmium::osm_entity_bits::relation);
+  ASSERT_EQ(offsets[7], range.first);
+  ASSERT_EQ(offsets[10], range.second);
+  std::remove(file.c_str());
+}
+
+// ____________________________________________________________________________
+TEST(PbfBlockIndexTest, invalidFiles) {
+  // Without the sorted feature, types might be mixed.
+  const std::string file = "pbfBlockIndexTestUnsorted.osm.pbf";
+  std::vector<uint64_t> offsets;
+  writeFile(file, { headerBlob(false), dataBlob(3), dataBlob(2) }, &offsets);
+  ASSERT_FALSE(PbfBlockIndex(file).valid());
+  std::remove(file.c_str());
+
+  // Incomplete last block.
+  const std::string truncated = "pbfBlockIndexTestTruncated.osm.pbf";
+  const std::string data = headerBlob(true) + dataBlob(2);
+  std::ofstream(truncated, std::ios::binary) << data.substr(0, data.size() - 1);
+  ASSERT_FALSE(PbfBlockIndex(truncated).valid());
+  std::remove(truncated.c_str());
+
+  ASSERT_FALSE(PbfBlockIndex("testMap.osm").valid());
+  ASSERT_FALSE(PbfBlockIndex("doesNotExist.osm.pbf").valid());
+}
+
+// ____________________________________________________________________________
+TEST(PbfBlockIndexTest, blockInput) {
+  const std::string file = "pbfBlockInputTest.osm.pbf";
+  std::vector<uint64_t> offsets;
+  const std::vector<std::string> blobs = { headerBlob(true), dataBlob(2),
+                                           dataBlob(3), dataBlob(4) };
+  writeFile(file, blobs, &offsets);
+
+  {
+    PbfBlockInput input(file, osmium::osm_entity_bits::way);
+    ASSERT_TRUE(input.skipsBlocks());
+    ASSERT_EQ(blobs[0] + blobs[2], readFile(input.file().filename()));
+  }
+  {
+    PbfBlockInput input(file, osmium::osm_entity_bits::relation);
+    ASSERT_TRUE(input.skipsBlocks());
+    ASSERT_EQ(blobs[0] + blobs[3], readFile(input.file().filename()));
+  }
+  {
+    // The reader stops before reading all blocks.
+    PbfBlockInput input(file, osmium::osm_entity_bits::node);
+    ASSERT_TRUE(input.skipsBlocks());
+  }
+  {
+    PbfBlockInput input(file, osmium::osm_entity_bits::nwr);
+    ASSERT_FALSE(input.skipsBlocks());
+    ASSERT_EQ(file, input.file().filename());
+  }
+  {
+    PbfBlockInput input("testMap.osm", osmium::osm_entity_bits::way);
+    ASSERT_FALSE(input.skipsBlocks());
+  }
+  std::remove(file.c_str());
+}
@@ -0,0 +1,60 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include "correctosmelevation/osm/RangePlanner.h"
+
+using correctosmelevation::osm::RangePlanner;
+
+// ____________________________________________________________________________
+TEST(RangePlannerTest, rangeEnd) {
+  RangePlanner planner(100, 10);
+  const std::vector<uint32_t> units = { 2, 3, 4, 20, 1, 1, 0, 5 };
+
+  // 2 + 3 + 4 units fit, 20 more do not.
+  ASSERT_EQ((uint64_t)3, planner.rangeEnd(units, 0, 100));
+  ASSERT_EQ((uint64_t)3, planner.rangeEnd(units, 2, 100));
+  // A route that doesn't fit gets its own range.
+  ASSERT_EQ((uint64_t)4, planner.rangeEnd(units, 3, 100));
+  ASSERT_EQ((uint64_t)8, planner.rangeEnd(units, 4, 100));
+  ASSERT_EQ((uint64_t)6, planner.rangeEnd(units, 4, 2));
+  ASSERT_EQ((uint64_t)8, planner.rangeEnd(units, 8, 100));
+
+  // Without a limit, all routes fit.
+  RangePlanner unlimited(UINT64_MAX, 10);
+  ASSERT_EQ((uint64_t)8, unlimited.rangeEnd(units, 0, UINT64_MAX));
+}
+
+// ____________________________________________________________________________
+TEST(RangePlannerTest, rangeSize) {
+  RangePlanner planner(1000, 10);
+  ASSERT_EQ((uint64_t)20, planner.rangeSize(5, 100));
+  ASSERT_EQ((uint64_t)8, planner.rangeSize(5, 8));
+  ASSERT_EQ((uint64_t)1, planner.rangeSize(500, 100));
+
+  RangePlanner unlimited(UINT64_MAX, 10);
+  ASSERT_EQ((uint64_t)1000, unlimited.rangeSize(5, 1000));
+  ASSERT_LT((uint64_t)1000000000000, unlimited.rangeSize(5, UINT64_MAX));
+}
+
+// ____________________________________________________________________________
+TEST(RangePlannerTest, measured) {
+  RangePlanner planner(1000, 10);
+
+  // More bytes than estimated are taken at once.
+  planner.measured(10, 400);
+  ASSERT_DOUBLE_EQ(40, planner.bytesPerUnit());
+  ASSERT_EQ((uint64_t)5, planner.rangeSize(5, 100));
+
+  // Less bytes only halfway.
+  planner.measured(10, 200);
+  ASSERT_DOUBLE_EQ(30, planner.bytesPerUnit());
+  planner.measured(0, 0);
+  ASSERT_DOUBLE_EQ(30, planner.bytesPerUnit());
+
+  planner.setBudget(3000);
+  ASSERT_EQ((uint64_t)3000, planner.budget());
+  ASSERT_EQ((uint64_t)20, planner.rangeSize(5, 100));
+}
@@ -0,0 +1,66 @@
+// Copyright 2022, Urs Spiegelhalter
+// Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include "correctosmelevation/osm/RoutePathCache.h"
+
+using correctosmelevation::osm::RoutePathCache;
+using RoutePaths = std::vector<std::vector<uint64_t>>;
+
+// ____________________________________________________________________________
+TEST(RoutePathCacheTest, duplicatesAndReversed) {
+  RoutePathCache cache;
+  cache.add({ { 1, 2, 3, 4 } });
+  cache.add({ { 5, 6 } });
+  cache.add({ { 1, 2, 3, 4 } });
+  // The reverse of the first path.
+  cache.add({ { 4, 3, 2, 1 } });
+  // Same nodes, other order.
+  cache.add({ { 1, 3, 2, 4 } });
+  // A closed path and its reverse.
+  cache.add({ { 7, 8, 9, 7 } });
+  cache.add({ { 7, 9, 8, 7 } });
+  ASSERT_EQ((uint64_t)3, cache.duplicates());
+
+  const auto routePaths = cache.getRoutePaths();
+  const auto weights = cache.getWeights();
+  ASSERT_EQ((size_t)4, routePaths.size());
+  ASSERT_EQ((size_t)4, weights.size());
+  // In the order they were first added.
+  ASSERT_EQ(RoutePaths({ { 1, 2, 3, 4 } }), routePaths[0]);
+  ASSERT_EQ(RoutePaths({ { 5, 6 } }), routePaths[1]);
+  ASSERT_EQ(RoutePaths({ { 1, 3, 2, 4 } }), routePaths[2]);
+  ASSERT_EQ(RoutePaths({ { 7, 8, 9, 7 } }), routePaths[3]);
+  ASSERT_EQ((uint16_t)3, weights[0]);
+  ASSERT_EQ((uint16_t)1, weights[1]);
+  ASSERT_EQ((uint16_t)1, weights[2]);
+  ASSERT_EQ((uint16_t)2, weights[3]);
+}
+
+// ____________________________________________________________________________
+TEST(RoutePathCacheTest, severalPaths) {
+  RoutePathCache cache;
+  // Routes of several paths are only the same in the same order.
+  cache.add({ { 1, 2 }, { 3, 4 } });
+  cache.add({ { 1, 2 }, { 3, 4 } });
+  cache.add({ { 3, 4 }, { 1, 2 } });
+  cache.add({ { 2, 1 }, { 4, 3 } });
+  cache.add({ { 1, 2, 3, 4 } });
+  ASSERT_EQ((uint64_t)1, cache.duplicates());
+  const auto weights = cache.getWeights();
+  ASSERT_EQ((std::vector<uint16_t>{ 2, 1, 1, 1 }), weights);
+}
+
+// ____________________________________________________________________________
+TEST(RoutePathCacheTest, weightLimit) {
+  RoutePathCache cache;
+  for (uint64_t i = 0; i < 70000; ++i) {
+    cache.add({ { 1, 2, 3 } });
+  }
+  // A weight holds at most 65535, the rest is kept once more.
+  const auto weights = cache.getWeights();
+  ASSERT_EQ((std::vector<uint16_t>{ 65535, 4465 }), weights);
+  ASSERT_EQ((uint64_t)69998, cache.duplicates());
+}
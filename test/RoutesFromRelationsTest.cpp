@@ -1,15 +1,16 @@
 // Copyright 2022, Urs Spiegelhalter
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
-#include <set>
 #include <vector>
 #include <cstdint>
 #include <gtest/gtest.h>
+#include "util/index/IdBitmap.h"
 #include "parser/NodeWayRelationParser.h"
 #include "util/osm/OsmStats.h"
 #include "util/osm/GetOsmStats.h"
 #include "correctosmelevation/osm/RoutesFromRelations.h"
 
+using util::index::IdBitmap;
 using util::osm::OsmStats;
 using util::osm::GetOsmStats;
 using parser::NodeWayRelationParser;
@@ -26,7 +27,7 @@ TEST(ROUTESFROMRELATIONSTEST, allRoutes) {
   RoutesFromRelations routesFromRelations("./testMap.osm", osmStats,
                                           "ele", 0, 100);
 
-  std::set<uint64_t> correctedWayIds;
+  IdBitmap correctedWayIds;
   std::vector<RoutePaths> routes;
   std::vector<RoutePaths> rivers;
   std::vector<RoutePaths> tunnelsAndBridges;
@@ -370,7 +371,7 @@ TEST(ROUTESFROMRELATIONSTEST, routesRangeSize1Test) {
   RoutesFromRelations routesFromRelations1("./testMap.osm", osmStats,
                                            "ele", 0, 1);
 
-  std::set<uint64_t> correctedWayIds;
+  IdBitmap correctedWayIds;
   std::vector<RoutePaths> routes;
   std::vector<RoutePaths> rivers;
   std::vector<RoutePaths> tunnelsAndBridges;
@@ -520,7 +521,7 @@ TEST(ROUTESFROMRELATIONSTEST, routesRangeSize2Test) {
   RoutesFromRelations routesFromRelations1("./testMap.osm", osmStats,
                                            "ele", 0, 2);
 
-  std::set<uint64_t> correctedWayIds;
+  IdBitmap correctedWayIds;
   std::vector<RoutePaths> routes;
   std::vector<RoutePaths> rivers;
   std::vector<RoutePaths> tunnelsAndBridges;
@@ -626,7 +627,7 @@ TEST(ROUTESFROMRELATIONSTEST, routesRangeSize3Test) {
   RoutesFromRelations routesFromRelations1("./testMap.osm", osmStats,
                                            "ele", 0, 3);
 
-  std::set<uint64_t> correctedWayIds;
+  IdBitmap correctedWayIds;
   std::vector<RoutePaths> routes;
   std::vector<RoutePaths> rivers;
   std::vector<RoutePaths> tunnelsAndBridges;
@@ -703,3 +704,92 @@ TEST(ROUTESFROMRELATIONSTEST, routesRangeSize3Test) {
   ASSERT_EQ((size_t)0, rivers.size());
   ASSERT_EQ((size_t)34, correctedWayIds.size());
 }
+
+// ____________________________________________________________________________
+TEST(ROUTESFROMRELATIONSTEST, routesInRangesTest) {
+  GetOsmStats handler;
+  NodeWayRelationParser statsParser("./testMap.osm", &handler);
+  statsParser.parse();
+  OsmStats osmStats = handler.getOsmStats();
+
+  // All ranges of size 1 at once give the same routes as one range each.
+  RoutesFromRelations routesFromRelations("./testMap.osm", osmStats,
+                                          "ele", 0, osmStats.relationCount);
+  IdBitmap correctedWayIds;
+  auto ranges = routesFromRelations.getRoutesInRanges(correctedWayIds, 1);
+
+  ASSERT_EQ((size_t)6, ranges.size());
+  ASSERT_EQ((size_t)34, correctedWayIds.size());
+
+  // The first route relation contains the route with tunnel.
+  ASSERT_EQ((size_t)1, ranges[0].routePaths.size());
+  ASSERT_EQ((size_t)18, ranges[0].routePaths[0][0].size());
+  ASSERT_EQ((size_t)1, ranges[0].tunnelsAndBridges.size());
+  ASSERT_EQ((size_t)0, ranges[0].rivers.size());
+
+  // The complex and the simple river.
+  ASSERT_EQ((size_t)0, ranges[1].routePaths.size());
+  ASSERT_EQ((size_t)1, ranges[1].rivers.size());
+  ASSERT_EQ((size_t)4, ranges[1].rivers[0].size());
+  ASSERT_EQ((size_t)13, ranges[1].rivers[0][0].size());
+  ASSERT_EQ((size_t)1, ranges[2].rivers.size());
+  ASSERT_EQ((size_t)10, ranges[2].rivers[0][0].size());
+
+  // The complex route.
+  ASSERT_EQ((size_t)4, ranges[3].routePaths.size());
+  ASSERT_EQ((size_t)0, ranges[3].tunnelsAndBridges.size());
+
+  // The route with a tunnel and a bridge.
+  ASSERT_EQ((size_t)1, ranges[4].routePaths.size());
+  ASSERT_EQ((size_t)29, ranges[4].routePaths[0][0].size());
+  ASSERT_EQ((size_t)2, ranges[4].tunnelsAndBridges.size());
+
+  ASSERT_EQ((size_t)1, ranges[5].routePaths.size());
+  ASSERT_EQ((size_t)12, ranges[5].routePaths[0][0].size());
+
+  // Ranges of size 4.
+  correctedWayIds.clear();
+  ranges = routesFromRelations.getRoutesInRanges(correctedWayIds, 4);
+  ASSERT_EQ((size_t)2, ranges.size());
+  ASSERT_EQ((size_t)5, ranges[0].routePaths.size());
+  ASSERT_EQ((size_t)2, ranges[0].rivers.size());
+  ASSERT_EQ((size_t)1, ranges[0].tunnelsAndBridges.size());
+  ASSERT_EQ((size_t)2, ranges[1].routePaths.size());
+  ASSERT_EQ((size_t)2, ranges[1].tunnelsAndBridges.size());
+  ASSERT_EQ((size_t)34, correctedWayIds.size());
+}
+
+// ____________________________________________________________________________
+TEST(ROUTESFROMRELATIONSTEST, routesInRangesOnThreadsTest) {
+  GetOsmStats handler;
+  NodeWayRelationParser statsParser("./testMap.osm", &handler);
+  statsParser.parse();
+  OsmStats osmStats = handler.getOsmStats();
+
+  // The relations processed by the workers give the same routes, in the
+  // same order, as processed one after the other.
+  RoutesFromRelations routesFromRelations("./testMap.osm", osmStats,
+                                          "ele", 0, osmStats.relationCount);
+  IdBitmap correctedWayIds;
+  const auto ranges = routesFromRelations.getRoutesInRanges(correctedWayIds,
+                                                            4);
+  for (const uint16_t threads : { 2, 4, 16 }) {
+    IdBitmap threadsCorrectedWayIds;
+    const auto threadsRanges = routesFromRelations.getRoutesInRanges(
+        threadsCorrectedWayIds, 4, threads);
+    ASSERT_EQ(ranges.size(), threadsRanges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      ASSERT_EQ(ranges[i].routePaths, threadsRanges[i].routePaths);
+      ASSERT_EQ(ranges[i].rivers, threadsRanges[i].rivers);
+      ASSERT_EQ(ranges[i].tunnelsAndBridges,
+                threadsRanges[i].tunnelsAndBridges);
+    }
+    // The ways of the test map have the ids 1 to wayCount.
+    ASSERT_LT((uint64_t)0, correctedWayIds.size());
+    ASSERT_EQ(correctedWayIds.size(), threadsCorrectedWayIds.size());
+    for (uint64_t id = 0; id <= osmStats.wayCount + 1; ++id) {
+      ASSERT_EQ(correctedWayIds.contains(id),
+                threadsCorrectedWayIds.contains(id));
+    }
+  }
+}
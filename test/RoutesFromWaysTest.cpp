@@ -1,15 +1,16 @@
 // Copyright 2022, Urs Spiegelhalter
 // Author: Urs Spiegelhalter <urs.sp99@gmail.com>.
 
-#include <set>
 #include <vector>
 #include <cstdint>
 #include <gtest/gtest.h>
+#include "util/index/IdBitmap.h"
 #include "parser/NodeWayRelationParser.h"
 #include "util/osm/OsmStats.h"
 #include "util/osm/GetOsmStats.h"
 #include "correctosmelevation/osm/RoutesFromWays.h"
 
+using util::index::IdBitmap;
 using util::osm::OsmStats;
 using util::osm::GetOsmStats;
 using parser::NodeWayRelationParser;
@@ -23,41 +24,41 @@ TEST(ROUTESFROMWAYSTEST, allRoutes) {
   OsmStats osmStats = handler.getOsmStats();
 
   // Manually add the ways already contained in routes.
-  std::set<uint64_t> correctedWayIds;
-  correctedWayIds.emplace(1);
-  correctedWayIds.emplace(2);
-  correctedWayIds.emplace(3);
-  correctedWayIds.emplace(4);
-  correctedWayIds.emplace(5);
-  correctedWayIds.emplace(20);
-  correctedWayIds.emplace(21);
-  correctedWayIds.emplace(22);
-  correctedWayIds.emplace(23);
-  correctedWayIds.emplace(24);
-  correctedWayIds.emplace(25);
-  correctedWayIds.emplace(28);
-  correctedWayIds.emplace(29);
-  correctedWayIds.emplace(30);
-  correctedWayIds.emplace(31);
-  correctedWayIds.emplace(32);
-  correctedWayIds.emplace(33);
-  correctedWayIds.emplace(34);
-  correctedWayIds.emplace(35);
-  correctedWayIds.emplace(36);
-  correctedWayIds.emplace(37);
-  correctedWayIds.emplace(38);
-  correctedWayIds.emplace(39);
-  correctedWayIds.emplace(43);
-  correctedWayIds.emplace(44);
-  correctedWayIds.emplace(45);
-  correctedWayIds.emplace(46);
-  correctedWayIds.emplace(47);
-  correctedWayIds.emplace(48);
-  correctedWayIds.emplace(49);
-  correctedWayIds.emplace(50);
-  correctedWayIds.emplace(54);
-  correctedWayIds.emplace(55);
-  correctedWayIds.emplace(56);
+  IdBitmap correctedWayIds;
+  correctedWayIds.insert(1);
+  correctedWayIds.insert(2);
+  correctedWayIds.insert(3);
+  correctedWayIds.insert(4);
+  correctedWayIds.insert(5);
+  correctedWayIds.insert(20);
+  correctedWayIds.insert(21);
+  correctedWayIds.insert(22);
+  correctedWayIds.insert(23);
+  correctedWayIds.insert(24);
+  correctedWayIds.insert(25);
+  correctedWayIds.insert(28);
+  correctedWayIds.insert(29);
+  correctedWayIds.insert(30);
+  correctedWayIds.insert(31);
+  correctedWayIds.insert(32);
+  correctedWayIds.insert(33);
+  correctedWayIds.insert(34);
+  correctedWayIds.insert(35);
+  correctedWayIds.insert(36);
+  correctedWayIds.insert(37);
+  correctedWayIds.insert(38);
+  correctedWayIds.insert(39);
+  correctedWayIds.insert(43);
+  correctedWayIds.insert(44);
+  correctedWayIds.insert(45);
+  correctedWayIds.insert(46);
+  correctedWayIds.insert(47);
+  correctedWayIds.insert(48);
+  correctedWayIds.insert(49);
+  correctedWayIds.insert(50);
+  correctedWayIds.insert(54);
+  correctedWayIds.insert(55);
+  correctedWayIds.insert(56);
 
   RoutesFromWays routesFromWays("./testMap.osm", osmStats, "ele", 0, 100);
   const auto routes = routesFromWays.getRoutesAndExcludeIds(correctedWayIds);
@@ -146,41 +147,41 @@ TEST(ROUTESFROMWAYSTEST, routesRangeTest) {
   OsmStats osmStats = handler.getOsmStats();
 
   // Manually add the ways already contained in routes.
-  std::set<uint64_t> correctedWayIds;
-  correctedWayIds.emplace(1);
-  correctedWayIds.emplace(2);
-  correctedWayIds.emplace(3);
-  correctedWayIds.emplace(4);
-  correctedWayIds.emplace(5);
-  correctedWayIds.emplace(20);
-  correctedWayIds.emplace(21);
-  correctedWayIds.emplace(22);
-  correctedWayIds.emplace(23);
-  correctedWayIds.emplace(24);
-  correctedWayIds.emplace(25);
-  correctedWayIds.emplace(28);
-  correctedWayIds.emplace(29);
-  correctedWayIds.emplace(30);
-  correctedWayIds.emplace(31);
-  correctedWayIds.emplace(32);
-  correctedWayIds.emplace(33);
-  correctedWayIds.emplace(34);
-  correctedWayIds.emplace(35);
-  correctedWayIds.emplace(36);
-  correctedWayIds.emplace(37);
-  correctedWayIds.emplace(38);
-  correctedWayIds.emplace(39);
-  correctedWayIds.emplace(43);
-  correctedWayIds.emplace(44);
-  correctedWayIds.emplace(45);
-  correctedWayIds.emplace(46);
-  correctedWayIds.emplace(47);
-  correctedWayIds.emplace(48);
-  correctedWayIds.emplace(49);
-  correctedWayIds.emplace(50);
-  correctedWayIds.emplace(54);
-  correctedWayIds.emplace(55);
-  correctedWayIds.emplace(56);
+  IdBitmap correctedWayIds;
+  correctedWayIds.insert(1);
+  correctedWayIds.insert(2);
+  correctedWayIds.insert(3);
+  correctedWayIds.insert(4);
+  correctedWayIds.insert(5);
+  correctedWayIds.insert(20);
+  correctedWayIds.insert(21);
+  correctedWayIds.insert(22);
+  correctedWayIds.insert(23);
+  correctedWayIds.insert(24);
+  correctedWayIds.insert(25);
+  correctedWayIds.insert(28);
+  correctedWayIds.insert(29);
+  correctedWayIds.insert(30);
+  correctedWayIds.insert(31);
+  correctedWayIds.insert(32);
+  correctedWayIds.insert(33);
+  correctedWayIds.insert(34);
+  correctedWayIds.insert(35);
+  correctedWayIds.insert(36);
+  correctedWayIds.insert(37);
+  correctedWayIds.insert(38);
+  correctedWayIds.insert(39);
+  correctedWayIds.insert(43);
+  correctedWayIds.insert(44);
+  correctedWayIds.insert(45);
+  correctedWayIds.insert(46);
+  correctedWayIds.insert(47);
+  correctedWayIds.insert(48);
+  correctedWayIds.insert(49);
+  correctedWayIds.insert(50);
+  correctedWayIds.insert(54);
+  correctedWayIds.insert(55);
+  correctedWayIds.insert(56);
 
   // 7 ways should be found in total.
   RoutesFromWays routesFromWays1("./testMap.osm", osmStats, "ele", 0, 10);
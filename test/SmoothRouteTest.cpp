@@ -38,7 +38,9 @@ TEST(SMOOTHROUTETEST, smoothMovingAverageFlat) {
 
   AverageElevationIndexSparse elevationIndex(10, 10);
 
-  SmoothRoute smoothroute(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  SmoothRoute smoothroute(nodeIds, slots, nodeCounts, nodeIndex,
+                          elevationIndex);
 
   smoothroute.buildCoords();
   smoothroute.buildDistances();
@@ -93,7 +95,9 @@ TEST(SMOOTHROUTETEST, smoothMovingAverageSlope) {
 
   AverageElevationIndexSparse elevationIndex(10, 10);
 
-  SmoothRoute smoothroute(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  SmoothRoute smoothroute(nodeIds, slots, nodeCounts, nodeIndex,
+                          elevationIndex);
 
   smoothroute.buildCoords();
   smoothroute.buildElevations();
@@ -148,7 +152,9 @@ TEST(SMOOTHROUTETEST, smoothMovingAverageSlopeDownwards) {
 
   AverageElevationIndexSparse elevationIndex(10, 10);
 
-  SmoothRoute smoothroute(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  SmoothRoute smoothroute(nodeIds, slots, nodeCounts, nodeIndex,
+                          elevationIndex);
 
   smoothroute.buildCoords();
   smoothroute.buildElevations();
@@ -192,7 +198,9 @@ TEST(SMOOTHROUTETEST, smoothMovingAverageSlopeWithError) {
 
   AverageElevationIndexSparse elevationIndex(10, 10);
 
-  SmoothRoute smoothroute(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  SmoothRoute smoothroute(nodeIds, slots, nodeCounts, nodeIndex,
+                          elevationIndex);
 
   smoothroute.buildCoords();
   smoothroute.buildElevations();
@@ -236,7 +244,9 @@ TEST(SMOOTHROUTETEST, smoothMovingAverageSlopeDifferentDistances) {
 
   AverageElevationIndexSparse elevationIndex(10, 10);
 
-  SmoothRoute smoothroute(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  SmoothRoute smoothroute(nodeIds, slots, nodeCounts, nodeIndex,
+                          elevationIndex);
 
   smoothroute.buildCoords();
   smoothroute.buildElevations();
@@ -280,7 +290,9 @@ TEST(SMOOTHROUTETEST, smoothMovingAverageSlopeDownwardsInvalidElev) {
 
   AverageElevationIndexSparse elevationIndex(10, 10);
 
-  SmoothRoute smoothroute(nodeIds, nodeCounts, nodeIndex, elevationIndex);
+  const auto slots = nodeIndex.resolve(nodeIds);
+  SmoothRoute smoothroute(nodeIds, slots, nodeCounts, nodeIndex,
+                          elevationIndex);
 
   smoothroute.buildCoords();
   smoothroute.buildElevations();
@@ -18,10 +18,14 @@ using util::geo::haversineApprox;
 using util::geo::haversine;
 using util::console::parseCommandLineArgumentsAdd;
 using util::console::parseCommandLineArgumentsCorrect;
+using util::console::parseByteSize;
 using util::geo::Point;
 using util::geometry::Vector3d;
 using util::osm::OsmStats;
+using util::osm::tileIndex;
 using util::osm::GetOsmStats;
+using osmelevation::elevation::Interpolation;
+using sidecar::OutputFormat;
 
 // ____________________________________________________________________________
 TEST(UTILTESTS, haversine) {
@@ -101,6 +105,207 @@ TEST(UTILTESTS, parseCommandLineArgumentsAddSetEleTag) {
   ASSERT_STREQ("elev", args1.elevationTag.c_str());
 }
 
+// ____________________________________________________________________________
+TEST(UTILTESTS, parseCommandLineArgumentsAddSetInterpolation) {
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  const auto args = parseCommandLineArgumentsAdd(argc, argv);
+  ASSERT_EQ(Interpolation::IDW, args.interpolation);
+
+  int argc1 = 6;
+  char* argv1[6] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--interpolation"),
+    const_cast<char*>("bilinear"),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  const auto args1 = parseCommandLineArgumentsAdd(argc1, argv1);
+  ASSERT_EQ(Interpolation::BILINEAR, args1.interpolation);
+  ASSERT_STREQ("nasadem", args1.nasademDir.c_str());
+
+  int argc2 = 6;
+  char* argv2[6] = {
+    const_cast<char*>(""),
+    const_cast<char*>("-i"),
+    const_cast<char*>("nearest"),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  const auto args2 = parseCommandLineArgumentsAdd(argc2, argv2);
+  ASSERT_EQ(Interpolation::NEAREST, args2.interpolation);
+
+  int argc3 = 6;
+  char* argv3[6] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--interpolation"),
+    const_cast<char*>("cubic"),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_DEATH(parseCommandLineArgumentsAdd(argc3, argv3), "Usage: .*");
+}
+
+// ____________________________________________________________________________
+TEST(UTILTESTS, parseCommandLineArgumentsAddSetThreads) {
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  const auto args = parseCommandLineArgumentsAdd(argc, argv);
+  ASSERT_EQ(1, args.threads);
+
+  int argc1 = 6;
+  char* argv1[6] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--threads"),
+    const_cast<char*>("4"),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  const auto args1 = parseCommandLineArgumentsAdd(argc1, argv1);
+  ASSERT_EQ(4, args1.threads);
+
+  int argc2 = 6;
+  char* argv2[6] = {
+    const_cast<char*>(""),
+    const_cast<char*>("-j"),
+    const_cast<char*>("0"),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_DEATH(parseCommandLineArgumentsAdd(argc2, argv2), "Usage: .*");
+}
+
+// ____________________________________________________________________________
+TEST(UTILTESTS, parseCommandLineArgumentsAddSetFormat) {
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  const auto args = parseCommandLineArgumentsAdd(argc, argv);
+  ASSERT_EQ(OutputFormat::OSM, args.format);
+
+  int argc1 = 6;
+  char* argv1[6] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--format"),
+    const_cast<char*>("binary"),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  const auto args1 = parseCommandLineArgumentsAdd(argc1, argv1);
+  ASSERT_EQ(OutputFormat::BINARY, args1.format);
+
+  int argc2 = 6;
+  char* argv2[6] = {
+    const_cast<char*>(""),
+    const_cast<char*>("-f"),
+    const_cast<char*>("csv"),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  const auto args2 = parseCommandLineArgumentsAdd(argc2, argv2);
+  ASSERT_EQ(OutputFormat::CSV, args2.format);
+
+  argv2[2] = const_cast<char*>("osc");
+  const auto args4 = parseCommandLineArgumentsAdd(argc2, argv2);
+  ASSERT_EQ(OutputFormat::OSC, args4.format);
+
+  int argc3 = 6;
+  char* argv3[6] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--format"),
+    const_cast<char*>("xml"),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_DEATH(parseCommandLineArgumentsAdd(argc3, argv3), "Usage: .*");
+}
+
+// ____________________________________________________________________________
+TEST(UTILTESTS, parseCommandLineArgumentsAddSetUpdate) {
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input.osc"),
+    const_cast<char*>("output.osc")
+  };
+  const auto args = parseCommandLineArgumentsAdd(argc, argv);
+  ASSERT_FALSE(args.update);
+
+  int argc1 = 5;
+  char* argv1[5] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--update"),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input.osc"),
+    const_cast<char*>("output.osc")
+  };
+  const auto args1 = parseCommandLineArgumentsAdd(argc1, argv1);
+  ASSERT_TRUE(args1.update);
+  ASSERT_EQ("input.osc", args1.inputFile);
+  ASSERT_EQ("output.osc", args1.outputFile);
+}
+
+// ____________________________________________________________________________
+TEST(UTILTESTS, parseCommandLineArgumentsSetMetricsOut) {
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ASSERT_EQ("", parseCommandLineArgumentsAdd(argc, argv).metricsOut);
+
+  int argc1 = 6;
+  char* argv1[6] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--metrics-out"),
+    const_cast<char*>("metrics.json"),
+    const_cast<char*>("nasadem"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ASSERT_EQ("metrics.json",
+            parseCommandLineArgumentsAdd(argc1, argv1).metricsOut);
+
+  int argc2 = 5;
+  char* argv2[5] = {
+    const_cast<char*>(""),
+    const_cast<char*>("-m"),
+    const_cast<char*>("metrics.json"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ASSERT_EQ("metrics.json",
+            parseCommandLineArgumentsCorrect(argc2, argv2).metricsOut);
+}
+
 // ____________________________________________________________________________
 TEST(UTILTESTS, parseCommandLineArgumentsCorrectNoArguments) {
   int argc = 1;
@@ -260,3 +465,116 @@ TEST(UTILTESTS, GetOsmStats) {
   ASSERT_EQ((uint64_t)1, osmStats.min);
   ASSERT_EQ((uint64_t)181, osmStats.max);
 }
+
+// ____________________________________________________________________________
+TEST(UTILTESTS, GetOsmStatsChangeFile) {
+  // Deleted nodes have no location and are not counted.
+  GetOsmStats handler;
+  NodeWayRelationParser statsParser("./testChange.osc", &handler);
+  statsParser.parse();
+  OsmStats osmStats = handler.getOsmStats();
+
+  ASSERT_EQ((int16_t)7, osmStats.minLon);
+  ASSERT_EQ((int16_t)47, osmStats.minLat);
+  ASSERT_EQ((int16_t)9, osmStats.maxLon);
+  ASSERT_EQ((int16_t)48, osmStats.maxLat);
+  ASSERT_EQ((uint64_t)3, osmStats.nodeCount);
+  ASSERT_EQ((uint64_t)1, osmStats.wayCount);
+  ASSERT_EQ((uint64_t)1, osmStats.min);
+  ASSERT_EQ((uint64_t)201, osmStats.max);
+  ASSERT_EQ((uint64_t)2, osmStats.tileNodeCounts[tileIndex(7, 47)]);
+  ASSERT_EQ((uint64_t)1, osmStats.tileNodeCounts[tileIndex(8, 47)]);
+}
+
+// ____________________________________________________________________________
+TEST(UTILTESTS, parseCommandLineArgumentsCorrectSetThreads) {
+  int argc = 3;
+  char* argv[3] = {
+    const_cast<char*>(""),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ASSERT_EQ(1, parseCommandLineArgumentsCorrect(argc, argv).threads);
+
+  int argc1 = 5;
+  char* argv1[5] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--threads"),
+    const_cast<char*>("8"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ASSERT_EQ(8, parseCommandLineArgumentsCorrect(argc1, argv1).threads);
+
+  int argc2 = 5;
+  char* argv2[5] = {
+    const_cast<char*>(""),
+    const_cast<char*>("-j"),
+    const_cast<char*>("0"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_DEATH(parseCommandLineArgumentsCorrect(argc2, argv2), "Usage: .*");
+}
+
+// ____________________________________________________________________________
+TEST(UTILTESTS, parseCommandLineArgumentsCorrectSetMemoryLimit) {
+  int argc = 3;
+  char* argv[3] = {
+    const_cast<char*>(""),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ASSERT_EQ((uint64_t)0,
+            parseCommandLineArgumentsCorrect(argc, argv).memoryLimit);
+
+  int argc1 = 5;
+  char* argv1[5] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--memory-limit"),
+    const_cast<char*>("8G"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ASSERT_EQ((uint64_t)8589934592,
+            parseCommandLineArgumentsCorrect(argc1, argv1).memoryLimit);
+
+  ASSERT_EQ((uint64_t)1000, parseByteSize("1000"));
+  ASSERT_EQ((uint64_t)1536, parseByteSize("1.5K"));
+  ASSERT_EQ((uint64_t)536870912, parseByteSize("512m"));
+  ASSERT_EQ((uint64_t)0, parseByteSize("8GB"));
+  ASSERT_EQ((uint64_t)0, parseByteSize("-1G"));
+  ASSERT_EQ((uint64_t)0, parseByteSize("G"));
+
+  int argc2 = 5;
+  char* argv2[5] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--memory-limit"),
+    const_cast<char*>("lots"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_DEATH(parseCommandLineArgumentsCorrect(argc2, argv2), "Usage: .*");
+}
+
+// ____________________________________________________________________________
+TEST(UTILTESTS, parseCommandLineArgumentsCorrectResume) {
+  int argc = 3;
+  char* argv[3] = {
+    const_cast<char*>(""),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ASSERT_FALSE(parseCommandLineArgumentsCorrect(argc, argv).resume);
+
+  int argc1 = 4;
+  char* argv1[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--resume"),
+    const_cast<char*>("input"),
+    const_cast<char*>("output")
+  };
+  ASSERT_TRUE(parseCommandLineArgumentsCorrect(argc1, argv1).resume);
+}